@@ -0,0 +1,296 @@
+// ability.cpp - Apache and Bomber strikes
+#include "game_types.h"
+#include <stddef.h>
+
+// ============================================================================
+// ABILITY STATS TABLE (gam4 AbilityManager.ABILITY_TYPES plus the strikes)
+// ============================================================================
+
+const AbilityStats ABILITY_STATS_TABLE[ABILITY_COUNT] = {
+    // ABILITY_APACHE
+    {
+        .name = "Apache Strike",
+        .cost = 50,
+        .cooldown = 15.0f,
+        .speed = 8.0f,
+        .start_y = 5.0f,
+        .interval = 0.3f,
+        .damage = 2,
+        .range = 20.0f
+    },
+    // ABILITY_BOMBER
+    {
+        .name = "Bomber Run",
+        .cost = 75,
+        .cooldown = 20.0f,
+        .speed = 12.0f,
+        .start_y = 8.0f,
+        .interval = 0.8f,
+        .damage = 4,
+        .range = 4.0f
+    }
+};
+
+#define AIRCRAFT_START_X (MATRIX_WIDTH + 5)
+#define APACHE_EXIT_X -5.0f
+#define BOMBER_EXIT_X -10.0f
+#define APACHE_BULLET_SPEED 60.0f
+#define BOMB_FALL_SPEED 15.0f
+#define BOMB_EXPLOSION_TIME 0.15f
+
+// ============================================================================
+// ACTIVATION
+// ============================================================================
+
+bool game_can_activate(const GameState* game, AbilityType type) {
+    return game->money >= ABILITY_STATS_TABLE[type].cost &&
+           game->game_time >= game->abilities.ready_at[type];
+}
+
+// Seconds until the ability is ready, 0 if it is
+float game_ability_cooldown(const GameState* game, AbilityType type) {
+    float remaining = game->abilities.ready_at[type] - game->game_time;
+    return remaining > 0.0f ? remaining : 0.0f;
+}
+
+bool game_activate_ability(GameState* game, AbilityType type) {
+    if (!game_can_activate(game, type)) return false;
+
+    Aircraft* aircraft = NULL;
+    for (int i = 0; i < MAX_AIRCRAFT && !aircraft; i++) {
+        if (!game->abilities.aircraft[i].active) aircraft = &game->abilities.aircraft[i];
+    }
+    if (!aircraft) return false;
+
+    const AbilityStats* stats = &ABILITY_STATS_TABLE[type];
+    aircraft->type = type;
+    aircraft->x = (float)AIRCRAFT_START_X;
+    aircraft->y = stats->start_y;
+    aircraft->spawn_time = game->game_time;
+    aircraft->next_action = game->game_time + stats->interval;
+    aircraft->active = true;
+
+    game->money -= stats->cost;
+    game->abilities.ready_at[type] = game->game_time + stats->cooldown;
+    return true;
+}
+
+// ============================================================================
+// STRIKES
+// ============================================================================
+
+// Height of the path under column x, bombs explode just below it
+static float path_y_at(const GameState* game, float x) {
+    for (int i = 0; i + 1 < game->path_length; i++) {
+        MapPoint a = game->path[i];
+        MapPoint b = game->path[i + 1];
+        if (a.y != b.y) continue;
+
+        int16_t lo = a.x < b.x ? a.x : b.x;
+        int16_t hi = a.x < b.x ? b.x : a.x;
+        if (x >= lo && x <= hi) return (float)a.y;
+    }
+    return MATRIX_HEIGHT / 2.0f;
+}
+
+static void apache_update(GameState* game, Aircraft* apache, const AbilityStats* stats) {
+    if (game->game_time < apache->next_action) return;
+
+    // Nearest enemy in range, from the cells around the helicopter only
+    uint8_t candidates[MAX_ENEMIES];
+    uint8_t count = game_enemies_in_radius(game, apache->x, apache->y, stats->range,
+                                           candidates, MAX_ENEMIES);
+    int target = -1;
+    float best = 0.0f;
+    for (int i = 0; i < count; i++) {
+        const Enemy* e = &game->enemies[candidates[i]];
+        float d = distance_squared(apache->x, apache->y, e->x, e->y);
+        if (target < 0 || d < best) {
+            target = candidates[i];
+            best = d;
+        }
+    }
+
+    // No target keeps the gun ready, like gam4
+    if (target < 0 || game->projectile_count >= MAX_PROJECTILES) return;
+
+    projectile_init(&game->projectiles[game->projectile_count++],
+                    apache->x, apache->y + 2, (uint8_t)target,
+                    stats->damage, APACHE_BULLET_SPEED, Color{255, 255, 0}, 0);
+    apache->next_action = game->game_time + stats->interval;
+}
+
+static void bomber_update(GameState* game, Aircraft* bomber, const AbilityStats* stats) {
+    if (game->game_time < bomber->next_action) return;
+    bomber->next_action += stats->interval;
+
+    Bomb* bomb = NULL;
+    for (int i = 0; i < MAX_BOMBS && !bomb; i++) {
+        if (!game->abilities.bombs[i].active) bomb = &game->abilities.bombs[i];
+    }
+    if (!bomb) {
+        game->abilities.bombs_dropped++;
+        return;
+    }
+
+    bomb->x = bomber->x;
+    bomb->y = bomber->y + 3;
+    bomb->target_y = path_y_at(game, bomber->x) + 2;
+    bomb->damage = stats->damage;
+    bomb->splash_radius = (uint8_t)stats->range;
+    bomb->exploded = false;
+    bomb->active = true;
+}
+
+// One radius query per explosion instead of a pass over every enemy
+static void bomb_explode(GameState* game, Bomb* bomb) {
+    particles_emit(&game->particles, PARTICLE_EXPLOSION, bomb->x, bomb->y,
+                   0, 0, 0, bomb->splash_radius * 0.5f);
+
+    uint8_t hits[MAX_ENEMIES];
+    uint8_t count = game_enemies_in_radius(game, bomb->x, bomb->y, bomb->splash_radius,
+                                           hits, MAX_ENEMIES);
+    for (int i = 0; i < count; i++) {
+        Enemy* e = &game->enemies[hits[i]];
+        e->health -= bomb->damage;
+        if (e->health <= 0) game_kill_enemy(game, e);
+    }
+
+    bomb->exploded = true;
+    bomb->expire_time = game->game_time + BOMB_EXPLOSION_TIME;
+}
+
+static void bomb_update(GameState* game, Bomb* bomb, float dt) {
+    if (bomb->exploded) {
+        if (game->game_time >= bomb->expire_time) bomb->active = false;
+        return;
+    }
+
+    bomb->y += BOMB_FALL_SPEED * dt;
+    if (bomb->y >= bomb->target_y) bomb_explode(game, bomb);
+}
+
+// Needs the enemy index built this tick, see game_update()
+void abilities_update(GameState* game, float dt) {
+    AbilityState* abilities = &game->abilities;
+
+    for (int i = 0; i < MAX_AIRCRAFT; i++) {
+        Aircraft* aircraft = &abilities->aircraft[i];
+        if (!aircraft->active) continue;
+
+        const AbilityStats* stats = &ABILITY_STATS_TABLE[aircraft->type];
+        aircraft->x -= stats->speed * dt;
+
+        if (aircraft->type == ABILITY_APACHE) {
+            if (aircraft->x < APACHE_EXIT_X) aircraft->active = false;
+            else apache_update(game, aircraft, stats);
+        } else {
+            if (aircraft->x < BOMBER_EXIT_X) aircraft->active = false;
+            else bomber_update(game, aircraft, stats);
+        }
+    }
+
+    for (int i = 0; i < MAX_BOMBS; i++) {
+        if (abilities->bombs[i].active) bomb_update(game, &abilities->bombs[i], dt);
+    }
+}
+
+// ============================================================================
+// DRAWING (top-down, flying left, same shapes as gam4)
+// ============================================================================
+
+
+static void apache_draw(const Aircraft* apache, float game_time, DisplayList* list) {
+    const Color body = {50, 150, 50};
+    const Color tail = {40, 120, 40};
+    const Color blade = {120, 120, 120};
+    int x = (int)apache->x;
+    int y = (int)apache->y;
+    float t = game_time - apache->spawn_time;
+
+    dl_rect(list, x - 1, y - 1, 3, 3, body);
+    dl_rect(list, x + 2, y, 2, 1, tail);
+    dl_pixel(list, x + 3, y - 1, tail);
+    dl_pixel(list, x + 3, y + 1, tail);
+
+    // Tail rotor, 2 phases
+    if ((int)(t * 15) % 2 == 0) {
+        dl_pixel(list, x + 4, y, blade);
+    } else {
+        dl_pixel(list, x + 4, y - 1, blade);
+        dl_pixel(list, x + 4, y + 1, blade);
+    }
+
+    // Main rotor, 4 phases: horizontal, diagonal, vertical, diagonal
+    switch ((int)(t * 12) % 4) {
+        case 0:
+            dl_pixel(list, x - 3, y, blade); dl_pixel(list, x - 2, y, blade);
+            dl_pixel(list, x + 2, y, blade); dl_pixel(list, x + 3, y, blade);
+            break;
+        case 1:
+            dl_pixel(list, x - 2, y - 2, blade); dl_pixel(list, x - 1, y - 1, blade);
+            dl_pixel(list, x + 1, y + 1, blade); dl_pixel(list, x + 2, y + 2, blade);
+            break;
+        case 2:
+            dl_pixel(list, x, y - 3, blade); dl_pixel(list, x, y - 2, blade);
+            dl_pixel(list, x, y + 2, blade); dl_pixel(list, x, y + 3, blade);
+            break;
+        default:
+            dl_pixel(list, x + 2, y - 2, blade); dl_pixel(list, x + 1, y - 1, blade);
+            dl_pixel(list, x - 1, y + 1, blade); dl_pixel(list, x - 2, y + 2, blade);
+            break;
+    }
+
+    dl_pixel(list, x, y, Color{90, 90, 90});
+}
+
+static void bomber_draw(const Aircraft* bomber, DisplayList* list) {
+    const Color body = {120, 120, 120};
+    const Color wing = {100, 100, 100};
+    const Color engine = {40, 40, 40};
+    const Color glow = {255, 100, 0};
+    const Color nose = {180, 180, 180};
+    int x = (int)bomber->x;
+    int y = (int)bomber->y;
+
+    dl_rect(list, x, y - 5, 2, 10, wing);
+    dl_rect(list, x + 1, y - 5, 1, 10, body);
+
+    dl_rect(list, x + 1, y - 4, 1, 2, engine);
+    dl_pixel(list, x + 2, y - 3, glow);
+    dl_rect(list, x + 1, y + 2, 1, 2, engine);
+    dl_pixel(list, x + 2, y + 3, glow);
+
+    dl_rect(list, x - 2, y - 1, 6, 2, body);
+    dl_rect(list, x - 3, y - 1, 2, 2, nose);
+    dl_pixel(list, x - 4, y, nose);
+    dl_rect(list, x + 4, y - 2, 1, 4, wing);
+}
+
+static void bomb_draw(const Bomb* bomb, DisplayList* list) {
+    int x = (int)bomb->x;
+    int y = (int)bomb->y;
+
+    if (!bomb->exploded) {
+        dl_rect(list, x, y, 2, 2, Color{255, 200, 0});
+        return;
+    }
+
+    int size = bomb->splash_radius * 3 / 2;
+    dl_rect(list, x - size / 2, y - size / 2, size, size, Color{255, 100, 0});
+    dl_rect(list, x - 1, y - 1, 2, 2, Color{255, 255, 0});
+}
+
+void abilities_draw(const AbilityState* abilities, float game_time, DisplayList* list) {
+    for (int i = 0; i < MAX_BOMBS; i++) {
+        if (abilities->bombs[i].active) bomb_draw(&abilities->bombs[i], list);
+    }
+
+    for (int i = 0; i < MAX_AIRCRAFT; i++) {
+        const Aircraft* aircraft = &abilities->aircraft[i];
+        if (!aircraft->active) continue;
+
+        if (aircraft->type == ABILITY_APACHE) apache_draw(aircraft, game_time, list);
+        else bomber_draw(aircraft, list);
+    }
+}
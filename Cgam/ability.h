@@ -0,0 +1,57 @@
+// ability.h - Apache and Bomber strikes (port of gam4/ability.py)
+#ifndef ABILITY_H
+#define ABILITY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define MAX_AIRCRAFT 4
+#define MAX_BOMBS 16
+
+typedef enum {
+    ABILITY_APACHE,
+    ABILITY_BOMBER,
+    ABILITY_COUNT
+} AbilityType;
+
+typedef struct {
+    const char* name;
+    uint16_t cost;
+    float cooldown;          // Seconds
+    float speed;             // Pixels per second, flying left
+    float start_y;
+    float interval;          // Seconds between shots or drops
+    uint8_t damage;
+    float range;             // Apache: target range, Bomber: splash radius
+} AbilityStats;
+
+typedef struct {
+    AbilityType type;
+    float x, y;
+    float spawn_time;        // For the rotor animation
+    float next_action;       // Game time of the next shot or drop
+    bool active;
+} Aircraft;
+
+typedef struct {
+    float x, y;
+    float target_y;          // Explodes on reaching this (path level + 2)
+    float expire_time;       // Game time the explosion ends
+    uint8_t damage;
+    uint8_t splash_radius;
+    bool exploded;
+    bool active;
+} Bomb;
+
+// Fixed pools, nothing is allocated while a strike runs. Cooldowns are
+// the game time each ability is ready again, so nothing ticks them down
+typedef struct {
+    Aircraft aircraft[MAX_AIRCRAFT];
+    Bomb bombs[MAX_BOMBS];
+    float ready_at[ABILITY_COUNT];
+    uint16_t bombs_dropped;  // Drops lost to a full bomb pool
+} AbilityState;
+
+extern const AbilityStats ABILITY_STATS_TABLE[ABILITY_COUNT];
+
+#endif // ABILITY_H
@@ -0,0 +1,176 @@
+// banner.cpp - Wave banner: render once into a 1bpp strip, blit per frame
+#include "game_types.h"
+#include "../lib/font/font.hh"
+#include <math.h>
+#include <stdlib.h>
+
+#define BANNER_START_X 70.0f
+#define BANNER_START_Y 16.0f
+#define BANNER_SPEED 15.0f
+#define BANNER_TEXT_START 8      // Blank cloth before the text
+#define BANNER_TEXT_END 4        // and after it
+
+// ============================================================================
+// STRIP RENDERING (once per banner)
+// ============================================================================
+
+// The 5x7 panel font, one blank column between glyphs
+static void render_strip(Banner* banner, const char* text, int text_length) {
+    const Font* font = &font_large;
+    const int advance = font->width + 1;
+
+    int length = BANNER_TEXT_START + text_length * advance + BANNER_TEXT_END;
+    if (length > BANNER_MAX_LENGTH) length = BANNER_MAX_LENGTH;
+    banner->length = (uint8_t)length;
+
+    // Glyph rows sit in the middle of the cloth
+    const int shift = (BANNER_HEIGHT - font->height) / 2;
+
+    for (int i = 0; i < length; i++) {
+        banner->columns[i] = 0;
+
+        int pos = i - BANNER_TEXT_START;
+        if (pos < 0) continue;
+
+        int index = pos / advance;
+        int col = pos % advance;
+        if (index >= text_length || col >= font->width) continue;
+
+        banner->columns[i] = (uint16_t)(font_glyph(font, text[index])[col] << shift);
+    }
+}
+
+void banner_start_wave(Banner* banner, uint8_t wave, float game_time) {
+    char text[8] = {'W', 'A', 'V', 'E', ' '};
+    int length = 5;
+
+    // Up to three digits, most significant first
+    char digits[3];
+    int count = 0;
+    do {
+        digits[count++] = (char)('0' + wave % 10);
+        wave /= 10;
+    } while (wave > 0);
+    while (count > 0) text[length++] = digits[--count];
+
+    render_strip(banner, text, length);
+    banner->x = BANNER_START_X;
+    banner->y = BANNER_START_Y;
+    banner->start_time = game_time;
+    banner->active = true;
+}
+
+bool banner_update(Banner* banner, float dt) {
+    if (!banner->active) return false;
+
+    banner->x -= BANNER_SPEED * dt;
+
+    // Tail, rope and strip all past the left edge
+    if (banner->x + 3 + BANNER_ROPE_LENGTH + banner->length < 0.0f) {
+        banner->active = false;
+        return true;
+    }
+    return false;
+}
+
+// ============================================================================
+// DRAWING (every frame)
+// ============================================================================
+
+// Cloth ripple, (int)(sin * 2) over one period in 64 steps like gam4
+static int8_t ripple[64];
+static bool ripple_ready = false;
+
+static void plot_line(int x1, int y1, int x2, int y2, Color color, DisplayList* list) {
+    int dx = abs(x2 - x1), dy = abs(y2 - y1);
+    int sx = x1 < x2 ? 1 : -1;
+    int sy = y1 < y2 ? 1 : -1;
+    int err = dx - dy;
+
+    for (;;) {
+        dl_pixel(list, x1, y1, color);
+        if (x1 == x2 && y1 == y2) break;
+        int e2 = 2 * err;
+        if (e2 > -dy) { err -= dy; x1 += sx; }
+        if (e2 < dx) { err += dx; y1 += sy; }
+    }
+}
+
+static void plane_draw(int x, int y, float t, DisplayList* list) {
+    const Color body = {200, 20, 20};
+    const Color wing = {180, 20, 20};
+    const Color prop = {150, 150, 150};
+
+    for (int dx = -2; dx <= 2; dx++) {
+        dl_pixel(list, x + dx, y - 1, body);
+        dl_pixel(list, x + dx, y, body);
+    }
+    dl_pixel(list, x - 3, y, body);
+    dl_pixel(list, x - 4, y, Color{220, 40, 40});
+
+    // Cockpit
+    dl_pixel(list, x - 2, y - 1, Color{120, 10, 10}); dl_pixel(list, x - 1, y - 1, Color{120, 10, 10});
+    dl_pixel(list, x - 2, y, Color{120, 10, 10}); dl_pixel(list, x - 1, y, Color{120, 10, 10});
+
+    // Wings above and below, tail fin at the back
+    for (int dy = 2; dy <= 3; dy++) {
+        dl_pixel(list, x - 1, y - dy, wing); dl_pixel(list, x, y - dy, wing);
+        dl_pixel(list, x - 1, y + dy, wing); dl_pixel(list, x, y + dy, wing);
+    }
+    dl_pixel(list, x + 3, y - 1, wing); dl_pixel(list, x + 3, y, wing);
+    dl_pixel(list, x + 4, y, wing);
+
+    // Propeller, horizontal one phase in four
+    if ((int)(t * 20) % 4 == 2) {
+        dl_pixel(list, x - 4, y, prop);
+        dl_pixel(list, x - 6, y, prop);
+    } else {
+        dl_pixel(list, x - 5, y - 1, prop);
+        dl_pixel(list, x - 5, y + 1, prop);
+    }
+    dl_pixel(list, x - 5, y, Color{100, 100, 100});
+}
+
+void banner_draw(const Banner* banner, float game_time, DisplayList* list) {
+    if (!banner->active) return;
+
+    if (!ripple_ready) {
+        for (int i = 0; i < 64; i++) ripple[i] = (int8_t)(sinf(i * 6.2831853f / 64.0f) * 2.0f);
+        ripple_ready = true;
+    }
+
+    const Color cloth = {220, 220, 180};
+    const Color text = {200, 0, 0};
+    float t = game_time - banner->start_time;
+    int x = (int)banner->x;
+    int y = (int)banner->y;
+    int start = x + 3 + BANNER_ROPE_LENGTH;
+
+    // Ripple phase in 1/256 steps of the 64 entry table: t * 3 rad/s,
+    // plus 0.3 rad per column
+    uint32_t phase = (uint32_t)(t * 3.0f * (64.0f / 6.2831853f) * 256.0f);
+    const uint32_t step = (uint32_t)(0.3f * (64.0f / 6.2831853f) * 256.0f);
+
+    // Ropes to the first column's corners
+    int attach = y + ripple[(phase >> 8) & 63];
+    plot_line(x + 3, y, start, attach - BANNER_HEIGHT / 2, Color{100, 80, 60}, list);
+    plot_line(x + 3, y, start, attach + BANNER_HEIGHT / 2, Color{100, 80, 60}, list);
+
+    // Only the on-screen part of the strip
+    int first = start < 0 ? -start : 0;
+    int last = MATRIX_WIDTH - start;
+    if (last > banner->length) last = banner->length;
+
+    // All the cloth, then all the text, so neighbouring cloth columns
+    // at the same height merge into one rect
+    for (int i = first; i < last; i++) {
+        int top = y - BANNER_HEIGHT / 2 + ripple[((phase + i * step) >> 8) & 63];
+        dl_rect(list, start + i, top, 1, BANNER_HEIGHT, cloth);
+    }
+    for (int i = first; i < last; i++) {
+        int top = y - BANNER_HEIGHT / 2 + ripple[((phase + i * step) >> 8) & 63];
+        dl_bits(list, start + i, top, banner->columns[i], text);
+    }
+
+    plane_draw(x, y, t, list);
+}
@@ -0,0 +1,33 @@
+// banner.h - Banner plane announcing each wave (port of gam4/banner_plane.py)
+#ifndef BANNER_H
+#define BANNER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "display_list.h"
+
+#define BANNER_HEIGHT 13         // Cloth height, odd so the text centers
+#define BANNER_MAX_LENGTH 96     // Longest strip in columns
+#define BANNER_ROPE_LENGTH 8
+
+// The message is rendered once into a 1 bit per pixel strip when the
+// banner starts. Column i is columns[i], bit y set means text at row y
+// of the cloth. Drawing only walks the strip columns that are on screen
+// (at most the matrix width), so long messages cost no more per frame
+typedef struct {
+    uint16_t columns[BANNER_MAX_LENGTH];
+    uint8_t length;
+    float x, y;              // Plane center, the strip trails to the right
+    float start_time;        // For the propeller and cloth animation
+    bool active;
+} Banner;
+
+// Render "WAVE <wave>" into the strip and send the plane off
+void banner_start_wave(Banner* banner, uint8_t wave, float game_time);
+
+// Move the plane. Returns true on the tick the whole banner has left
+bool banner_update(Banner* banner, float dt);
+
+void banner_draw(const Banner* banner, float game_time, DisplayList* list);
+
+#endif // BANNER_H
@@ -0,0 +1,269 @@
+// display_list.cpp - Recorded draw commands, executed into the framebuffer
+#include "display_list.h"
+#include "../lib/matrix/matrix.h"
+#include <string.h>
+
+static_assert(sizeof(DrawCommand) == DL_COMMAND_SIZE, "DrawCommand must stay 8 bytes");
+static_assert(MATRIX_COLS <= 64, "coverage rows are one uint64_t");
+
+// ============================================================================
+// RECORDING
+// ============================================================================
+
+static DrawCommand* dl_push(DisplayList* list, DrawOp op, int x, int y, Color color) {
+    if (list->count >= MAX_DRAW_COMMANDS) {
+        list->stats.dropped++;
+        return NULL;
+    }
+
+    DrawCommand* cmd = &list->commands[list->count++];
+    cmd->op = op;
+    cmd->x = (uint8_t)x;
+    cmd->y = (uint8_t)y;
+    cmd->color = color;
+    cmd->bits = 0;
+    return cmd;
+}
+
+static bool same_color(Color a, Color b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b;
+}
+
+void dl_begin(DisplayList* list) {
+    list->count = 0;
+    memset(&list->stats, 0, sizeof(DisplayListStats));
+}
+
+void dl_clear(DisplayList* list, Color color) {
+    dl_push(list, DL_CLEAR, 0, 0, color);
+}
+
+void dl_pixel(DisplayList* list, int x, int y, Color color) {
+    dl_rect(list, x, y, 1, 1, color);
+}
+
+void dl_rect(DisplayList* list, int x, int y, int w, int h, Color color) {
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > MATRIX_COLS) w = MATRIX_COLS - x;
+    if (y + h > MATRIX_ROWS) h = MATRIX_ROWS - y;
+    if (w <= 0 || h <= 0) return;
+
+    // Extend the previous rect when this one continues its row or column,
+    // so plotted lines and shapes collapse into spans
+    if (list->count > 0) {
+        DrawCommand* last = &list->commands[list->count - 1];
+        if (last->op == DL_RECT && same_color(last->color, color)) {
+            if (last->y == y && last->size.h == h && last->x + last->size.w == x) {
+                last->size.w += w;
+                list->stats.merged++;
+                return;
+            }
+            if (last->x == x && last->size.w == w && last->y + last->size.h == y) {
+                last->size.h += h;
+                list->stats.merged++;
+                return;
+            }
+        }
+    }
+
+    DrawCommand* cmd = dl_push(list, DL_RECT, x, y, color);
+    if (!cmd) return;
+    cmd->size.w = (uint8_t)w;
+    cmd->size.h = (uint8_t)h;
+}
+
+void dl_bits(DisplayList* list, int x, int y, uint16_t bits, Color color) {
+    if (x < 0 || x >= MATRIX_COLS || y >= MATRIX_ROWS || y <= -16) return;
+    if (y < 0) {
+        bits >>= -y;
+        y = 0;
+    }
+    if (MATRIX_ROWS - y < 16) bits &= (1u << (MATRIX_ROWS - y)) - 1;
+    if (!bits) return;
+
+    DrawCommand* cmd = dl_push(list, DL_BITS, x, y, color);
+    if (cmd) cmd->bits = bits;
+}
+
+void dl_blend(DisplayList* list, int x, int y, Color color) {
+    if (x < 0 || x >= MATRIX_COLS || y < 0 || y >= MATRIX_ROWS) return;
+    dl_push(list, DL_BLEND, x, y, color);
+}
+
+// ============================================================================
+// EXECUTION
+// ============================================================================
+
+static uint64_t row_mask(int x, int w) {
+    return (w >= 64 ? ~0ull : ((1ull << w) - 1)) << x;
+}
+
+// True if every pixel 'cmd' writes is already in 'covered'. Opaque
+// commands then add their pixels to it
+static bool cover(const DrawCommand* cmd, uint64_t* covered) {
+    bool hidden = true;
+
+    switch (cmd->op) {
+        case DL_CLEAR:
+            for (int row = 0; row < MATRIX_ROWS; row++) {
+                hidden &= covered[row] == ~0ull;
+                covered[row] = ~0ull;
+            }
+            break;
+        case DL_RECT: {
+            uint64_t mask = row_mask(cmd->x, cmd->size.w);
+            for (int row = cmd->y; row < cmd->y + cmd->size.h; row++) {
+                hidden &= (covered[row] & mask) == mask;
+                covered[row] |= mask;
+            }
+            break;
+        }
+        case DL_BITS: {
+            uint64_t mask = 1ull << cmd->x;
+            for (int row = 0; row < 16; row++) {
+                if (!((cmd->bits >> row) & 1)) continue;
+                hidden &= (covered[cmd->y + row] & mask) != 0;
+                covered[cmd->y + row] |= mask;
+            }
+            break;
+        }
+        case DL_BLEND:
+            // Reads what is under it, so it never hides anything
+            hidden = (covered[cmd->y] >> cmd->x) & 1;
+            break;
+    }
+    return hidden;
+}
+
+static inline uint8_t add_saturate(uint8_t a, uint8_t b) {
+    uint32_t sum = (uint32_t)a + b;
+    return sum > 255 ? 255 : (uint8_t)sum;
+}
+
+static void run(const DrawCommand* cmd) {
+    switch (cmd->op) {
+        case DL_CLEAR:
+            for (int x = 0; x < MATRIX_COLS; x++) framebuffer[0][x] = cmd->color;
+            for (int row = 1; row < MATRIX_ROWS; row++) {
+                memcpy(framebuffer[row], framebuffer[0], sizeof(framebuffer[0]));
+            }
+            break;
+        case DL_RECT:
+            for (int row = cmd->y; row < cmd->y + cmd->size.h; row++) {
+                Color* pixel = &framebuffer[row][cmd->x];
+                for (int i = 0; i < cmd->size.w; i++) pixel[i] = cmd->color;
+            }
+            break;
+        case DL_BITS:
+            for (int row = 0; row < 16; row++) {
+                if ((cmd->bits >> row) & 1) framebuffer[cmd->y + row][cmd->x] = cmd->color;
+            }
+            break;
+        case DL_BLEND: {
+            Color* pixel = &framebuffer[cmd->y][cmd->x];
+            pixel->r = add_saturate(pixel->r, cmd->color.r);
+            pixel->g = add_saturate(pixel->g, cmd->color.g);
+            pixel->b = add_saturate(pixel->b, cmd->color.b);
+            break;
+        }
+    }
+}
+
+void dl_execute(DisplayList* list) {
+    // Back to front: a command is hidden if later opaque ones cover it
+    static uint32_t hidden[(MAX_DRAW_COMMANDS + 31) / 32];
+    uint64_t covered[MATRIX_ROWS] = {};
+
+    list->stats.culled = 0;
+    for (int i = list->count - 1; i >= 0; i--) {
+        uint32_t bit = 1u << (i & 31);
+        if (cover(&list->commands[i], covered)) {
+            hidden[i >> 5] |= bit;
+            list->stats.culled++;
+        } else {
+            hidden[i >> 5] &= ~bit;
+        }
+    }
+
+    for (int i = 0; i < list->count; i++) {
+        if (!((hidden[i >> 5] >> (i & 31)) & 1)) run(&list->commands[i]);
+    }
+    list->stats.commands = list->count;
+}
+
+// ============================================================================
+// SERIALIZATION
+// ============================================================================
+
+size_t dl_serialized_size(const DisplayList* list) {
+    return DL_HEADER_SIZE + (size_t)list->count * DL_COMMAND_SIZE;
+}
+
+size_t dl_serialize(const DisplayList* list, uint8_t* out, size_t size) {
+    size_t total = dl_serialized_size(list);
+    if (size < total) return 0;
+
+    out[0] = DL_MAGIC_0;
+    out[1] = DL_MAGIC_1;
+    out[2] = DL_VERSION;
+    out[3] = 0;
+    out[4] = (uint8_t)(list->count & 0xFF);
+    out[5] = (uint8_t)(list->count >> 8);
+    out[6] = 0;
+    out[7] = 0;
+
+    uint8_t* p = out + DL_HEADER_SIZE;
+    for (int i = 0; i < list->count; i++, p += DL_COMMAND_SIZE) {
+        const DrawCommand* cmd = &list->commands[i];
+        p[0] = cmd->op;
+        p[1] = cmd->x;
+        p[2] = cmd->y;
+        p[3] = cmd->color.r;
+        p[4] = cmd->color.g;
+        p[5] = cmd->color.b;
+        p[6] = (uint8_t)(cmd->bits & 0xFF);
+        p[7] = (uint8_t)(cmd->bits >> 8);
+    }
+    return total;
+}
+
+// Same bounds the recorder clips to, a replayed list can't write outside
+static bool command_valid(const DrawCommand* cmd) {
+    if (cmd->op >= DL_OP_COUNT || cmd->x >= MATRIX_COLS || cmd->y >= MATRIX_ROWS) return false;
+
+    switch (cmd->op) {
+        case DL_RECT:
+            return cmd->size.w > 0 && cmd->size.h > 0 &&
+                   cmd->x + cmd->size.w <= MATRIX_COLS && cmd->y + cmd->size.h <= MATRIX_ROWS;
+        case DL_BITS:
+            return MATRIX_ROWS - cmd->y >= 16 || (cmd->bits >> (MATRIX_ROWS - cmd->y)) == 0;
+        default:
+            return true;
+    }
+}
+
+size_t dl_deserialize(const uint8_t* data, size_t size, DisplayList* list) {
+    if (size < DL_HEADER_SIZE || data[0] != DL_MAGIC_0 || data[1] != DL_MAGIC_1 ||
+        data[2] != DL_VERSION) {
+        return 0;
+    }
+
+    uint16_t count = (uint16_t)(data[4] | (data[5] << 8));
+    size_t total = DL_HEADER_SIZE + (size_t)count * DL_COMMAND_SIZE;
+    if (count > MAX_DRAW_COMMANDS || size < total) return 0;
+
+    dl_begin(list);
+    const uint8_t* p = data + DL_HEADER_SIZE;
+    for (int i = 0; i < count; i++, p += DL_COMMAND_SIZE) {
+        DrawCommand* cmd = &list->commands[i];
+        cmd->op = p[0];
+        cmd->x = p[1];
+        cmd->y = p[2];
+        cmd->color = Color{p[3], p[4], p[5]};
+        cmd->bits = (uint16_t)(p[6] | (p[7] << 8));
+        if (!command_valid(cmd)) return 0;
+    }
+    list->count = count;
+    return total;
+}
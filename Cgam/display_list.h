@@ -0,0 +1,82 @@
+// display_list.h - Recorded draw commands, executed into the framebuffer
+#ifndef DISPLAY_LIST_H
+#define DISPLAY_LIST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "../lib/color.h"
+
+#define MAX_DRAW_COMMANDS 1024
+#define DL_MAGIC_0 'D'
+#define DL_MAGIC_1 'L'
+#define DL_VERSION 1
+#define DL_HEADER_SIZE 8
+#define DL_COMMAND_SIZE 8
+
+typedef enum {
+    DL_CLEAR,                // Whole matrix
+    DL_RECT,                 // Pixels and spans are 1 high rects
+    DL_BITS,                 // Column of 1 bit text, bit n lights row y + n
+    DL_BLEND,                // Saturating add of one pixel
+    DL_OP_COUNT
+} DrawOp;
+
+// 8 bytes. Clipped to the matrix when recorded, so the executor never
+// clips and every command in a list is in range
+typedef struct {
+    uint8_t op;
+    uint8_t x, y;
+    Color color;
+    union {
+        struct {
+            uint8_t w, h;
+        } size;              // DL_RECT
+        uint16_t bits;       // DL_BITS
+    };
+} DrawCommand;
+
+typedef struct {
+    uint16_t commands;
+    uint16_t merged;         // Rects folded into the previous one
+    uint16_t culled;         // Skipped, hidden under later opaque ones
+    uint16_t dropped;        // Lost to a full list
+} DisplayListStats;
+
+typedef struct {
+    DrawCommand commands[MAX_DRAW_COMMANDS];
+    uint16_t count;
+    DisplayListStats stats;
+} DisplayList;
+
+// ============================================================================
+// RECORDING
+// ============================================================================
+
+void dl_begin(DisplayList* list);
+void dl_clear(DisplayList* list, Color color);
+void dl_pixel(DisplayList* list, int x, int y, Color color);
+void dl_rect(DisplayList* list, int x, int y, int w, int h, Color color);
+void dl_bits(DisplayList* list, int x, int y, uint16_t bits, Color color);
+void dl_blend(DisplayList* list, int x, int y, Color color);
+
+// ============================================================================
+// EXECUTION & SERIALIZATION
+// ============================================================================
+
+// Rasterize into the framebuffer, skipping commands nothing of shows
+// through. Fills in stats.culled
+void dl_execute(DisplayList* list);
+
+// Bytes dl_serialize() writes for this list
+size_t dl_serialized_size(const DisplayList* list);
+
+// Little endian, 8 byte header then 8 bytes per command. Returns the
+// bytes written, 0 if 'size' is too small
+size_t dl_serialize(const DisplayList* list, uint8_t* out, size_t size);
+
+// Reads one serialized list from the start of 'data'. Returns the bytes
+// it took, 0 if it is not a valid list
+size_t dl_deserialize(const uint8_t* data, size_t size, DisplayList* list);
+
+#endif // DISPLAY_LIST_H
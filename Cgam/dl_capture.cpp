@@ -0,0 +1,107 @@
+// dl_capture.cpp - Sends core1's display lists to the host over USB
+#include "dl_capture.h"
+#include <stdlib.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/stdio_usb.h"
+#include "hardware/sync.h"
+#include "../lib/usb/usb_command.hh"
+#include "../lib/usb/usb_packet.hh"
+
+#define CHUNK_HEADER 4           // frame u16, offset u16
+#define CHUNK_MAX (USB_PACKET_PAYLOAD_MAX - CHUNK_HEADER)
+
+// Core1 writes the buffer while 'buffer_full' is false, core0 sends it
+// while it is true
+static uint8_t buffer[DL_HEADER_SIZE + MAX_DRAW_COMMANDS * DL_COMMAND_SIZE];
+static uint16_t buffer_size;
+static uint16_t buffer_frame;
+static volatile bool buffer_full = false;
+
+// Lists the host still wants, only core0 writes it
+static volatile uint32_t frames_wanted = 0;
+
+static UsbPacket packet;
+static uint16_t seq = 0;
+static bool sending = false;
+static uint16_t sent;            // Bytes of the buffer already packed
+
+// Hands the buffer back to core1
+static void release() {
+    sending = false;
+    __dmb();
+    buffer_full = false;
+}
+
+static void stop() {
+    frames_wanted = 0;
+    usb_packet_cancel(&packet);
+    release();
+}
+
+static bool capture_command(int argc, char** argv) {
+    if (argc != 2) return false;
+
+    if (strcmp(argv[1], "stop") == 0) {
+        stop();
+        return true;
+    }
+
+    char* end;
+    unsigned long frames = strtoul(argv[1], &end, 10);
+    if (*end != '\0' || frames < 1 || frames > DL_CAPTURE_MAX_FRAMES) return false;
+    frames_wanted = frames;
+    return true;
+}
+
+void dl_capture_init() {
+    usb_command_register("capture", capture_command, "<frames>|stop");
+}
+
+void dl_capture_poll() {
+    if (frames_wanted == 0 && !sending) {
+        // Core1 copied one more as the capture ended, nobody wants it
+        if (buffer_full) release();
+        return;
+    }
+
+    // Host closed the port, wait for the next capture command
+    if (!stdio_usb_connected()) {
+        stop();
+        return;
+    }
+
+    while (usb_packet_send(&packet)) {
+        if (!sending) {
+            if (!buffer_full || frames_wanted == 0) return;
+            __dmb();
+            frames_wanted = frames_wanted - 1;
+            sending = true;
+            sent = 0;
+        }
+
+        uint16_t length = buffer_size - sent;
+        if (length > CHUNK_MAX) length = CHUNK_MAX;
+
+        uint8_t* payload = usb_packet_begin(&packet, packet_display_list, seq++);
+        payload[0] = buffer_frame & 0xFF;
+        payload[1] = buffer_frame >> 8;
+        payload[2] = sent & 0xFF;
+        payload[3] = sent >> 8;
+        memcpy(payload + CHUNK_HEADER, buffer + sent, length);
+        usb_packet_end(&packet, CHUNK_HEADER + length);
+
+        // The packet holds its own copy, the last piece frees the buffer
+        sent += length;
+        if (sent == buffer_size) release();
+    }
+}
+
+void dl_capture_frame(const DisplayList* list, uint16_t frame) {
+    if (frames_wanted == 0 || buffer_full) return;
+
+    buffer_size = (uint16_t)dl_serialize(list, buffer, sizeof(buffer));
+    buffer_frame = frame;
+    __dmb();
+    buffer_full = true;
+}
@@ -0,0 +1,47 @@
+// dl_capture.h - Sends core1's display lists to the host over USB
+#ifndef DL_CAPTURE_H
+#define DL_CAPTURE_H
+
+#include <stdint.h>
+#include "display_list.h"
+
+// Most lists one "capture" command asks for
+#define DL_CAPTURE_MAX_FRAMES 1000
+
+// Host to board, usb_command lines:
+//     capture <frames>    send the next 1 to DL_CAPTURE_MAX_FRAMES lists
+//     capture stop
+//
+// Board to host, usb_packet packets (packet_display_list). Each carries
+// a piece of one dl_serialize()d list:
+//
+//     frame u16, offset u16, then the next bytes of the list
+//
+// frame is core1's frame number, so the host sees which frames were
+// skipped. tools/dl_replay/dl_capture.py writes the lists back to back,
+// which is what dl_replay reads.
+//
+// Core1 serializes a list into the one capture buffer only when core0
+// has finished sending the last, so nothing waits on USB. A list of
+// MAX_DRAW_COMMANDS is ~8 KB, a busy frame takes a few frames to send
+// and the ones in between are skipped
+
+// ============================================================================
+// CORE0
+// ============================================================================
+
+// Registers the capture command
+void dl_capture_init();
+
+// Sends what fits in the USB buffer, call every frame
+void dl_capture_poll();
+
+// ============================================================================
+// CORE1
+// ============================================================================
+
+// Copies the list out if the host is waiting for one and the last one
+// has gone out, call after each dl_execute()
+void dl_capture_frame(const DisplayList* list, uint16_t frame);
+
+#endif // DL_CAPTURE_H
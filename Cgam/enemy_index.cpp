@@ -0,0 +1,69 @@
+// enemy_index.cpp - Bucket grid build and radius queries
+#include "game_types.h"
+
+static int cell_of(float x, float y) {
+    int cx = (int)x >> ENEMY_CELL_SHIFT;
+    int cy = (int)y >> ENEMY_CELL_SHIFT;
+    if (x < 0.0f) cx = 0;
+    if (y < 0.0f) cy = 0;
+    if (cx >= ENEMY_CELLS_X) cx = ENEMY_CELLS_X - 1;
+    if (cy >= ENEMY_CELLS_Y) cy = ENEMY_CELLS_Y - 1;
+    return cy * ENEMY_CELLS_X + cx;
+}
+
+// Two passes over the enemies, no per-cell lists to manage
+void game_index_enemies(GameState* game) {
+    EnemyIndex* index = &game->enemy_index;
+    uint8_t counts[ENEMY_CELLS] = {0};
+    uint8_t cells[MAX_ENEMIES];
+
+    for (int i = 0; i < game->enemy_count; i++) {
+        const Enemy* e = &game->enemies[i];
+        if (!e->alive) {
+            cells[i] = 0xFF;
+            continue;
+        }
+        cells[i] = (uint8_t)cell_of(e->x, e->y);
+        counts[cells[i]]++;
+    }
+
+    index->cell_start[0] = 0;
+    for (int c = 0; c < ENEMY_CELLS; c++) {
+        index->cell_start[c + 1] = index->cell_start[c] + counts[c];
+    }
+
+    uint8_t fill[ENEMY_CELLS];
+    for (int c = 0; c < ENEMY_CELLS; c++) fill[c] = index->cell_start[c];
+    for (int i = 0; i < game->enemy_count; i++) {
+        if (cells[i] != 0xFF) index->order[fill[cells[i]]++] = (uint8_t)i;
+    }
+}
+
+// Only the cells the circle's bounding box touches are visited. Enemies
+// killed since the index was built are skipped
+uint8_t game_enemies_in_radius(const GameState* game, float x, float y, float radius,
+                               uint8_t* out, uint8_t max) {
+    const EnemyIndex* index = &game->enemy_index;
+    int first = cell_of(x - radius, y - radius);
+    int last = cell_of(x + radius, y + radius);
+    int x0 = first % ENEMY_CELLS_X, y0 = first / ENEMY_CELLS_X;
+    int x1 = last % ENEMY_CELLS_X, y1 = last / ENEMY_CELLS_X;
+    float r2 = radius * radius;
+    uint8_t found = 0;
+
+    for (int cy = y0; cy <= y1; cy++) {
+        for (int cx = x0; cx <= x1; cx++) {
+            int c = cy * ENEMY_CELLS_X + cx;
+            for (int k = index->cell_start[c]; k < index->cell_start[c + 1]; k++) {
+                uint8_t i = index->order[k];
+                const Enemy* e = &game->enemies[i];
+                if (!e->alive) continue;
+                if (distance_squared(x, y, e->x, e->y) > r2) continue;
+
+                if (found == max) return found;
+                out[found++] = i;
+            }
+        }
+    }
+    return found;
+}
@@ -0,0 +1,21 @@
+// enemy_index.h - Per-tick bucket grid over the enemies for radius queries
+#ifndef ENEMY_INDEX_H
+#define ENEMY_INDEX_H
+
+#include <stdint.h>
+
+// 8x8 pixel cells over the 64x32 matrix
+#define ENEMY_CELL_SHIFT 3
+#define ENEMY_CELLS_X (64 >> ENEMY_CELL_SHIFT)
+#define ENEMY_CELLS_Y (32 >> ENEMY_CELL_SHIFT)
+#define ENEMY_CELLS (ENEMY_CELLS_X * ENEMY_CELLS_Y)
+
+// Live enemy indices sorted by cell (a counting sort), rebuilt once per
+// tick. Cell c holds order[cell_start[c]] .. order[cell_start[c + 1] - 1].
+// Enemies off the matrix are filed under the nearest edge cell
+typedef struct {
+    uint8_t cell_start[ENEMY_CELLS + 1];
+    uint8_t order[255];
+} EnemyIndex;
+
+#endif // ENEMY_INDEX_H
@@ -1,6 +1,6 @@
 // game.cpp - Core game implementation
 #include "game_types.h"
-#include "../lib/matrix/matrix.h"
+#include "../lib/maps/map_blob.hh"
 #include <math.h>
 #include <string.h>
 
@@ -18,7 +18,8 @@ const EnemyStats ENEMY_STATS_TABLE[] = {
         .damage = 1,
         .invisible = false,
         .splits_on_death = false,
-        .split_count = 0
+        .split_count = 0,
+        .split_type = ENEMY_SCOUT
     },
     // ENEMY_TANK
     {
@@ -29,7 +30,8 @@ const EnemyStats ENEMY_STATS_TABLE[] = {
         .damage = 3,
         .invisible = false,
         .splits_on_death = false,
-        .split_count = 0
+        .split_count = 0,
+        .split_type = ENEMY_SCOUT
     },
     // ENEMY_SPLITTER
     {
@@ -40,7 +42,8 @@ const EnemyStats ENEMY_STATS_TABLE[] = {
         .damage = 2,
         .invisible = false,
         .splits_on_death = true,
-        .split_count = 2
+        .split_count = 2,
+        .split_type = ENEMY_SCOUT
     },
     // ENEMY_GHOST
     {
@@ -51,7 +54,8 @@ const EnemyStats ENEMY_STATS_TABLE[] = {
         .damage = 1,
         .invisible = true,
         .splits_on_death = false,
-        .split_count = 0
+        .split_count = 0,
+        .split_type = ENEMY_SCOUT
     }
 };
 
@@ -149,6 +153,13 @@ void enemy_init(Enemy* enemy, EnemyType type, float start_x, float start_y) {
     enemy->revealed = !stats->invisible;
 }
 
+// game_update() packs the live enemies to the front every tick, so the
+// next free slot is always the one after them
+static Enemy* enemy_alloc(GameState* game) {
+    if (game->enemy_count >= MAX_ENEMIES) return NULL;
+    return &game->enemies[game->enemy_count++];
+}
+
 void enemy_update(Enemy* enemy, float dt, GameState* game) {
     if (!enemy->alive) return;
 
@@ -189,26 +200,7 @@ void enemy_update(Enemy* enemy, float dt, GameState* game) {
     }
 
     if (enemy->health <= 0) {
-        enemy->alive = false;
-    }
-}
-
-void enemy_draw(const Enemy* enemy) {
-    if (!enemy->alive) return;
-
-    int x = (int)enemy->x;
-    int y = (int)enemy->y;
-
-    if (x < 0 || x >= MATRIX_WIDTH || y < 0 || y >= MATRIX_HEIGHT) {
-        return;
-    }
-
-    // Ghost enemies are barely visible
-    if (enemy->invisible && !enemy->revealed) {
-        Color ghost_color = {enemy->color.r / 8, enemy->color.g / 8, enemy->color.b / 4};
-        framebuffer[y][x] = ghost_color;
-    } else {
-        framebuffer[y][x] = enemy->color;
+        game_kill_enemy(game, enemy);
     }
 }
 
@@ -306,26 +298,16 @@ void tower_update(Tower* tower, float dt, GameState* game) {
     }
 }
 
-void tower_draw(const Tower* tower) {
+void tower_draw(const Tower* tower, DisplayList* list) {
     int x = (int)tower->x;
     int y = (int)tower->y;
 
-    for (int dy = -1; dy <= 1; dy++) {
-        for (int dx = -1; dx <= 1; dx++) {
-            int px = x + dx;
-            int py = y + dy;
-            if (px >= 0 && px < MATRIX_WIDTH && py >= 0 && py < MATRIX_HEIGHT) {
-                framebuffer[py][px] = tower->color;
-            }
-        }
-    }
+    dl_rect(list, x - 1, y - 1, 3, 3, tower->color);
 
     if (tower->is_radar) {
         int tip_x = x + (int)(cosf(tower->radar_angle) * 3.0f);
         int tip_y = y + (int)(sinf(tower->radar_angle) * 3.0f);
-        if (tip_x >= 0 && tip_x < MATRIX_WIDTH && tip_y >= 0 && tip_y < MATRIX_HEIGHT) {
-            framebuffer[tip_y][tip_x] = Color{0, 255, 255};
-        }
+        dl_pixel(list, tip_x, tip_y, Color{0, 255, 255});
     }
 }
 
@@ -360,16 +342,17 @@ bool projectile_update(Projectile* proj, float dt, GameState* game) {
     float dist = sqrtf(dx * dx + dy * dy);
 
     if (dist < 0.3f) {
+        particles_emit(&game->particles, PARTICLE_HIT, proj->x, proj->y,
+                       proj->color.r, proj->color.g, proj->color.b, 1.0f);
         target->health -= proj->damage;
         if (target->health <= 0) {
-            target->alive = false;
-            const EnemyStats* stats = &ENEMY_STATS_TABLE[target->type];
-            game->money += stats->reward;
-            game->score += stats->reward * 10;
+            game_kill_enemy(game, target);
         }
 
         if (proj->splash_radius > 0) {
             float splash_r = (float)proj->splash_radius;
+            particles_emit(&game->particles, PARTICLE_EXPLOSION, proj->x, proj->y,
+                           0, 0, 0, splash_r * 0.5f);
             for (int i = 0; i < game->enemy_count; i++) {
                 if (i == proj->target_index) continue;
                 Enemy* e = &game->enemies[i];
@@ -377,10 +360,7 @@ bool projectile_update(Projectile* proj, float dt, GameState* game) {
                 if (distance(proj->x, proj->y, e->x, e->y) <= splash_r) {
                     e->health -= proj->damage;
                     if (e->health <= 0) {
-                        e->alive = false;
-                        const EnemyStats* stats = &ENEMY_STATS_TABLE[e->type];
-                        game->money += stats->reward;
-                        game->score += stats->reward * 10;
+                        game_kill_enemy(game, e);
                     }
                 }
             }
@@ -401,14 +381,34 @@ bool projectile_update(Projectile* proj, float dt, GameState* game) {
     return true;
 }
 
-void projectile_draw(const Projectile* proj) {
-    if (!proj->active) return;
-
-    int x = (int)proj->x;
-    int y = (int)proj->y;
+// ============================================================================
+// DECORATIONS
+// ============================================================================
 
-    if (x >= 0 && x < MATRIX_WIDTH && y >= 0 && y < MATRIX_HEIGHT) {
-        framebuffer[y][x] = proj->color;
+// Keep in sync with rasterize_decoration() in map_grid.cpp
+void decoration_draw(const Decoration* deco, DisplayList* list) {
+    const Color tree = {0, 80, 0};
+    const Color trunk = {100, 50, 0};
+    const Color rock = {75, 75, 75};
+    const Color lake = {0, 0, 150};
+    int x = deco->x;
+    int y = deco->y;
+
+    switch (deco->type) {
+        case DECORATION_TREE:
+            dl_rect(list, x - 1, y - 1, 3, 3, tree);
+            dl_rect(list, x, y + 2, 1, 2, trunk);
+            dl_rect(list, x - 1, y + 3, 3, 1, trunk);
+            break;
+        case DECORATION_ROCK:
+            dl_rect(list, x - 1, y - 1, 2, 2, rock);
+            dl_rect(list, x + 1, y, 1, 1, rock);
+            break;
+        case DECORATION_LAKE:
+            dl_rect(list, x - 1, y - 1, 6, 2, lake);
+            dl_rect(list, x, y - 2, 3, 1, lake);
+            dl_rect(list, x + 1, y + 1, 3, 1, lake);
+            break;
     }
 }
 
@@ -418,43 +418,199 @@ void projectile_draw(const Projectile* proj) {
 
 void game_init(GameState* game) {
     memset(game, 0, sizeof(GameState));
+    particles_init(&game->particles);
 
     game->money = 200;
     game->lives = 20;
     game->score = 0;
     game->game_time = 0.0f;
     game->wave_number = 0;
-    game->total_waves = 6;
-
-    // Initialize simple path (right to left)
-    game->path[0] = {63, 15};
-    game->path[1] = {50, 15};
-    game->path[2] = {50, 25};
-    game->path[3] = {30, 25};
-    game->path[4] = {30, 10};
-    game->path[5] = {15, 10};
-    game->path[6] = {15, 20};
-    game->path[7] = {0, 20};
-    game->path_length = 8;
-
-    // Initialize tower slots
-    game->tower_slots[0] = {55, 8, false};
-    game->tower_slots[1] = {55, 22, false};
-    game->tower_slots[2] = {38, 18, false};
-    game->tower_slots[3] = {20, 6, false};
-    game->tower_slots[4] = {20, 28, false};
-    game->tower_slot_count = 5;
+
+    // Map 0 from the compiled map blob (lib/maps)
+    game_load_map(game, 0);
+}
+
+bool game_load_map(GameState* game, uint16_t index) {
+    const MapRecord* map = map_get(index);
+    if (!map) return false;
+
+    // Read straight out of flash
+    const MapBlobPoint* path = map_path(map);
+    game->path_length = map->path_count < MAX_PATH_WAYPOINTS ? map->path_count : MAX_PATH_WAYPOINTS;
+    for (int i = 0; i < game->path_length; i++) {
+        game->path[i] = {path[i].x, path[i].y};
+    }
+
+    const MapBlobPoint* slots = map_slots(map);
+    game->tower_slot_count = map->slot_count < MAX_TOWERS ? map->slot_count : MAX_TOWERS;
+    for (int i = 0; i < game->tower_slot_count; i++) {
+        game->tower_slots[i] = {slots[i].x, slots[i].y, false};
+    }
+
+    const MapBlobDecoration* decorations = map_decorations(map);
+    game->decoration_count = map->decoration_count < MAX_DECORATIONS ? map->decoration_count : MAX_DECORATIONS;
+    for (int i = 0; i < game->decoration_count; i++) {
+        game->decorations[i] = {(DecorationType)decorations[i].type, decorations[i].x, decorations[i].y};
+    }
+
+    // Wave timelines stay in flash, see game_start_wave()
+    game->map = map;
+    game->total_waves = map->wave_count < 255 ? map->wave_count : 255;
+    game->wave_number = 0;
+    game->wave_active = false;
+
+    map_grid_build(&game->grid, game->path, game->path_length,
+                   game->decorations, game->decoration_count);
+    return true;
 }
 
 void game_spawn_enemy(GameState* game, EnemyType type) {
-    if (game->enemy_count >= MAX_ENEMIES) return;
+    Enemy* enemy = enemy_alloc(game);
+    if (!enemy) return;
 
-    Enemy* enemy = &game->enemies[game->enemy_count];
     int16_t start_x = game->path[0].x;
     int16_t start_y = game->path[0].y;
     enemy_init(enemy, type, (float)start_x, (float)start_y);
+}
+
+// Reward and queue any split. The children are spawned by
+// game_spawn_splits() at the end of the tick, so a kill in the middle
+// of a loop over the enemies never adds to it
+void game_kill_enemy(GameState* game, Enemy* enemy) {
+    if (!enemy->alive) return;
+
+    const EnemyStats* stats = &ENEMY_STATS_TABLE[enemy->type];
+    game->money += stats->reward;
+    game->score += stats->reward * 10;
+    particles_emit(&game->particles, PARTICLE_DEATH, enemy->x, enemy->y,
+                   enemy->color.r, enemy->color.g, enemy->color.b, 1.0f);
+
+    if (stats->splits_on_death && stats->split_count > 0) {
+        if (game->split_pending < MAX_SPLIT_QUEUE) {
+            uint8_t tail = (game->split_head + game->split_pending) % MAX_SPLIT_QUEUE;
+            game->split_queue[tail] = {stats->split_type, stats->split_count, 0,
+                                       enemy->x, enemy->y,
+                                       enemy->path_index, enemy->path_progress};
+            game->split_pending++;
+        } else {
+            game->splits_dropped += stats->split_count;
+        }
+    }
+
+    enemy->alive = false;
+}
 
-    game->enemy_count++;
+// Spacing of split children along the path, in pixels
+#define SPLIT_SPACING 0.75f
+
+// Places a child 'offset' pixels along the parent's path segment, kept
+// between the segment's two waypoints
+static void split_place(const GameState* game, Enemy* child, const SplitSpawn* split, float offset) {
+    int16_t x1 = game->path[split->path_index].x;
+    int16_t y1 = game->path[split->path_index].y;
+    int16_t x2 = game->path[split->path_index + 1].x;
+    int16_t y2 = game->path[split->path_index + 1].y;
+
+    float behind = distance(x1, y1, split->x, split->y);
+    float ahead = distance(split->x, split->y, x2, y2);
+    if (offset < -behind) offset = -behind;
+    if (offset > ahead) offset = ahead;
+
+    float length = behind + ahead;
+    if (length == 0.0f) length = 0.0001f;
+
+    child->x = split->x + (x2 - x1) / length * offset;
+    child->y = split->y + (y2 - y1) / length * offset;
+    child->path_index = split->path_index;
+    child->path_progress = split->path_progress + offset;
+}
+
+// At most MAX_SPLITS_PER_TICK children per call, the rest wait for the
+// next tick. Children that die before then can split again, the queue
+// and this budget keep even long chains bounded
+void game_spawn_splits(GameState* game) {
+    int budget = MAX_SPLITS_PER_TICK;
+
+    while (game->split_pending > 0 && budget > 0) {
+        SplitSpawn* split = &game->split_queue[game->split_head];
+
+        // Leaked parents have no segment left to spread along
+        bool on_path = split->path_index + 1 < game->path_length;
+
+        while (split->spawned < split->count && budget > 0) {
+            Enemy* child = enemy_alloc(game);
+            if (!child) {
+                // Pool full, the rest of this split is lost
+                game->splits_dropped += split->count - split->spawned;
+                split->spawned = split->count;
+                break;
+            }
+
+            // Centered on the parent: -0.375 and +0.375 for two
+            float offset = (split->spawned - (split->count - 1) / 2.0f) * SPLIT_SPACING;
+            enemy_init(child, split->type, split->x, split->y);
+            if (on_path) {
+                split_place(game, child, split, offset);
+            } else {
+                child->path_index = split->path_index;
+                child->path_progress = split->path_progress;
+            }
+
+            split->spawned++;
+            budget--;
+        }
+
+        if (split->spawned == split->count) {
+            game->split_head = (game->split_head + 1) % MAX_SPLIT_QUEUE;
+            game->split_pending--;
+        }
+    }
+}
+
+// ============================================================================
+// WAVES
+// ============================================================================
+
+bool game_start_wave(GameState* game) {
+    if (!game->map || game->wave_number >= game->total_waves) return false;
+
+    const MapBlobWave* wave = &map_waves(game->map)[game->wave_number];
+    game->wave.next = map_wave_events(wave);
+    game->wave.remaining = wave->event_count;
+    game->wave.wait = game->wave.remaining ? game->wave.next->delay_ms / 1000.0f : 0.0f;
+
+    game->wave_number++;
+    game->wave_active = game->wave.remaining > 0;
+    return true;
+}
+
+// Between waves the banner plane announces the next one, which starts
+// as the banner leaves the screen. During a wave this only ever looks at
+// the next event, whatever the wave's length. Several can come due in one
+// tick if dt is long
+void game_update_wave(GameState* game, float dt) {
+    WaveCursor* cursor = &game->wave;
+
+    if (!game->wave_active) {
+        if (banner_update(&game->banner, dt)) {
+            game_start_wave(game);
+        } else if (!game->banner.active && game->enemy_count == 0 &&
+                   game->wave_number < game->total_waves) {
+            banner_start_wave(&game->banner, game->wave_number + 1, game->game_time);
+        }
+        return;
+    }
+
+    cursor->wait -= dt;
+    while (cursor->remaining && cursor->wait <= 0.0f) {
+        game_spawn_enemy(game, (EnemyType)cursor->next->type);
+
+        cursor->next++;
+        cursor->remaining--;
+        if (cursor->remaining) cursor->wait += cursor->next->delay_ms / 1000.0f;
+    }
+
+    game->wave_active = cursor->remaining > 0;
 }
 
 bool game_place_tower(GameState* game, TowerType type, int16_t x, int16_t y) {
@@ -463,29 +619,36 @@ bool game_place_tower(GameState* game, TowerType type, int16_t x, int16_t y) {
     const TowerStats* stats = &TOWER_STATS_TABLE[type];
     if (game->money < stats->cost) return false;
 
-    int slot_index = -1;
-    for (int i = 0; i < game->tower_slot_count; i++) {
-        if (!game->tower_slots[i].occupied &&
-            game->tower_slots[i].x == x &&
-            game->tower_slots[i].y == y) {
-            slot_index = i;
-            break;
-        }
-    }
-
-    if (slot_index == -1) {
+    // Footprint must be clear of path, decorations and other towers
+    if (!map_grid_can_place(&game->grid, x, y)) {
         return false;
     }
 
     Tower* tower = &game->towers[game->tower_count];
     tower_init(tower, type, x, y);
 
-    game->tower_slots[slot_index].occupied = true;
+    for (int i = 0; i < game->tower_slot_count; i++) {
+        if (game->tower_slots[i].x == x && game->tower_slots[i].y == y) {
+            game->tower_slots[i].occupied = true;
+        }
+    }
+
+    map_grid_add_tower(&game->grid, x, y);
     game->tower_count++;
     game->money -= stats->cost;
     return true;
 }
 
+// Moves a cursor position to the nearest spot a tower fits
+bool game_snap_placement(const GameState* game, int16_t* x, int16_t* y) {
+    return map_grid_snap(&game->grid, x, y);
+}
+
+// Path pixels a tower of this type would cover from (x, y)
+uint16_t game_placement_coverage(const GameState* game, TowerType type, int16_t x, int16_t y) {
+    return map_grid_path_coverage(&game->grid, x, y, TOWER_STATS_TABLE[type].range);
+}
+
 void game_update(GameState* game, float dt) {
     game->game_time += dt;
 
@@ -523,48 +686,14 @@ void game_update(GameState* game, float dt) {
         }
     }
     game->enemy_count = write_index;
-}
 
-void game_draw(const GameState* game) {
-    // Draw path
-    for (int i = 0; i < game->path_length; i++) {
-        int x = game->path[i].x;
-        int y = game->path[i].y;
-        if (x >= 0 && x < MATRIX_WIDTH && y >= 0 && y < MATRIX_HEIGHT) {
-            framebuffer[y][x] = Color{100, 100, 100};
-        }
-    }
+    // Strikes query the enemies by area
+    game_index_enemies(game);
+    abilities_update(game, dt);
 
-    // Draw tower slots
-    for (int i = 0; i < game->tower_slot_count; i++) {
-        int x = game->tower_slots[i].x;
-        int y = game->tower_slots[i].y;
-        Color slot_color = game->tower_slots[i].occupied ?
-                           Color{60, 50, 0} : Color{128, 107, 0};
-
-        for (int dy = -2; dy < 2; dy++) {
-            for (int dx = -2; dx < 2; dx++) {
-                int px = x + dx;
-                int py = y + dy;
-                if (px >= 0 && px < MATRIX_WIDTH && py >= 0 && py < MATRIX_HEIGHT) {
-                    framebuffer[py][px] = slot_color;
-                }
-            }
-        }
-    }
-
-    // Draw towers
-    for (int i = 0; i < game->tower_count; i++) {
-        tower_draw(&game->towers[i]);
-    }
-
-    // Draw enemies
-    for (int i = 0; i < game->enemy_count; i++) {
-        enemy_draw(&game->enemies[i]);
-    }
+    // Children of this tick's deaths, strike kills included. They append
+    // after the compaction; the strike's dead are compacted next tick
+    game_spawn_splits(game);
 
-    // Draw projectiles
-    for (int i = 0; i < game->projectile_count; i++) {
-        projectile_draw(&game->projectiles[i]);
-    }
+    particles_update(&game->particles, dt);
 }
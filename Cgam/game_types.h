@@ -5,12 +5,24 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "../lib/color.h"
+#include "map_grid.h"
+#include "enemy_index.h"
+#include "ability.h"
+#include "banner.h"
+#include "particle.h"
+#include "display_list.h"
+#include "../lib/maps/map_blob.hh"
 
 // Configuration constants
-#define MAX_ENEMIES 50
+#ifndef MAX_ENEMIES
+#define MAX_ENEMIES 50           // At most 255, counts are uint8_t
+#endif
 #define MAX_TOWERS 10
 #define MAX_PROJECTILES 30
 #define MAX_PATH_WAYPOINTS 20
+#define MAX_DECORATIONS 16
+#define MAX_SPLIT_QUEUE 32
+#define MAX_SPLITS_PER_TICK 8
 #define MATRIX_WIDTH 64
 #define MATRIX_HEIGHT 32
 
@@ -34,6 +46,7 @@ typedef struct {
     bool invisible;
     bool splits_on_death;
     uint8_t split_count;
+    EnemyType split_type;    // What it splits into
 } EnemyStats;
 
 typedef struct {
@@ -54,6 +67,16 @@ typedef struct {
     bool revealed;           // If radar tower has revealed it
 } Enemy;
 
+// A death waiting to be turned into children, at the parent's place
+typedef struct {
+    EnemyType type;
+    uint8_t count;
+    uint8_t spawned;         // Children already out
+    float x, y;
+    uint8_t path_index;
+    float path_progress;
+} SplitSpawn;
+
 // ============================================================================
 // TOWER SYSTEM
 // ============================================================================
@@ -79,7 +102,7 @@ typedef struct {
 
     // State
     float time_since_shot;   // Time since last shot
-    int8_t target_index;     // Index of current target (-1 = none)
+    int16_t target_index;    // Index of current target (-1 = none)
 
     // Special abilities
     bool can_see_invisible;
@@ -87,6 +110,12 @@ typedef struct {
     float radar_angle;       // For radar sweep animation
 } Tower;
 
+typedef struct {
+    int16_t x;
+    int16_t y;
+    bool occupied;
+} TowerSlot;
+
 typedef struct {
     uint8_t cost;
     uint8_t damage;
@@ -117,14 +146,13 @@ typedef struct {
 // WAVE SYSTEM
 // ============================================================================
 
+// Walks a wave's spawn events in place in flash, one at a time, so
+// a wave of any length costs the same few bytes of GameState
 typedef struct {
-    EnemyType enemies[30];   // Enemy types to spawn
-    uint8_t enemy_count;     // Total enemies in wave
-    uint8_t spawn_index;     // Next enemy to spawn
-    float spawn_interval;    // Seconds between spawns
-    float time_since_spawn;  // Timer
-    bool completed;          // All spawned
-} Wave;
+    const MapSpawnEvent* next;   // Next event to spawn
+    uint16_t remaining;          // Events left, including next
+    float wait;                  // Seconds until next is due
+} WaveCursor;
 
 // ============================================================================
 // GAME STATE
@@ -135,6 +163,12 @@ typedef struct {
     Enemy enemies[MAX_ENEMIES];
     uint8_t enemy_count;
 
+    // Splits queued by this tick's deaths, spawned at the end of it
+    SplitSpawn split_queue[MAX_SPLIT_QUEUE];
+    uint8_t split_head;
+    uint8_t split_pending;
+    uint16_t splits_dropped;         // Children lost to a full pool or queue
+
     Tower towers[MAX_TOWERS];
     uint8_t tower_count;
 
@@ -142,18 +176,17 @@ typedef struct {
     uint8_t projectile_count;
 
     // Path definition (map)
-    struct {
-        int16_t x;
-        int16_t y;
-    } path[MAX_PATH_WAYPOINTS];
+    MapPoint path[MAX_PATH_WAYPOINTS];
     uint8_t path_length;
 
-    // Tower slots
-    struct {
-        int16_t x;
-        int16_t y;
-        bool occupied;
-    } tower_slots[MAX_TOWERS];
+    Decoration decorations[MAX_DECORATIONS];
+    uint8_t decoration_count;
+
+    // Occupancy/distance tables, rebuilt from the above at map load
+    MapGrid grid;
+
+    // Suggested tower spots, towers can go anywhere the grid allows
+    TowerSlot tower_slots[MAX_TOWERS];
     uint8_t tower_slot_count;
 
     // Game stats
@@ -162,16 +195,64 @@ typedef struct {
     uint16_t score;
     float game_time;
 
-    // Wave management (you can keep this simple at first)
-    Wave waves[10];
-    uint8_t wave_number;
+    // Wave management, timelines come from the map blob
+    const MapRecord* map;
+    WaveCursor wave;
+    uint8_t wave_number;     // Waves started so far
     uint8_t total_waves;
-    bool wave_active;
+    bool wave_active;        // Still spawning
+    Banner banner;           // Announces the next wave once the path is clear
+
+    // Apache and Bomber strikes
+    AbilityState abilities;
+
+    // Hit, blast and death effects
+    ParticleSystem particles;
+
+    // Live enemies by cell, rebuilt every tick for radius queries
+    EnemyIndex enemy_index;
 
     // Misc
     TowerType selected_tower;
 } GameState;
 
+// ============================================================================
+// DRAW SNAPSHOT
+// ============================================================================
+
+// One pixel of a unit, already colored (ghosts dimmed)
+typedef struct {
+    uint8_t x, y;
+    Color color;
+} SnapshotPixel;
+
+// Everything a frame draws, copied out of GameState at the end of a
+// tick. A published snapshot is never written by the simulation, so
+// one can be drawn on core1 while core0 runs the next tick
+typedef struct {
+    float game_time;
+
+    MapPoint path[MAX_PATH_WAYPOINTS];
+    uint8_t path_length;
+    Decoration decorations[MAX_DECORATIONS];
+    uint8_t decoration_count;
+    TowerSlot tower_slots[MAX_TOWERS];
+    uint8_t tower_slot_count;
+
+    Tower towers[MAX_TOWERS];
+    uint8_t tower_count;
+
+    // Live enemies, then projectiles, one pixel each
+    SnapshotPixel units[MAX_ENEMIES + MAX_PROJECTILES];
+    uint16_t unit_count;
+
+    ParticleSpark sparks[MAX_PARTICLES];
+    uint16_t spark_count;
+
+    AbilityState abilities;
+    Banner banner;
+} DrawSnapshot;
+
 // ============================================================================
 // FUNCTION PROTOTYPES
 // ============================================================================
@@ -179,26 +260,48 @@ typedef struct {
 // Enemy functions
 void enemy_init(Enemy* enemy, EnemyType type, float start_x, float start_y);
 void enemy_update(Enemy* enemy, float dt, GameState* game);
-void enemy_draw(const Enemy* enemy);
 
 // Tower functions
 void tower_init(Tower* tower, TowerType type, int16_t x, int16_t y);
 void tower_update(Tower* tower, float dt, GameState* game);
-void tower_draw(const Tower* tower);
+void tower_draw(const Tower* tower, DisplayList* list);
 
 // Projectile functions
 void projectile_init(Projectile* proj, float x, float y, uint8_t target_idx,
                      uint8_t damage, float speed, Color color, uint8_t splash);
 bool projectile_update(Projectile* proj, float dt, GameState* game);
-void projectile_draw(const Projectile* proj);
+
+// Decoration functions
+void decoration_draw(const Decoration* deco, DisplayList* list);
 
 // Game functions
 void game_init(GameState* game);
+bool game_load_map(GameState* game, uint16_t index);
 void game_update(GameState* game, float dt);
-void game_draw(const GameState* game);
 bool game_place_tower(GameState* game, TowerType type, int16_t x, int16_t y);
+bool game_snap_placement(const GameState* game, int16_t* x, int16_t* y);
+uint16_t game_placement_coverage(const GameState* game, TowerType type, int16_t x, int16_t y);
 void game_spawn_enemy(GameState* game, EnemyType type);
-void game_start_wave(GameState* game);
+void game_kill_enemy(GameState* game, Enemy* enemy);
+void game_spawn_splits(GameState* game);
+bool game_start_wave(GameState* game);
+void game_update_wave(GameState* game, float dt);
+
+// Enemy index functions (enemy_index.cpp)
+void game_index_enemies(GameState* game);
+uint8_t game_enemies_in_radius(const GameState* game, float x, float y, float radius,
+                               uint8_t* out, uint8_t max);
+
+// Ability functions (ability.cpp)
+bool game_can_activate(const GameState* game, AbilityType type);
+bool game_activate_ability(GameState* game, AbilityType type);
+float game_ability_cooldown(const GameState* game, AbilityType type);
+void abilities_update(GameState* game, float dt);
+void abilities_draw(const AbilityState* abilities, float game_time, DisplayList* list);
+
+// Snapshot functions (snapshot.cpp)
+void game_snapshot(const GameState* game, DrawSnapshot* snap);
+void snapshot_draw(const DrawSnapshot* snap, DisplayList* list);
 
 // Utility functions
 float distance_squared(float x1, float y1, float x2, float y2);
@@ -0,0 +1,251 @@
+// map_grid.cpp - Occupancy bitsets, distance-to-path field and snapping
+#include "map_grid.h"
+#include <string.h>
+
+#define CELLS (MAP_GRID_WIDTH * MAP_GRID_HEIGHT)
+
+// Chamfer weights, in half pixels
+#define DIST_STRAIGHT 2
+#define DIST_DIAGONAL 3
+
+// ============================================================================
+// RASTERIZING
+// ============================================================================
+
+static bool in_bounds(int x, int y) {
+    return x >= 0 && x < MAP_GRID_WIDTH && y >= 0 && y < MAP_GRID_HEIGHT;
+}
+
+static void set_bit(uint64_t* rows, int x, int y) {
+    if (in_bounds(x, y)) rows[y] |= 1ull << x;
+}
+
+static void fill_rect(uint64_t* rows, int x, int y, int w, int h) {
+    for (int py = y; py < y + h; py++) {
+        for (int px = x; px < x + w; px++) {
+            set_bit(rows, px, py);
+        }
+    }
+}
+
+// Same 3-wide Bresenham line the renderer draws
+static void rasterize_segment(uint64_t* rows, MapPoint a, MapPoint b) {
+    int x = a.x, y = a.y;
+    int dx = (b.x > a.x) ? b.x - a.x : a.x - b.x;
+    int dy = (b.y > a.y) ? b.y - a.y : a.y - b.y;
+    int sx = (a.x < b.x) ? 1 : -1;
+    int sy = (a.y < b.y) ? 1 : -1;
+    int err = dx - dy;
+    bool horizontal = (a.y == b.y);
+
+    for (;;) {
+        set_bit(rows, x, y);
+        if (horizontal) {
+            set_bit(rows, x, y - 1);
+            set_bit(rows, x, y + 1);
+        } else {
+            set_bit(rows, x - 1, y);
+            set_bit(rows, x + 1, y);
+        }
+
+        if (x == b.x && y == b.y) break;
+        int e2 = 2 * err;
+        if (e2 > -dy) { err -= dy; x += sx; }
+        if (e2 < dx) { err += dx; y += sy; }
+    }
+}
+
+// Footprints match the sprites in decoration_draw() (game.cpp)
+static void rasterize_decoration(uint64_t* rows, const Decoration* deco) {
+    int x = deco->x, y = deco->y;
+
+    switch (deco->type) {
+        case DECORATION_TREE:
+            fill_rect(rows, x - 1, y - 1, 3, 3);
+            fill_rect(rows, x, y + 2, 1, 2);
+            fill_rect(rows, x - 1, y + 3, 3, 1);
+            break;
+        case DECORATION_ROCK:
+            fill_rect(rows, x - 1, y - 1, 2, 2);
+            fill_rect(rows, x + 1, y, 1, 1);
+            break;
+        case DECORATION_LAKE:
+            fill_rect(rows, x - 1, y - 1, 6, 2);
+            fill_rect(rows, x, y - 2, 3, 1);
+            fill_rect(rows, x + 1, y + 1, 3, 1);
+            break;
+    }
+}
+
+// ============================================================================
+// DERIVED TABLES
+// ============================================================================
+
+static uint8_t min_u8(uint8_t a, int b) {
+    return (b < a) ? (uint8_t)b : a;
+}
+
+// Two-pass chamfer transform: forward pass pulls from up/left, backward
+// pass from down/right
+static void build_path_distance(MapGrid* grid) {
+    for (int y = 0; y < MAP_GRID_HEIGHT; y++) {
+        for (int x = 0; x < MAP_GRID_WIDTH; x++) {
+            grid->path_dist[y][x] = ((grid->path[y] >> x) & 1) ? 0 : 255;
+        }
+    }
+
+    for (int y = 0; y < MAP_GRID_HEIGHT; y++) {
+        for (int x = 0; x < MAP_GRID_WIDTH; x++) {
+            uint8_t d = grid->path_dist[y][x];
+            if (x > 0) d = min_u8(d, grid->path_dist[y][x - 1] + DIST_STRAIGHT);
+            if (y > 0) {
+                d = min_u8(d, grid->path_dist[y - 1][x] + DIST_STRAIGHT);
+                if (x > 0) d = min_u8(d, grid->path_dist[y - 1][x - 1] + DIST_DIAGONAL);
+                if (x < MAP_GRID_WIDTH - 1) d = min_u8(d, grid->path_dist[y - 1][x + 1] + DIST_DIAGONAL);
+            }
+            grid->path_dist[y][x] = d;
+        }
+    }
+
+    for (int y = MAP_GRID_HEIGHT - 1; y >= 0; y--) {
+        for (int x = MAP_GRID_WIDTH - 1; x >= 0; x--) {
+            uint8_t d = grid->path_dist[y][x];
+            if (x < MAP_GRID_WIDTH - 1) d = min_u8(d, grid->path_dist[y][x + 1] + DIST_STRAIGHT);
+            if (y < MAP_GRID_HEIGHT - 1) {
+                d = min_u8(d, grid->path_dist[y + 1][x] + DIST_STRAIGHT);
+                if (x < MAP_GRID_WIDTH - 1) d = min_u8(d, grid->path_dist[y + 1][x + 1] + DIST_DIAGONAL);
+                if (x > 0) d = min_u8(d, grid->path_dist[y + 1][x - 1] + DIST_DIAGONAL);
+            }
+            grid->path_dist[y][x] = d;
+        }
+    }
+}
+
+// A center is valid if the 3x3 around it is free. Shifting the free mask
+// left and right brings in zeros, so the edge columns are never valid
+static void build_valid(MapGrid* grid) {
+    uint64_t free3[MAP_GRID_HEIGHT];
+    for (int y = 0; y < MAP_GRID_HEIGHT; y++) {
+        uint64_t free = ~grid->blocked[y];
+        free3[y] = free & (free << 1) & (free >> 1);
+    }
+
+    grid->valid[0] = 0;
+    grid->valid[MAP_GRID_HEIGHT - 1] = 0;
+    for (int y = 1; y < MAP_GRID_HEIGHT - 1; y++) {
+        grid->valid[y] = free3[y - 1] & free3[y] & free3[y + 1];
+    }
+}
+
+// Breadth-first from every valid center at once, so each cell ends up
+// pointing at one of the closest (in 8-connected steps)
+static void build_snap(MapGrid* grid) {
+    static uint16_t queue[CELLS];
+    uint16_t head = 0, tail = 0;
+
+    for (int y = 0; y < MAP_GRID_HEIGHT; y++) {
+        for (int x = 0; x < MAP_GRID_WIDTH; x++) {
+            uint16_t cell = y * MAP_GRID_WIDTH + x;
+            if ((grid->valid[y] >> x) & 1) {
+                grid->snap[y][x] = cell;
+                queue[tail++] = cell;
+            } else {
+                grid->snap[y][x] = MAP_GRID_NO_SNAP;
+            }
+        }
+    }
+
+    while (head < tail) {
+        uint16_t cell = queue[head++];
+        int cx = cell % MAP_GRID_WIDTH;
+        int cy = cell / MAP_GRID_WIDTH;
+        uint16_t target = grid->snap[cy][cx];
+
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                int nx = cx + dx, ny = cy + dy;
+                if (!in_bounds(nx, ny) || grid->snap[ny][nx] != MAP_GRID_NO_SNAP) continue;
+                grid->snap[ny][nx] = target;
+                queue[tail++] = ny * MAP_GRID_WIDTH + nx;
+            }
+        }
+    }
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void map_grid_build(MapGrid* grid,
+                    const MapPoint* path, uint8_t path_length,
+                    const Decoration* decorations, uint8_t decoration_count) {
+    memset(grid, 0, sizeof(MapGrid));
+
+    for (int i = 0; i + 1 < path_length; i++) {
+        rasterize_segment(grid->path, path[i], path[i + 1]);
+    }
+    memcpy(grid->blocked, grid->path, sizeof(grid->blocked));
+
+    for (int i = 0; i < decoration_count; i++) {
+        rasterize_decoration(grid->blocked, &decorations[i]);
+    }
+
+    build_path_distance(grid);
+    build_valid(grid);
+    build_snap(grid);
+}
+
+void map_grid_add_tower(MapGrid* grid, int16_t x, int16_t y) {
+    int r = TOWER_FOOTPRINT_RADIUS;
+    fill_rect(grid->blocked, x - r, y - r, 2 * r + 1, 2 * r + 1);
+
+    build_valid(grid);
+    build_snap(grid);
+}
+
+bool map_grid_can_place(const MapGrid* grid, int16_t x, int16_t y) {
+    if (!in_bounds(x, y)) return false;
+    return (grid->valid[y] >> x) & 1;
+}
+
+bool map_grid_snap(const MapGrid* grid, int16_t* x, int16_t* y) {
+    int cx = (*x < 0) ? 0 : (*x >= MAP_GRID_WIDTH) ? MAP_GRID_WIDTH - 1 : *x;
+    int cy = (*y < 0) ? 0 : (*y >= MAP_GRID_HEIGHT) ? MAP_GRID_HEIGHT - 1 : *y;
+
+    uint16_t cell = grid->snap[cy][cx];
+    if (cell == MAP_GRID_NO_SNAP) return false;
+
+    *x = cell % MAP_GRID_WIDTH;
+    *y = cell / MAP_GRID_WIDTH;
+    return true;
+}
+
+uint16_t map_grid_path_coverage(const MapGrid* grid, int16_t x, int16_t y, float range) {
+    if (!in_bounds(x, y)) return 0;
+
+    // Nothing in reach, skip the row scan. Distance is in half pixels and
+    // the 2/3 chamfer never reads short, but up to ~12% long near a 1:2
+    // slope (sqrt(1.25)), so allow 2 * 1.118 per pixel of range
+    if (grid->path_dist[y][x] > 2.25f * range + 1.0f) return 0;
+
+    int r = (int)range;
+    int r2 = (int)(range * range);
+    uint16_t count = 0;
+
+    for (int dy = -r; dy <= r; dy++) {
+        int py = y + dy;
+        if (py < 0 || py >= MAP_GRID_HEIGHT) continue;
+
+        // Half-width of the disc on this row
+        int w = 0;
+        while ((w + 1) * (w + 1) + dy * dy <= r2) w++;
+
+        int x0 = (x - w < 0) ? 0 : x - w;
+        int x1 = (x + w >= MAP_GRID_WIDTH) ? MAP_GRID_WIDTH - 1 : x + w;
+        uint64_t span = x1 - x0 + 1;
+        uint64_t mask = (span == 64) ? ~0ull : ((1ull << span) - 1) << x0;
+
+        count += __builtin_popcountll(grid->path[py] & mask);
+    }
+    return count;
+}
@@ -0,0 +1,66 @@
+// map_grid.h - Precomputed placement and path-distance grids
+#ifndef MAP_GRID_H
+#define MAP_GRID_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// One uint64_t per row, so the map must be exactly 64 wide
+#define MAP_GRID_WIDTH 64
+#define MAP_GRID_HEIGHT 32
+
+#define MAP_GRID_NO_SNAP 0xFFFF
+
+// Towers cover a 3x3 square around their center
+#define TOWER_FOOTPRINT_RADIUS 1
+
+typedef struct {
+    int16_t x;
+    int16_t y;
+} MapPoint;
+
+typedef enum {
+    DECORATION_TREE,
+    DECORATION_ROCK,
+    DECORATION_LAKE
+} DecorationType;
+
+typedef struct {
+    DecorationType type;
+    int16_t x, y;
+} Decoration;
+
+// Built once at map load, patched as towers go down. Bit x of row y is
+// pixel (x, y)
+typedef struct {
+    uint64_t path[MAP_GRID_HEIGHT];      // 3-wide path pixels
+    uint64_t blocked[MAP_GRID_HEIGHT];   // path, decorations and towers
+    uint64_t valid[MAP_GRID_HEIGHT];     // centers where a whole footprint is free
+
+    // Distance to the nearest path pixel in half pixels (chamfer 2/3),
+    // saturates at 255
+    uint8_t path_dist[MAP_GRID_HEIGHT][MAP_GRID_WIDTH];
+
+    // Nearest valid center as y * 64 + x, MAP_GRID_NO_SNAP if none
+    uint16_t snap[MAP_GRID_HEIGHT][MAP_GRID_WIDTH];
+} MapGrid;
+
+// Rasterize path, decorations and towers and build every table
+void map_grid_build(MapGrid* grid,
+                    const MapPoint* path, uint8_t path_length,
+                    const Decoration* decorations, uint8_t decoration_count);
+
+// Mark a new tower's footprint as blocked and refresh valid/snap
+void map_grid_add_tower(MapGrid* grid, int16_t x, int16_t y);
+
+// O(1): true if a tower centered at (x, y) fits
+bool map_grid_can_place(const MapGrid* grid, int16_t x, int16_t y);
+
+// Move (x, y) to the nearest center where a tower fits.
+// Returns false (and leaves x, y alone) if the map is full
+bool map_grid_snap(const MapGrid* grid, int16_t* x, int16_t* y);
+
+// Number of path pixels within 'range' of (x, y), for the placement preview
+uint16_t map_grid_path_coverage(const MapGrid* grid, int16_t x, int16_t y, float range);
+
+#endif // MAP_GRID_H
@@ -0,0 +1,175 @@
+// particle.cpp - Sparks, explosions and death bursts
+#include "particle.h"
+#include "../lib/matrix/matrix.h"
+#include <string.h>
+
+static_assert((MAX_PARTICLES & (MAX_PARTICLES - 1)) == 0, "MAX_PARTICLES must be a power of two");
+#define PARTICLE_MASK (MAX_PARTICLES - 1)
+
+// ============================================================================
+// EMITTER TABLE
+// ============================================================================
+
+const ParticleEmitterStats PARTICLE_EMITTER_TABLE[PARTICLE_EMITTER_COUNT] = {
+    // PARTICLE_HIT
+    {
+        .count = 3,
+        .speed_min = 6,
+        .speed_max = 14,
+        .lifetime_ms = 150,
+        .gravity = false,
+        .use_source_color = true,
+        .r = 0, .g = 0, .b = 0
+    },
+    // PARTICLE_EXPLOSION
+    {
+        .count = 20,
+        .speed_min = 3,
+        .speed_max = 8,
+        .lifetime_ms = 450,
+        .gravity = false,
+        .use_source_color = false,
+        .r = 255, .g = 120, .b = 0
+    },
+    // PARTICLE_DEATH
+    {
+        .count = 8,
+        .speed_min = 4,
+        .speed_max = 12,
+        .lifetime_ms = 350,
+        .gravity = true,
+        .use_source_color = true,
+        .r = 0, .g = 0, .b = 0
+    }
+};
+
+// Pixels per second squared, in 8.8
+#define PARTICLE_GRAVITY (30 * 256)
+
+// Longest step integrated at once, keeps the fixed point products in range
+#define PARTICLE_MAX_DT 0.25f
+
+// cos(i * 22.5 degrees) * 256, sin is the same table 4 steps on
+static const int16_t DIRECTION_COS[PARTICLE_DIRECTIONS + PARTICLE_DIRECTIONS / 4] = {
+     256,  237,  181,   98,    0,  -98, -181, -237,
+    -256, -237, -181,  -98,    0,   98,  181,  237,
+     256,  237,  181,   98
+};
+
+static uint32_t next_random(ParticleSystem* ps) {
+    ps->rng ^= ps->rng << 13;
+    ps->rng ^= ps->rng >> 17;
+    ps->rng ^= ps->rng << 5;
+    return ps->rng;
+}
+
+static uint16_t pack_rgb565(uint8_t r, uint8_t g, uint8_t b) {
+    return (uint16_t)(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+}
+
+// ============================================================================
+// EMISSION
+// ============================================================================
+
+void particles_init(ParticleSystem* ps) {
+    memset(ps, 0, sizeof(ParticleSystem));
+    ps->rng = 0x2545F491;
+}
+
+void particles_emit(ParticleSystem* ps, ParticleEmitter type, float x, float y,
+                    uint8_t r, uint8_t g, uint8_t b, float scale) {
+    if (x < 0.0f || x >= MATRIX_COLS || y < 0.0f || y >= MATRIX_ROWS) return;
+
+    const ParticleEmitterStats* stats = &PARTICLE_EMITTER_TABLE[type];
+    uint16_t color = stats->use_source_color ? pack_rgb565(r, g, b)
+                                             : pack_rgb565(stats->r, stats->g, stats->b);
+    int16_t fx = (int16_t)(x * 256.0f);
+    int16_t fy = (int16_t)(y * 256.0f);
+    int speed_range = stats->speed_max - stats->speed_min + 1;
+
+    for (int i = 0; i < stats->count; i++) {
+        uint32_t random = next_random(ps);
+
+        Particle* p;
+        if (ps->count < MAX_PARTICLES) {
+            p = &ps->pool[(ps->head + ps->count) & PARTICLE_MASK];
+            ps->count++;
+        } else {
+            // Full, the oldest makes room
+            p = &ps->pool[ps->head];
+            ps->head = (ps->head + 1) & PARTICLE_MASK;
+            ps->overwritten++;
+        }
+
+        int direction = random & (PARTICLE_DIRECTIONS - 1);
+        int speed = (int)((stats->speed_min + (int)((random >> 4) % speed_range)) * scale);
+        if (speed > 127) speed = 127;
+
+        p->x = fx;
+        p->y = fy;
+        p->vx = (int16_t)(DIRECTION_COS[direction] * speed);
+        p->vy = (int16_t)(DIRECTION_COS[direction + PARTICLE_DIRECTIONS / 4] * speed);
+        // 75% to 100% of the emitter's lifetime, so a burst thins out
+        p->lifetime_ms = stats->lifetime_ms;
+        p->life_ms = stats->lifetime_ms - (uint16_t)((random >> 12) % (stats->lifetime_ms / 4 + 1));
+        p->color = color;
+        p->gravity = stats->gravity;
+    }
+}
+
+// ============================================================================
+// UPDATE & DRAW
+// ============================================================================
+
+void particles_update(ParticleSystem* ps, float dt) {
+    if (dt > PARTICLE_MAX_DT) dt = PARTICLE_MAX_DT;
+    int32_t dt_q16 = (int32_t)(dt * 65536.0f);
+    uint16_t dt_ms = (uint16_t)((dt_q16 * 1000) >> 16);
+    int32_t gravity_step = (PARTICLE_GRAVITY * dt_q16) >> 16;
+
+    // Survivors slide down to stay packed behind head, oldest first
+    uint16_t kept = 0;
+    for (uint16_t i = 0; i < ps->count; i++) {
+        Particle p = ps->pool[(ps->head + i) & PARTICLE_MASK];
+        if (p.life_ms <= dt_ms) continue;
+        p.life_ms -= dt_ms;
+
+        int32_t x = p.x + ((p.vx * dt_q16) >> 16);
+        int32_t y = p.y + ((p.vy * dt_q16) >> 16);
+        if (x < 0 || x >= (MATRIX_COLS << 8) || y < 0 || y >= (MATRIX_ROWS << 8)) continue;
+        p.x = (int16_t)x;
+        p.y = (int16_t)y;
+        if (p.gravity) {
+            int32_t vy = p.vy + gravity_step;
+            p.vy = (int16_t)(vy > INT16_MAX ? INT16_MAX : vy);
+        }
+
+        ps->pool[(ps->head + kept) & PARTICLE_MASK] = p;
+        kept++;
+    }
+    ps->count = kept;
+}
+
+uint16_t particles_snapshot(const ParticleSystem* ps, ParticleSpark* out) {
+    for (uint16_t i = 0; i < ps->count; i++) {
+        const Particle* p = &ps->pool[(ps->head + i) & PARTICLE_MASK];
+        ParticleSpark* spark = &out[i];
+
+        // update() only keeps particles on the matrix
+        spark->x = (uint8_t)(p->x >> 8);
+        spark->y = (uint8_t)(p->y >> 8);
+
+        uint32_t fade = ((uint32_t)p->life_ms << 8) / p->lifetime_ms;
+        spark->r = (uint8_t)((((p->color >> 11) & 0x1F) << 3) * fade >> 8);
+        spark->g = (uint8_t)((((p->color >> 5) & 0x3F) << 2) * fade >> 8);
+        spark->b = (uint8_t)(((p->color & 0x1F) << 3) * fade >> 8);
+    }
+    return ps->count;
+}
+
+void particles_draw(const ParticleSpark* sparks, uint16_t count, DisplayList* list) {
+    for (uint16_t i = 0; i < count; i++) {
+        const ParticleSpark* spark = &sparks[i];
+        dl_blend(list, spark->x, spark->y, Color{spark->r, spark->g, spark->b});
+    }
+}
@@ -0,0 +1,76 @@
+// particle.h - Sparks, explosions and death bursts
+#ifndef PARTICLE_H
+#define PARTICLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "display_list.h"
+
+#define MAX_PARTICLES 512
+#define PARTICLE_DIRECTIONS 16
+
+typedef enum {
+    PARTICLE_HIT,            // Projectile impact
+    PARTICLE_EXPLOSION,      // Splash and bomb blasts
+    PARTICLE_DEATH,          // Enemy killed
+    PARTICLE_EMITTER_COUNT
+} ParticleEmitter;
+
+typedef struct {
+    uint8_t count;           // Particles per burst
+    uint8_t speed_min;       // Pixels per second
+    uint8_t speed_max;
+    uint16_t lifetime_ms;
+    bool gravity;            // Debris falls, sparks don't
+    bool use_source_color;   // Take the color of what was hit
+    uint8_t r, g, b;         // Otherwise this
+} ParticleEmitterStats;
+
+// 16 bytes. Position in 8.8 fixed point pixels, velocity in 8.8 pixels
+// per second, color in RGB565. Brightness fades with life / lifetime
+typedef struct {
+    int16_t x, y;
+    int16_t vx, vy;
+    uint16_t life_ms;        // Left, 0 = dead
+    uint16_t lifetime_ms;
+    uint16_t color;
+    uint8_t gravity;
+    uint8_t pad;
+} Particle;
+
+// What a frame draws of a particle, already faded
+typedef struct {
+    uint8_t x, y;
+    uint8_t r, g, b;
+} ParticleSpark;
+
+// Ring buffer, oldest first. Live particles are pool[head] onward,
+// 'count' of them wrapping at MAX_PARTICLES. A burst into a full pool
+// overwrites the oldest, so emitting never fails and never stalls
+typedef struct {
+    Particle pool[MAX_PARTICLES];
+    uint16_t head;
+    uint16_t count;
+    uint32_t rng;
+    uint16_t overwritten;    // Particles cut short by a full pool
+} ParticleSystem;
+
+extern const ParticleEmitterStats PARTICLE_EMITTER_TABLE[PARTICLE_EMITTER_COUNT];
+
+void particles_init(ParticleSystem* ps);
+
+// Burst of 'type' at (x, y). 'r, g, b' is the source color for emitters
+// that use it, 'scale' multiplies the speed (splash radius for blasts)
+void particles_emit(ParticleSystem* ps, ParticleEmitter type, float x, float y,
+                    uint8_t r, uint8_t g, uint8_t b, float scale);
+
+// Move, age and drop dead particles, keeping the pool packed
+void particles_update(ParticleSystem* ps, float dt);
+
+// Fade the live particles into 'out' (MAX_PARTICLES long), returns the count
+uint16_t particles_snapshot(const ParticleSystem* ps, ParticleSpark* out);
+
+// Record a saturating additive blend of each spark
+void particles_draw(const ParticleSpark* sparks, uint16_t count, DisplayList* list);
+
+#endif // PARTICLE_H
@@ -0,0 +1,97 @@
+// snapshot.cpp - Copy out what a frame draws, and draw it
+#include "game_types.h"
+#include <string.h>
+
+// ============================================================================
+// SNAPSHOT (simulation side, end of tick)
+// ============================================================================
+
+static void add_unit(DrawSnapshot* snap, float fx, float fy, Color color) {
+    int x = (int)fx;
+    int y = (int)fy;
+    if (x < 0 || x >= MATRIX_WIDTH || y < 0 || y >= MATRIX_HEIGHT) return;
+
+    snap->units[snap->unit_count++] = {(uint8_t)x, (uint8_t)y, color};
+}
+
+void game_snapshot(const GameState* game, DrawSnapshot* snap) {
+    snap->game_time = game->game_time;
+
+    // Map layer, only changes at load and tower placement but is small
+    snap->path_length = game->path_length;
+    memcpy(snap->path, game->path, game->path_length * sizeof(MapPoint));
+    snap->decoration_count = game->decoration_count;
+    memcpy(snap->decorations, game->decorations, game->decoration_count * sizeof(Decoration));
+    snap->tower_slot_count = game->tower_slot_count;
+    memcpy(snap->tower_slots, game->tower_slots, game->tower_slot_count * sizeof(TowerSlot));
+
+    snap->tower_count = game->tower_count;
+    memcpy(snap->towers, game->towers, game->tower_count * sizeof(Tower));
+
+    snap->unit_count = 0;
+    for (int i = 0; i < game->enemy_count; i++) {
+        const Enemy* enemy = &game->enemies[i];
+        if (!enemy->alive) continue;
+
+        // Ghost enemies are barely visible
+        if (enemy->invisible && !enemy->revealed) {
+            Color ghost_color = {(uint8_t)(enemy->color.r / 8), (uint8_t)(enemy->color.g / 8),
+                                 (uint8_t)(enemy->color.b / 4)};
+            add_unit(snap, enemy->x, enemy->y, ghost_color);
+        } else {
+            add_unit(snap, enemy->x, enemy->y, enemy->color);
+        }
+    }
+    for (int i = 0; i < game->projectile_count; i++) {
+        const Projectile* proj = &game->projectiles[i];
+        if (proj->active) add_unit(snap, proj->x, proj->y, proj->color);
+    }
+
+    snap->spark_count = particles_snapshot(&game->particles, snap->sparks);
+    snap->abilities = game->abilities;
+    snap->banner = game->banner;
+}
+
+// ============================================================================
+// DRAWING (raster side, reads only the snapshot)
+// ============================================================================
+
+void snapshot_draw(const DrawSnapshot* snap, DisplayList* list) {
+    // Draw path
+    for (int i = 0; i < snap->path_length; i++) {
+        dl_pixel(list, snap->path[i].x, snap->path[i].y, Color{100, 100, 100});
+    }
+
+    // Draw decorations
+    for (int i = 0; i < snap->decoration_count; i++) {
+        decoration_draw(&snap->decorations[i], list);
+    }
+
+    // Draw tower slots
+    for (int i = 0; i < snap->tower_slot_count; i++) {
+        int x = snap->tower_slots[i].x;
+        int y = snap->tower_slots[i].y;
+        Color slot_color = snap->tower_slots[i].occupied ?
+                           Color{60, 50, 0} : Color{128, 107, 0};
+
+        dl_rect(list, x - 2, y - 2, 4, 4, slot_color);
+    }
+
+    // Draw towers
+    for (int i = 0; i < snap->tower_count; i++) {
+        tower_draw(&snap->towers[i], list);
+    }
+
+    // Enemies and projectiles, clipped when the snapshot was taken
+    for (int i = 0; i < snap->unit_count; i++) {
+        const SnapshotPixel* unit = &snap->units[i];
+        dl_pixel(list, unit->x, unit->y, unit->color);
+    }
+
+    // Effects blend over the ground units
+    particles_draw(snap->sparks, snap->spark_count, list);
+
+    // Aircraft fly over everything
+    abilities_draw(&snap->abilities, snap->game_time, list);
+    banner_draw(&snap->banner, snap->game_time, list);
+}
@@ -1,17 +1,71 @@
 // src/main.cpp - Main game loop for RP2350
 #include <stdio.h>
 #include "pico/stdlib.h"
+#include "pico/multicore.h"
 #include "hardware/gpio.h"
 
 // Project includes
 #include "../lib/matrix/matrix.h"
 #include "../lib/joystick/joystick.h"
 #include "game_types.h"
+#include "dl_capture.h"
+#include "../../lib/maps/map_blob.hh"
+#include "../../lib/log/log.hh"
+#include "../../lib/usb/usb_command.hh"
 
 // Game state
 GameState game;
 uint32_t last_time_ms = 0;
 
+// ~30 FPS. Core0 simulates tick N+1 while core1 draws tick N from its
+// snapshot, so a frame costs max(sim, draw) instead of the sum
+#define FRAME_US 33333
+#define STATS_FRAMES 150         // Print stage timings every ~5 s
+
+// Core0 fills one while core1 draws the other. Indices go to core1
+// through the FIFO and come back when it has finished drawing
+DrawSnapshot snapshots[2];
+uint8_t snapshots_unused = 2;    // Never handed over yet
+
+// Stage timings, each written only by the core running that stage
+typedef struct {
+    uint32_t frames;
+    uint32_t total_us;
+    uint32_t max_us;
+} StageStats;
+
+volatile StageStats sim_stats;
+volatile StageStats draw_stats;      // Recording the display list
+volatile StageStats execute_stats;   // Rasterizing it
+uint32_t sim_wait_us = 0;            // Core0 blocked on a snapshot in use
+
+// Core1 records each frame here, then executes it into the framebuffer
+DisplayList frame_list;
+
+typedef struct {
+    uint32_t commands;
+    uint16_t max_commands;
+    uint32_t culled;
+    uint32_t merged;
+    uint32_t dropped;
+} ListStats;
+
+volatile ListStats list_stats;
+
+void stage_record(volatile StageStats* stats, uint32_t us) {
+    stats->frames++;
+    stats->total_us += us;
+    if (us > stats->max_us) stats->max_us = us;
+}
+
+void list_record(const DisplayListStats* frame) {
+    list_stats.commands += frame->commands;
+    if (frame->commands > list_stats.max_commands) list_stats.max_commands = frame->commands;
+    list_stats.culled += frame->culled;
+    list_stats.merged += frame->merged;
+    list_stats.dropped += frame->dropped;
+}
+
 // Input state
 TowerType current_tower_selection = TOWER_MACHINE_GUN;
 bool button_pressed_last_frame = false;
@@ -24,10 +78,9 @@ void setup() {
     joystick_init();
 
     // Initialize game
+    if (!map_blob_init()) printf("Map data is corrupt\n");
     game_init(&game);
-
-    // Spawn some test enemies
-    game_spawn_enemy(&game, ENEMY_SCOUT);
+    dl_capture_init();
 
     printf("Tower Defense Game Started!\n");
     printf("Controls:\n");
@@ -47,9 +100,9 @@ void handle_input() {
                              current_tower_selection,
                              game.tower_slots[0].x,
                              game.tower_slots[0].y)) {
-            printf("Placed tower! Money: %d\n", game.money);
+            LOG("Placed tower! Money: %d", game.money);
         } else {
-            printf("Cannot place tower (money/slot)\n");
+            LOG("Cannot place tower (money/slot)");
         }
     }
 
@@ -65,93 +118,115 @@ void update_game() {
 
     game_update(&game, dt);
 
-    // Simple periodic spawner for testing
-    static float spawn_timer = 0.0f;
-    spawn_timer += dt;
-    if (spawn_timer > 3.0f) {
-        if (game.enemy_count < MAX_ENEMIES) {
-            game_spawn_enemy(&game, ENEMY_SCOUT);
-            printf("Spawned enemy. Total: %d\n", game.enemy_count);
-        }
-        spawn_timer = 0.0f;
+    // Starts the next wave when its banner has flown past
+    uint8_t wave = game.wave_number;
+    game_update_wave(&game, dt);
+    if (game.wave_number != wave) {
+        LOG("Wave %d of %d", game.wave_number, game.total_waves);
     }
 }
 
-void render_game() {
+void render_game(const DrawSnapshot* snap) {
+    dl_begin(&frame_list);
+
     // Clear background to grass
-    for (int y = 0; y < MATRIX_ROWS; y++) {
-        for (int x = 0; x < MATRIX_COLS; x++) {
-            framebuffer[y][x] = GRASS;
-        }
-    }
+    dl_clear(&frame_list, GRASS);
 
-    // Draw game objects into framebuffer
-    game_draw(&game);
+    // Record game objects into the frame's display list
+    snapshot_draw(snap, &frame_list);
 }
 
-int main() {
-    setup();
-
-    last_time_ms = to_ms_since_boot(get_absolute_time());
-
-    // Main game loop: input -> update -> draw -> display
+// Core1: record each snapshot as it arrives, hand it back, execute the
+// list into the framebuffer, keep scanning
+void raster_loop() {
+    uint16_t frame = 0;
     while (true) {
-        handle_input();
-        update_game();
-        render_game();  // fills framebuffer
-        render();       // your fixed matrix.c: renders ONE frame
-        sleep_ms(33);   // ~30 FPS
-    }
+        if (multicore_fifo_rvalid()) {
+            uint32_t index = multicore_fifo_pop_blocking();
 
-    return 0;
-}
+            uint64_t start = time_us_64();
+            render_game(&snapshots[index]);
+            uint64_t recorded = time_us_64();
 
-/*
-===============================================================================
-ALTERNATIVE APPROACH (if you ever move game loop into matrix.c):
+            // The list holds everything the frame needs, the snapshot is free
+            multicore_fifo_push_blocking(index);
 
-typedef void (*FrameCallback)(void);
-void render_with_callback(FrameCallback callback);
-
-void game_frame() {
-    handle_input();
-    update_game();
-    render_game();
-}
+            uint64_t executing = time_us_64();
+            dl_execute(&frame_list);
+            uint64_t done = time_us_64();
 
-int main() {
-    setup();
-    last_time_ms = to_ms_since_boot(get_absolute_time());
-    render_with_callback(game_frame);
-    return 0;
+            stage_record(&draw_stats, (uint32_t)(recorded - start));
+            stage_record(&execute_stats, (uint32_t)(done - executing));
+            list_record(&frame_list.stats);
+            dl_capture_frame(&frame_list, frame++);
+        }
+        render();       // one scan of the framebuffer the last list drew
+    }
 }
-*/
 
-/*
-Python version = “full PC game prototype”
+// A snapshot core1 is not reading. Waits only if it is a whole frame behind
+uint32_t free_snapshot(uint32_t* waited_us) {
+    *waited_us = 0;
+    if (snapshots_unused > 0) return --snapshots_unused;
 
-    Multiple waves with proper progression.
-
-    Map loaded from JSON with decorations and configurable path/slots/waves.
-
-    Special abilities (Apache, bomber).
-
-    Banner plane between rounds.
+    uint64_t start = time_us_64();
+    uint32_t index = multicore_fifo_pop_blocking();
+    *waited_us = (uint32_t)(time_us_64() - start);
+    return index;
+}
 
-    Full splitter behavior.
+void print_stage_stats() {
+    printf("sim  mean %u us, max %u us, waited %u us\n",
+           sim_stats.total_us / sim_stats.frames, sim_stats.max_us, sim_wait_us);
+    if (draw_stats.frames) {
+        uint32_t frames = draw_stats.frames;
+        printf("draw mean %u us, max %u us, %u of %u frames drawn\n",
+               draw_stats.total_us / frames, draw_stats.max_us, frames, sim_stats.frames);
+        printf("exec mean %u us, max %u us\n",
+               execute_stats.total_us / frames, execute_stats.max_us);
+        printf("list mean %u commands, max %u (%u bytes), per frame %u culled, %u merged, %u dropped\n",
+               list_stats.commands / frames, list_stats.max_commands,
+               DL_HEADER_SIZE + list_stats.max_commands * DL_COMMAND_SIZE,
+               list_stats.culled / frames, list_stats.merged / frames, list_stats.dropped / frames);
+    }
 
-    More UI feedback (tower ranges, wave info, etc.).
+    // Can lose one of core1's frames to the race, fine for a printout
+    sim_stats.frames = sim_stats.total_us = sim_stats.max_us = 0;
+    draw_stats.frames = draw_stats.total_us = draw_stats.max_us = 0;
+    execute_stats.frames = execute_stats.total_us = execute_stats.max_us = 0;
+    list_stats.commands = list_stats.max_commands = 0;
+    list_stats.culled = list_stats.merged = list_stats.dropped = 0;
+    sim_wait_us = 0;
+}
 
-C++ version (now) = “core mechanics port for embedded hardware”
+int main() {
+    setup();
 
-Same basic enemy + tower types and rules.
+    last_time_ms = to_ms_since_boot(get_absolute_time());
+    multicore_launch_core1(raster_loop);
 
-Same idea of invisible/ghost enemies + radar towers.
+    // Core0: input -> update -> snapshot -> hand to core1
+    absolute_time_t next_frame = get_absolute_time();
+    while (true) {
+        uint64_t start = time_us_64();
+        handle_input();
+        update_game();
 
-Same concept of projectiles, splash damage, money/lives.
+        uint32_t waited_us;
+        uint32_t index = free_snapshot(&waited_us);
+        game_snapshot(&game, &snapshots[index]);
+        stage_record(&sim_stats, (uint32_t)(time_us_64() - start) - waited_us);
+        sim_wait_us += waited_us;
+        multicore_fifo_push_blocking(index);
 
-Simpler spawn logic (continuous, not wave-based).
+        if (sim_stats.frames >= STATS_FRAMES) print_stage_stats();
+        usb_command_poll();
+        log_drain();
+        dl_capture_poll();
 
-No abilities, no banner plane, no JSON map loading, no split-child spawning yet.
+        next_frame = delayed_by_us(next_frame, FRAME_US);
+        sleep_until(next_frame);
+    }
 
-Much simpler visuals and controls.*/
+    return 0;
+}
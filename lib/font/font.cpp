@@ -0,0 +1,617 @@
+#include "font.hh"
+
+// ====== 3x5 ======
+
+static constexpr GlyphArt SMALL_ART[] = {
+    {' ', "..."
+          "..."
+          "..."
+          "..."
+          "..."},
+    {'.', "..."
+          "..."
+          "..."
+          "..."
+          ".#."},
+    {',', "..."
+          "..."
+          "..."
+          "..."
+          ".#."},
+    {'(', ".#."
+          "#.."
+          "#.."
+          "#.."
+          ".#."},
+    {')', ".#."
+          "..#"
+          "..#"
+          "..#"
+          ".#."},
+    {'\'', ".#."
+           "..."
+           "..."
+           "..."
+           "..."},
+    {'-', "..."
+          "..."
+          "###"
+          "..."
+          "..."},
+    {'/', "..#"
+          ".##"
+          ".#."
+          "##."
+          "#.."},
+    {'\\', "#.."
+           "##."
+           ".#."
+           ".##"
+           "..#"},
+    {'!', ".#."
+          ".#."
+          ".#."
+          "..."
+          ".#."},
+    {'$', "###"
+          "#.."
+          "###"
+          "..#"
+          "###"},
+    {':', "..."
+          ".#."
+          "..."
+          ".#."
+          "..."},
+    {'|', ".#."
+          ".#."
+          ".#."
+          ".#."
+          ".#."},
+    {'<', "..#"
+          ".#."
+          "#.."
+          ".#."
+          "..#"},
+    {'>', "#.."
+          ".#."
+          "..#"
+          ".#."
+          "#.."},
+    {'+', "..."
+          ".#."
+          "###"
+          ".#."
+          "..."},
+    {'%', "#.#"
+          "..#"
+          ".#."
+          "#.."
+          "#.#"},
+    {'0', "###"
+          "#.#"
+          "#.#"
+          "#.#"
+          "###"},
+    {'1', ".#."
+          "##."
+          ".#."
+          ".#."
+          "###"},
+    {'2', "###"
+          "..#"
+          "###"
+          "#.."
+          "###"},
+    {'3', "###"
+          "..#"
+          ".##"
+          "..#"
+          "###"},
+    {'4', "#.#"
+          "#.#"
+          "###"
+          "..#"
+          "..#"},
+    {'5', "###"
+          "#.."
+          "###"
+          "..#"
+          "###"},
+    {'6', "###"
+          "#.."
+          "###"
+          "#.#"
+          "###"},
+    {'7', "###"
+          "..#"
+          "..#"
+          ".#."
+          ".#."},
+    {'8', "###"
+          "#.#"
+          "###"
+          "#.#"
+          "###"},
+    {'9', "###"
+          "#.#"
+          "###"
+          "..#"
+          "..#"},
+    {'a', ".#."
+          "#.#"
+          "###"
+          "#.#"
+          "#.#"},
+    {'b', "##."
+          "#.#"
+          "##."
+          "#.#"
+          "##."},
+    {'c', "###"
+          "#.."
+          "#.."
+          "#.."
+          "###"},
+    {'d', "##."
+          "#.#"
+          "#.#"
+          "#.#"
+          "##."},
+    {'e', "###"
+          "#.."
+          "##."
+          "#.."
+          "###"},
+    {'f', "###"
+          "#.."
+          "##."
+          "#.."
+          "#.."},
+    {'g', ".##"
+          "#.."
+          "#.."
+          "#.#"
+          ".##"},
+    {'h', "#.#"
+          "#.#"
+          "###"
+          "#.#"
+          "#.#"},
+    {'i', "###"
+          ".#."
+          ".#."
+          ".#."
+          "###"},
+    {'j', "..#"
+          "..#"
+          "..#"
+          "#.#"
+          "###"},
+    {'k', "#.#"
+          "#.#"
+          "##."
+          "#.#"
+          "#.#"},
+    {'l', "#.."
+          "#.."
+          "#.."
+          "#.."
+          "###"},
+    {'m', "#.#"
+          "###"
+          "#.#"
+          "#.#"
+          "#.#"},
+    {'n', "###"
+          "#.#"
+          "#.#"
+          "#.#"
+          "#.#"},
+    {'o', "###"
+          "#.#"
+          "#.#"
+          "#.#"
+          "###"},
+    {'p', "###"
+          "#.#"
+          "###"
+          "#.."
+          "#.."},
+    {'q', "###"
+          "#.#"
+          "#.#"
+          "##."
+          "..#"},
+    {'r', "###"
+          "#.#"
+          "##."
+          "#.#"
+          "#.#"},
+    {'s', "###"
+          "#.."
+          "###"
+          "..#"
+          "###"},
+    {'t', "###"
+          ".#."
+          ".#."
+          ".#."
+          ".#."},
+    {'u', "#.#"
+          "#.#"
+          "#.#"
+          "#.#"
+          "###"},
+    {'v', "#.#"
+          "#.#"
+          "#.#"
+          "#.#"
+          ".#."},
+    {'w', "#.#"
+          "#.#"
+          "#.#"
+          "###"
+          "#.#"},
+    {'x', "#.#"
+          "#.#"
+          ".#."
+          "#.#"
+          "#.#"},
+    {'y', "#.#"
+          "#.#"
+          "###"
+          ".#."
+          ".#."},
+    {'z', "###"
+          "..#"
+          ".#."
+          "#.."
+          "###"},
+};
+
+// ====== 5x7 ======
+
+static constexpr GlyphArt LARGE_ART[] = {
+    {'0', ".###."
+          "#...#"
+          "#..##"
+          "#.#.#"
+          "##..#"
+          "#...#"
+          ".###."},
+    {'1', "..#.."
+          ".##.."
+          "..#.."
+          "..#.."
+          "..#.."
+          "..#.."
+          ".###."},
+    {'2', ".###."
+          "#...#"
+          "....#"
+          "...#."
+          "..#.."
+          ".#..."
+          "#####"},
+    {'3', "#####"
+          "...#."
+          "..#.."
+          "...#."
+          "....#"
+          "#...#"
+          ".###."},
+    {'4', "...#."
+          "..##."
+          ".#.#."
+          "#..#."
+          "#####"
+          "...#."
+          "...#."},
+    {'5', "#####"
+          "#...."
+          "####."
+          "....#"
+          "....#"
+          "#...#"
+          ".###."},
+    {'6', "..##."
+          ".#..."
+          "#...."
+          "####."
+          "#...#"
+          "#...#"
+          ".###."},
+    {'7', "#####"
+          "....#"
+          "...#."
+          "..#.."
+          ".#..."
+          ".#..."
+          ".#..."},
+    {'8', ".###."
+          "#...#"
+          "#...#"
+          ".###."
+          "#...#"
+          "#...#"
+          ".###."},
+    {'9', ".###."
+          "#...#"
+          "#...#"
+          ".####"
+          "....#"
+          "...#."
+          ".##.."},
+    {'A', ".###."
+          "#...#"
+          "#...#"
+          "#...#"
+          "#####"
+          "#...#"
+          "#...#"},
+    {'B', "####."
+          "#...#"
+          "#...#"
+          "####."
+          "#...#"
+          "#...#"
+          "####."},
+    {'C', ".###."
+          "#...#"
+          "#...."
+          "#...."
+          "#...."
+          "#...#"
+          ".###."},
+    {'D', "###.."
+          "#..#."
+          "#...#"
+          "#...#"
+          "#...#"
+          "#..#."
+          "###.."},
+    {'E', "#####"
+          "#...."
+          "#...."
+          "####."
+          "#...."
+          "#...."
+          "#####"},
+    {'F', "#####"
+          "#...."
+          "#...."
+          "####."
+          "#...."
+          "#...."
+          "#...."},
+    {'G', ".###."
+          "#...#"
+          "#...."
+          "#.###"
+          "#...#"
+          "#...#"
+          ".####"},
+    {'H', "#...#"
+          "#...#"
+          "#...#"
+          "#####"
+          "#...#"
+          "#...#"
+          "#...#"},
+    {'I', ".###."
+          "..#.."
+          "..#.."
+          "..#.."
+          "..#.."
+          "..#.."
+          ".###."},
+    {'J', "..###"
+          "...#."
+          "...#."
+          "...#."
+          "...#."
+          "#..#."
+          ".##.."},
+    {'K', "#...#"
+          "#..#."
+          "#.#.."
+          "##..."
+          "#.#.."
+          "#..#."
+          "#...#"},
+    {'L', "#...."
+          "#...."
+          "#...."
+          "#...."
+          "#...."
+          "#...."
+          "#####"},
+    {'M', "#...#"
+          "##.##"
+          "#.#.#"
+          "#.#.#"
+          "#...#"
+          "#...#"
+          "#...#"},
+    {'N', "#...#"
+          "#...#"
+          "##..#"
+          "#.#.#"
+          "#..##"
+          "#...#"
+          "#...#"},
+    {'O', ".###."
+          "#...#"
+          "#...#"
+          "#...#"
+          "#...#"
+          "#...#"
+          ".###."},
+    {'P', "####."
+          "#...#"
+          "#...#"
+          "####."
+          "#...."
+          "#...."
+          "#...."},
+    {'Q', ".###."
+          "#...#"
+          "#...#"
+          "#...#"
+          "#.#.#"
+          "#..#."
+          ".##.#"},
+    {'R', "####."
+          "#...#"
+          "#...#"
+          "####."
+          "#.#.."
+          "#..#."
+          "#...#"},
+    {'S', ".####"
+          "#...."
+          "#...."
+          ".###."
+          "....#"
+          "....#"
+          "####."},
+    {'T', "#####"
+          "..#.."
+          "..#.."
+          "..#.."
+          "..#.."
+          "..#.."
+          "..#.."},
+    {'U', "#...#"
+          "#...#"
+          "#...#"
+          "#...#"
+          "#...#"
+          "#...#"
+          ".###."},
+    {'V', "#...#"
+          "#...#"
+          "#...#"
+          "#...#"
+          "#...#"
+          ".#.#."
+          "..#.."},
+    {'W', "#...#"
+          "#...#"
+          "#...#"
+          "#.#.#"
+          "#.#.#"
+          "#.#.#"
+          ".#.#."},
+    {'X', "#...#"
+          "#...#"
+          ".#.#."
+          "..#.."
+          ".#.#."
+          "#...#"
+          "#...#"},
+    {'Y', "#...#"
+          "#...#"
+          "#...#"
+          ".#.#."
+          "..#.."
+          "..#.."
+          "..#.."},
+    {'Z', "#####"
+          "....#"
+          "...#."
+          "..#.."
+          ".#..."
+          "#...."
+          "#####"},
+    {':', "....."
+          ".##.."
+          ".##.."
+          "....."
+          ".##.."
+          ".##.."
+          "....."},
+    {'.', "....."
+          "....."
+          "....."
+          "....."
+          "....."
+          ".##.."
+          ".##.."},
+    {'-', "....."
+          "....."
+          "....."
+          "#####"
+          "....."
+          "....."
+          "....."},
+    {'!', "..#.."
+          "..#.."
+          "..#.."
+          "..#.."
+          "..#.."
+          "....."
+          "..#.."},
+    {'$', "..#.."
+          ".####"
+          "#.#.."
+          ".###."
+          "..#.#"
+          "####."
+          "..#.."},
+    {'/', "....."
+          "....#"
+          "...#."
+          "..#.."
+          ".#..."
+          "#...."
+          "....."},
+    {'%', "##..."
+          "##..#"
+          "...#."
+          "..#.."
+          ".#..."
+          "#..##"
+          "...##"},
+    {' ', "....."
+          "....."
+          "....."
+          "....."
+          "....."
+          "....."
+          "....."},
+};
+
+#define ART_COUNT(art) (sizeof(art) / sizeof(art[0]))
+
+static_assert(font_art_valid(SMALL_ART, ART_COUNT(SMALL_ART), 3, 5), "3x5 glyph art is the wrong size");
+static_assert(font_art_valid(LARGE_ART, ART_COUNT(LARGE_ART), 5, 7), "5x7 glyph art is the wrong size");
+
+constexpr Font font_small = make_font(SMALL_ART, ART_COUNT(SMALL_ART), 3, 5);
+constexpr Font font_large = make_font(LARGE_ART, ART_COUNT(LARGE_ART), 5, 7);
+
+int text_width(const char *text, const Font *font) {
+    int n = 0;
+    while (text[n]) n++;
+    return n ? n * (font->width + 1) - 1 : 0;
+}
+
+int format_int(char *out, int32_t value, int min_digits) {
+    // Negate as unsigned so INT32_MIN survives
+    uint32_t magnitude = value < 0 ? 0u - (uint32_t)value : (uint32_t)value;
+    if (min_digits > FORMAT_INT_MAX - 2) min_digits = FORMAT_INT_MAX - 2;
+
+    char digits[FORMAT_INT_MAX];
+    int count = 0;
+    do {
+        digits[count++] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude || count < min_digits);
+
+    int n = 0;
+    if (value < 0) out[n++] = '-';
+    while (count) out[n++] = digits[--count];
+    out[n] = '\0';
+    return n;
+}
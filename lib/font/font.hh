@@ -0,0 +1,124 @@
+#ifndef FONT_HH
+#define FONT_HH
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Glyphs cover ' ' through '~', one slot each
+#define FONT_FIRST 32
+#define FONT_GLYPHS 95
+#define FONT_MAX_WIDTH 5
+#define FONT_MAX_HEIGHT 8
+
+// Longest int32 is "-2147483648"
+#define FORMAT_INT_MAX 12
+
+/*  NOTES:
+
+    Glyphs are written as string art in font.cpp, one string per row
+    with '#' for a lit pixel and '.' for an unlit one, so they can be
+    edited by eye. make_font() turns the art into column bitmasks at
+    compile time (bit 0 is the top row), nothing is parsed at boot and
+    the tables sit in flash.
+
+    Drawing walks each column's bits and fills runs of set bits as
+    vertical spans, see draw_text() in matrix.hh.
+
+    Characters with no art are blank. A font that only has art for one
+    letter case uses it for the other case too.
+
+*/
+
+struct Font {
+    uint8_t width;      // columns per glyph
+    uint8_t height;     // rows per glyph
+    uint8_t columns[FONT_GLYPHS][FONT_MAX_WIDTH];
+};
+
+struct GlyphArt {
+    char c;
+    const char *rows;   // width * height of '#' and '.'
+};
+
+constexpr bool font_art_valid(const GlyphArt *art, size_t count, int width, int height) {
+    if (width > FONT_MAX_WIDTH || height > FONT_MAX_HEIGHT) return false;
+
+    for (size_t i = 0; i < count; i++) {
+        if (art[i].c < FONT_FIRST || art[i].c >= FONT_FIRST + FONT_GLYPHS) return false;
+
+        int n = 0;
+        for (const char *p = art[i].rows; *p; p++, n++) {
+            if (*p != '#' && *p != '.') return false;
+        }
+        if (n != width * height) return false;
+    }
+    return true;
+}
+
+constexpr Font make_font(const GlyphArt *art, size_t count, int width, int height) {
+    Font font = {};
+    font.width = width;
+    font.height = height;
+
+    // Explicit art first, then fill the other case where it is missing
+    bool has_art[FONT_GLYPHS] = {};
+    for (size_t i = 0; i < count; i++) {
+        int slot = art[i].c - FONT_FIRST;
+        for (int row = 0; row < height; row++) {
+            for (int col = 0; col < width; col++) {
+                if (art[i].rows[row * width + col] == '#') {
+                    font.columns[slot][col] |= 1 << row;
+                }
+            }
+        }
+        has_art[slot] = true;
+    }
+
+    for (int c = 'a'; c <= 'z'; c++) {
+        int lower = c - FONT_FIRST;
+        int upper = c - 'a' + 'A' - FONT_FIRST;
+        for (int col = 0; col < width; col++) {
+            if (!has_art[upper]) font.columns[upper][col] = font.columns[lower][col];
+            if (!has_art[lower]) font.columns[lower][col] = font.columns[upper][col];
+        }
+    }
+    return font;
+}
+
+/**
+ * @brief 3x5 font, the letters from simulation/letters.py. fits six
+ * lines of sixteen characters on the panel
+ */
+extern const Font font_small;
+
+/**
+ * @brief 5x7 font, for headings and big numbers
+ */
+extern const Font font_large;
+
+/**
+ * @brief column bitmasks of one glyph, bit 0 is the top row
+ *
+ * @return 'width' bytes, blank for characters the font does not have
+ */
+static inline const uint8_t *font_glyph(const Font *font, char c) {
+    uint8_t slot = (uint8_t)(c - FONT_FIRST);
+    if (slot >= FONT_GLYPHS) slot = 0;
+    return font->columns[slot];
+}
+
+/**
+ * @brief width in pixels of 'text', with one blank column between glyphs
+ */
+int text_width(const char *text, const Font *font);
+
+/**
+ * @brief writes the decimal digits of 'value' into 'out', no printf
+ *
+ * @param out at least FORMAT_INT_MAX bytes
+ * @param min_digits pad with leading zeros up to this many digits
+ * @return number of characters written, not counting the terminator
+ */
+int format_int(char *out, int32_t value, int min_digits = 1);
+
+#endif // FONT_HH
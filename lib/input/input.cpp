@@ -0,0 +1,115 @@
+#include <string.h>
+#include "pico/stdlib.h"
+
+#include "input.hh"
+#include "spsc_queue.hh"
+
+struct ButtonItem {
+    uint32_t time_us;
+    bool pressed;
+};
+
+struct StickItem {
+    uint32_t time_us;
+    InputEventType type;
+    JoystickDirection direction;
+};
+
+static SpscQueue<ButtonItem, 16> button_queue;
+static SpscQueue<StickItem, 16> stick_queue;
+static SpscQueue<RfidEvent, 8> rfid_queue;
+static SpscQueue<InputEvent, 16> inject_queue;
+
+void input_post_button(bool pressed, uint32_t time_us) {
+    button_queue.push({time_us, pressed});
+}
+
+void input_post_stick(InputEventType type, JoystickDirection direction, uint32_t time_us) {
+    stick_queue.push({time_us, type, direction});
+}
+
+void input_inject(const InputEvent *event) {
+    InputEvent stamped = *event;
+    stamped.time_us = time_us_32();
+    if (stamped.type == input_tag) stamped.rfid.time_us = stamped.time_us;
+    inject_queue.push(stamped);
+}
+
+uint32_t input_dropped() {
+    return button_queue.dropped + stick_queue.dropped + rfid_queue.dropped +
+           inject_queue.dropped;
+}
+
+// True if a happened before b, works across the 32-bit wrap
+static bool earlier(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) < 0;
+}
+
+enum Head {
+    head_none,
+    head_button,
+    head_stick,
+    head_tag,
+    head_injected,
+};
+
+// Takes 'head' if it happened before the oldest so far
+static void consider(Head *oldest, uint32_t *oldest_us, Head head, uint32_t time_us) {
+    if (*oldest == head_none || earlier(time_us, *oldest_us)) {
+        *oldest = head;
+        *oldest_us = time_us;
+    }
+}
+
+bool input_poll(InputEvent *event) {
+    // The reader is serviced from here, so its ring has this one producer
+    RfidEvent rfid;
+    while (poll_rfid(&rfid)) {
+        rfid_queue.push(rfid);
+    }
+
+    const ButtonItem *button = button_queue.peek();
+    const StickItem *stick = stick_queue.peek();
+    const RfidEvent *tag = rfid_queue.peek();
+    const InputEvent *injected = inject_queue.peek();
+
+    // Oldest of the heads goes first, ties in this order
+    Head oldest = head_none;
+    uint32_t oldest_us = 0;
+    if (button) consider(&oldest, &oldest_us, head_button, button->time_us);
+    if (stick) consider(&oldest, &oldest_us, head_stick, stick->time_us);
+    if (tag) consider(&oldest, &oldest_us, head_tag, tag->time_us);
+    if (injected) consider(&oldest, &oldest_us, head_injected, injected->time_us);
+
+    switch (oldest) {
+        case head_button:
+            event->type = input_button;
+            event->time_us = button->time_us;
+            event->pressed = button->pressed;
+            button_queue.pop();
+            return true;
+
+        case head_stick:
+            event->type = stick->type;
+            event->time_us = stick->time_us;
+            event->direction = stick->direction;
+            stick_queue.pop();
+            return true;
+
+        case head_tag:
+            event->type = input_tag;
+            event->time_us = tag->time_us;
+            event->rfid = *tag;
+            rfid_queue.pop();
+            return true;
+
+        case head_injected:
+            *event = *injected;
+            inject_queue.pop();
+            return true;
+
+        case head_none:
+            break;
+    }
+    return false;
+}
@@ -0,0 +1,77 @@
+#ifndef INPUT_HH
+#define INPUT_HH
+
+#include <stdint.h>
+#include "joystick.hh"
+#include "rfid.hh"
+
+/*  NOTES:
+
+    Every input change becomes a timestamped event, so a press shorter
+    than a game tick is still seen and latency can be measured from the
+    moment the hardware noticed it.
+
+    Each source has its own lock-free SPSC ring, so no producer ever
+    waits on another:
+        - button: JOYSTICK_SW edge IRQ, debounced
+        - stick:  direction changes from the 1 ms joystick filter ISR
+        - rfid:   card arrive/leave, posted by input_poll() itself
+        - inject: made up events from the USB scripting commands,
+                  posted from the main loop
+    input_poll() hands them out oldest first across all rings.
+
+*/
+
+enum InputEventType {
+    input_button,       // pressed says which edge
+    input_stick_x,      // direction is left/right/center
+    input_stick_y,      // direction is up/down/center
+    input_tag,          // rfid holds the arrive/leave event
+};
+
+struct InputEvent {
+    InputEventType type;
+    uint32_t time_us;            // time_us_32() when it happened
+    bool pressed;
+    JoystickDirection direction;
+    RfidEvent rfid;
+};
+
+/**
+ * @brief services the rfid reader and returns the oldest input event,
+ * call until false once per game tick. never blocks
+ *
+ * @param event set to the next event
+ * @return true if an event was returned
+ */
+bool input_poll(InputEvent *event);
+
+/**
+ * @brief events lost to a full ring since boot
+ */
+uint32_t input_dropped();
+
+/**
+ * @brief posts a button edge, only from the JOYSTICK_SW IRQ (or an
+ * IRQ at the same priority on the same core)
+ */
+void input_post_button(bool pressed, uint32_t time_us);
+
+/**
+ * @brief posts a stick direction change, only from the joystick
+ * filter ISR
+ *
+ * @param type input_stick_x or input_stick_y
+ */
+void input_post_stick(InputEventType type, JoystickDirection direction, uint32_t time_us);
+
+/**
+ * @brief posts an event that did not come from the hardware, only from
+ * the main loop. it is stamped with the current time and handed out by
+ * input_poll like a real one
+ *
+ * @param event type and the fields that type uses
+ */
+void input_inject(const InputEvent *event);
+
+#endif // INPUT_HH
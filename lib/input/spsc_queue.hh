@@ -0,0 +1,67 @@
+#ifndef SPSC_QUEUE_HH
+#define SPSC_QUEUE_HH
+
+#include <stdint.h>
+#include "hardware/sync.h"
+
+/*  NOTES:
+
+    Single-producer single-consumer ring, no locks and no disabled
+    interrupts. The producer only writes 'head' and the consumer only
+    writes 'tail', so an ISR can push while the main loop pops. The
+    barrier orders the slot write before the index that publishes it
+    (and works across cores too).
+
+    N must be a power of two. Indices run freely and wrap at 2^32.
+
+*/
+
+template <typename T, uint32_t N>
+struct SpscQueue {
+    static_assert((N & (N - 1)) == 0, "size must be a power of two");
+
+    T slots[N];
+    volatile uint32_t head = 0;   // next slot to write, producer only
+    volatile uint32_t tail = 0;   // next slot to read, consumer only
+    volatile uint32_t dropped = 0;
+
+    /**
+     * @brief copies 'item' in, counts a drop if full
+     * @return false if the queue was full
+     */
+    bool push(const T &item) {
+        uint32_t h = head;
+        if (h - tail == N) {
+            dropped = dropped + 1;
+            return false;
+        }
+        slots[h & (N - 1)] = item;
+        __dmb();
+        head = h + 1;
+        return true;
+    }
+
+    /**
+     * @brief oldest item, or NULL if empty. stays queued until pop()
+     */
+    const T *peek() const {
+        uint32_t t = tail;
+        if (t == head) return nullptr;
+        __dmb();
+        return &slots[t & (N - 1)];
+    }
+
+    /**
+     * @brief removes the oldest item
+     * @return false if the queue was empty
+     */
+    bool pop() {
+        uint32_t t = tail;
+        if (t == head) return false;
+        __dmb();
+        tail = t + 1;
+        return true;
+    }
+};
+
+#endif // SPSC_QUEUE_HH
@@ -1,69 +1,289 @@
 #include <stdio.h>
 #include "pico/stdlib.h"
 #include "hardware/adc.h"
+#include "hardware/dma.h"
 #include "hardware/gpio.h"
 #include "../pin-definitions.hh"
 
 #include "joystick.hh"
+#include "input.hh"
+#include "soft_timer.hh"
 
 #define ADC_MAX 4095
-#define CENTER 2048
-#define DEADZONE_PERCENT 50
-#define JOYSTICK_TIMER_MS 25
 
-volatile bool joystick_flag = false;
+// ADC round-robins X then Y, 1 kHz per axis (48 MHz / 24000 per conversion)
+#define ADC_CLKDIV 23999
+#define FILTER_PERIOD_US 1000
 
-void joystick_isr() {
-    hw_clear_bits(&timer0_hw->intr, 1 << 0);
+// Ring of interleaved X/Y samples, DMA wraps the write address on its own.
+// Size is a power of two and even, so X is always at an even index
+#define RING_BITS 6
+#define RING_SIZE (1 << RING_BITS)
+#define RING_MASK (RING_SIZE - 1)
 
-    //sample js 
-    joystick_flag = true;
+#define MEDIAN_TAPS 5
+#define EMA_SHIFT 2        // new = old + (sample - old) / 4
+#define EMA_FRAC 4         // fractional bits kept in the EMA state
 
-    uint32_t target = timer0_hw->timerawl + JOYSTICK_TIMER_MS * 1000;
-    timer0_hw->alarm[0] = target;
+// Stick counts as centered if the direction is under half of full tilt.
+// Once tilted it has to come back under 40%, so noise at the line can't
+// flood the event queue
+#define DIRECTION_THRESHOLD (JOYSTICK_AXIS_MAX / 2)
+#define DIRECTION_RELEASE (JOYSTICK_AXIS_MAX * 2 / 5)
+
+// Contact bounce on the stick button settles well within this
+#define DEBOUNCE_US 5000
+
+// Boot calibration: stick at rest means the readings barely move
+#define CAL_SAMPLES 100
+#define CAL_MAX_NOISE 80
+#define CAL_MAX_OFFSET 600   // from the ADC midpoint
+#define CAL_MIN_DEADZONE 2   // percent
+
+static uint16_t ring[RING_SIZE] __attribute__((aligned(RING_SIZE * sizeof(uint16_t))));
+static int dma_chan;
+static SoftTimer filter_timer;
+
+// Defaults until joystick_set_calibration() is called with saved values
+static uint16_t center_x = 2048;
+static uint16_t center_y = 2048;
+static int deadzone = (ADC_MAX / 2) * 5 / 100;
+
+// Written by the filter ISR only, one aligned store each
+static int32_t ema_x, ema_y;
+static volatile uint16_t filtered_x, filtered_y;
+static volatile int16_t axis_x, axis_y;
+
+// Direction last posted per axis, only touched by the filter ISR
+static JoystickDirection dir_x = center;
+static JoystickDirection dir_y = center;
+
+// Button state last posted, the edge IRQ and the filter ISR share these.
+// Both run at the default priority on core0, so they never nest
+static bool button_down = false;
+static uint32_t last_edge_us = 0;
+
+// ====== Filter ======
+
+static uint16_t median5(uint16_t *v) {
+    // Partial insertion sort, only the middle element is needed
+    for (int i = 1; i < MEDIAN_TAPS; i++) {
+        uint16_t key = v[i];
+        int j = i - 1;
+        while (j >= 0 && v[j] > key) {
+            v[j + 1] = v[j];
+            j--;
+        }
+        v[j + 1] = key;
+    }
+    return v[MEDIAN_TAPS / 2];
 }
 
-void init_joystick(void){
-    adc_init();
+// Offset from center with the deadzone cut out, scaled to +-JOYSTICK_AXIS_MAX
+static int16_t to_axis(uint16_t value, uint16_t mid) {
+    int offset = (int)value - mid;
+    int span = (offset > 0) ? ADC_MAX - mid : mid;
+    int mag = (offset > 0) ? offset : -offset;
+
+    if (mag <= deadzone || span <= deadzone) return 0;
+    int scaled = (mag - deadzone) * JOYSTICK_AXIS_MAX / (span - deadzone);
+    if (scaled > JOYSTICK_AXIS_MAX) scaled = JOYSTICK_AXIS_MAX;
+    return (int16_t)((offset > 0) ? scaled : -scaled);
+}
+
+static uint32_t ring_write_index() {
+    uintptr_t addr = dma_channel_hw_addr(dma_chan)->write_addr;
+    return (uint32_t)((addr - (uintptr_t)ring) / sizeof(uint16_t)) & RING_MASK;
+}
+
+static void run_filter() {
+    // Newest complete X/Y pair starts two before the next even index
+    uint32_t pair = (ring_write_index() & ~1u) - 2;
+
+    uint16_t xs[MEDIAN_TAPS], ys[MEDIAN_TAPS];
+    for (int i = 0; i < MEDIAN_TAPS; i++) {
+        xs[i] = ring[(pair - 2 * i) & RING_MASK];
+        ys[i] = ring[(pair - 2 * i + 1) & RING_MASK];
+    }
+
+    // Median throws out single-sample spikes, EMA smooths what's left
+    int32_t mx = (int32_t)median5(xs) << EMA_FRAC;
+    int32_t my = (int32_t)median5(ys) << EMA_FRAC;
+    ema_x += (mx - ema_x) >> EMA_SHIFT;
+    ema_y += (my - ema_y) >> EMA_SHIFT;
+
+    filtered_x = ema_x >> EMA_FRAC;
+    filtered_y = ema_y >> EMA_FRAC;
+    axis_x = to_axis(filtered_x, center_x);
+    axis_y = to_axis(filtered_y, center_y);
+}
+
+static JoystickDirection direction(int16_t value, JoystickDirection last,
+                                   JoystickDirection neg, JoystickDirection pos) {
+    int16_t threshold = (last == center) ? DIRECTION_THRESHOLD : DIRECTION_RELEASE;
+    if (value > threshold) return pos;
+    if (value < -threshold) return neg;
+    return center;
+}
+
+static void post_crossings(uint32_t now) {
+    JoystickDirection x = direction(axis_x, dir_x, left, right);
+    if (x != dir_x) {
+        dir_x = x;
+        input_post_stick(input_stick_x, x, now);
+    }
+
+    JoystickDirection y = direction(axis_y, dir_y, down, up);
+    if (y != dir_y) {
+        dir_y = y;
+        input_post_stick(input_stick_y, y, now);
+    }
+}
+
+static void button_edge(uint32_t now) {
+    bool pressed = (gpio_get(JOYSTICK_SW) == 0);
+    if (pressed == button_down) return;
+
+    button_down = pressed;
+    last_edge_us = now;
+    input_post_button(pressed, now);
+}
+
+// First edge is posted right away, the bounces after it are ignored
+static void button_isr() {
+    if (!(gpio_get_irq_event_mask(JOYSTICK_SW) & (GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE))) return;
+    gpio_acknowledge_irq(JOYSTICK_SW, GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE);
+
+    uint32_t now = time_us_32();
+    if (now - last_edge_us < DEBOUNCE_US) return;
+    button_edge(now);
+}
+
+static void joystick_tick(void *ctx) {
+    (void)ctx;
+    uint32_t now = time_us_32();
+    run_filter();
+    post_crossings(now);
 
+    // An edge that landed inside the debounce window gets caught here
+    if (now - last_edge_us >= DEBOUNCE_US) button_edge(now);
+
+    // Transfer count runs out after ~37 hours of samples, start it again
+    if (!dma_channel_is_busy(dma_chan)) {
+        dma_channel_set_trans_count(dma_chan, 0x0FFFFFFF, true);
+    }
+}
+
+// ====== Setup ======
+
+static void init_adc_dma() {
+    adc_init();
     adc_gpio_init(JOYSTICK_X);
     adc_gpio_init(JOYSTICK_Y);
 
+    adc_select_input(0);
+    adc_set_round_robin(0b11);
+    adc_fifo_setup(true, true, 1, false, false);
+    adc_set_clkdiv(ADC_CLKDIV);
+
+    // Seed the filter so the first readings aren't a ramp up from 0
+    for (int i = 0; i < RING_SIZE; i++) ring[i] = (i & 1) ? center_y : center_x;
+    ema_x = (int32_t)center_x << EMA_FRAC;
+    ema_y = (int32_t)center_y << EMA_FRAC;
+    filtered_x = center_x;
+    filtered_y = center_y;
+
+    dma_chan = dma_claim_unused_channel(true);
+    dma_channel_config c = dma_channel_get_default_config(dma_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_ring(&c, true, RING_BITS + 1);  // wrap on bytes
+    channel_config_set_dreq(&c, DREQ_ADC);
+
+    // Effectively endless, the ISR restarts it if it ever finishes
+    dma_channel_configure(dma_chan, &c, ring, &adc_hw->fifo, 0x0FFFFFFF, true);
+
+    adc_fifo_drain();
+    adc_run(true);
+
+}
+
+void init_joystick(void){
+    init_adc_dma();
+
     gpio_init(JOYSTICK_SW);
     gpio_set_dir(JOYSTICK_SW, GPIO_IN);
     gpio_pull_up(JOYSTICK_SW);
 
-    timer0_hw->inte |= 1 << 0;
+    gpio_add_raw_irq_handler(JOYSTICK_SW, button_isr);
+    gpio_set_irq_enabled(JOYSTICK_SW, GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE, true);
+    irq_set_enabled(IO_IRQ_BANK0, true);
+
+    soft_timer_start(&filter_timer, FILTER_PERIOD_US, FILTER_PERIOD_US, joystick_tick, NULL);
+}
+
+void joystick_set_calibration(uint16_t x, uint16_t y, uint8_t deadzone_percent) {
+    center_x = x;
+    center_y = y;
+    deadzone = (ADC_MAX / 2) * deadzone_percent / 100;
+}
+
+bool joystick_calibrate(uint16_t *x, uint16_t *y, uint8_t *deadzone_percent) {
+    // Let the ring and EMA settle on real samples first
+    sleep_ms(20);
+
+    uint32_t sum_x = 0, sum_y = 0;
+    uint16_t min_x = ADC_MAX, max_x = 0, min_y = ADC_MAX, max_y = 0;
+
+    for (int i = 0; i < CAL_SAMPLES; i++) {
+        uint16_t fx = filtered_x, fy = filtered_y;
+        sum_x += fx;
+        sum_y += fy;
+        if (fx < min_x) min_x = fx;
+        if (fx > max_x) max_x = fx;
+        if (fy < min_y) min_y = fy;
+        if (fy > max_y) max_y = fy;
+        sleep_ms(1);
+    }
+
+    uint16_t cx = sum_x / CAL_SAMPLES;
+    uint16_t cy = sum_y / CAL_SAMPLES;
+    int noise = (max_x - min_x > max_y - min_y) ? max_x - min_x : max_y - min_y;
+
+    // Someone is holding the stick, keep whatever calibration we had
+    int mid = (ADC_MAX + 1) / 2;
+    if (noise > CAL_MAX_NOISE || cx < mid - CAL_MAX_OFFSET || cx > mid + CAL_MAX_OFFSET ||
+        cy < mid - CAL_MAX_OFFSET || cy > mid + CAL_MAX_OFFSET) {
+        return false;
+    }
 
-    uint alarm0_irq = timer_hardware_alarm_get_irq_num(timer0_hw, 0);
-    irq_set_exclusive_handler(alarm0_irq, joystick_isr);
-    irq_set_enabled(alarm0_irq, true);
+    // Twice the resting jitter, rounded up to a whole percent
+    int percent = (noise * 2 * 100 + ADC_MAX / 2 - 1) / (ADC_MAX / 2);
+    if (percent < CAL_MIN_DEADZONE) percent = CAL_MIN_DEADZONE;
 
-    uint32_t target = timer0_hw->timerawl + JOYSTICK_TIMER_MS * 1000;
-    timer0_hw->alarm[0] = target;    
+    *x = cx;
+    *y = cy;
+    *deadzone_percent = (uint8_t)percent;
+    return true;
 }
 
-JoystickDirection sample_js_x(void){
-    adc_select_input(0);
-    uint16_t value = adc_read();
+int16_t joystick_axis_x(void) {
+    return axis_x;
+}
 
-    int deadzone = (ADC_MAX / 2) * DEADZONE_PERCENT / 100;
-    if (value > CENTER + deadzone) return right;   // right
-    else if (value < CENTER - deadzone) return left;  // left
-    else return center;
+int16_t joystick_axis_y(void) {
+    return axis_y;
 }
 
-JoystickDirection sample_js_y(void){
-    adc_select_input(1);
-    uint16_t value = adc_read();
+JoystickDirection sample_js_x(void){
+    return dir_x;
+}
 
-    int deadzone = (ADC_MAX / 2) * DEADZONE_PERCENT / 100;
-    if (value > CENTER + deadzone) return up;   // up
-    else if (value < CENTER - deadzone) return down;  // down
-    else return center;
+JoystickDirection sample_js_y(void){
+    return dir_y;
 }
 
 bool sample_js_select(void) {
     return (gpio_get(JOYSTICK_SW) == 0); // LOW when pressed
 }
-
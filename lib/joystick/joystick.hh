@@ -1,7 +1,10 @@
 #ifndef JOYSTICK_HH
 #define JOYSTICK_HH
 
-extern volatile bool joystick_flag;
+#include <stdint.h>
+
+// Analog axes run from -JOYSTICK_AXIS_MAX to JOYSTICK_AXIS_MAX
+#define JOYSTICK_AXIS_MAX 1000
 
 enum JoystickDirection {
     left,
@@ -11,12 +14,62 @@ enum JoystickDirection {
     center,
 };
 
+/*  NOTES:
+
+    The ADC free-runs in round-robin over both axes and DMA writes the
+    samples into a ring, so nothing ever waits on a conversion. A 1 ms
+    timer ISR takes the median of the newest samples and an EMA of
+    that, turns it into a calibrated axis and from there a direction.
+    Everything below just reads the results.
+
+    The axes are for proportional control, like a cursor that moves
+    faster the further the stick is pushed. They are 0 inside the
+    deadzone and scale from its edge to +-JOYSTICK_AXIS_MAX at the
+    stop, so a caller can multiply by them directly.
+
+    Direction changes and debounced button edges are also posted to
+    the input queue (input.hh) as they happen.
+
+*/
+
 /**
- * @brief initialize joystick pins and adc
+ * @brief initialize joystick pins, adc and dma
  */
 
 void init_joystick(void);
 
+/**
+ * @brief set the rest position and deadzone used for the axes
+ *
+ * @param center_x x axis ADC reading at rest
+ * @param center_y y axis ADC reading at rest
+ * @param deadzone_percent percent of half the ADC range to ignore
+ */
+void joystick_set_calibration(uint16_t center_x, uint16_t center_y, uint8_t deadzone_percent);
+
+/**
+ * @brief measure the rest position for ~120 ms, call at boot with the
+ * stick untouched. does not apply the result
+ *
+ * @param center_x set to the x axis rest reading
+ * @param center_y set to the y axis rest reading
+ * @param deadzone_percent set from how much the readings jitter
+ * @return false if the stick looked held, outputs are left alone
+ */
+bool joystick_calibrate(uint16_t *center_x, uint16_t *center_y, uint8_t *deadzone_percent);
+
+/**
+ * @brief latest filtered x axis, right is positive. never blocks,
+ * at most 1 ms old
+ */
+int16_t joystick_axis_x(void);
+
+/**
+ * @brief latest filtered y axis, up is positive. never blocks,
+ * at most 1 ms old
+ */
+int16_t joystick_axis_y(void);
+
 /**
  * @brief return 1 if right, -1 if left, 0 if neither
  * 
@@ -20,6 +20,8 @@ constexpr Color GRASS_DARK( 64, 128,  64);
 constexpr Color PATH(255, 193,   7);
 constexpr Color TREE_BROWN( 87,  62,   8);
 constexpr Color TREE_GREEN( 75,  99,  42);
+constexpr Color ROCK_GRAY( 75,  75,  75);
+constexpr Color LAKE_BLUE(  0,   0, 150);
 
 constexpr Color BLOON_RED(222,  36,  36);
 constexpr Color BLOON_BLUE(  0,   0,   0);
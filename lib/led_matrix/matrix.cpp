@@ -1,6 +1,7 @@
 #include "matrix.hh"
 #include <math.h>
 #include <stdio.h>
+#include <string.h>
 #include "hardware/gpio.h"
 #include "pico/stdlib.h"
 
@@ -15,6 +16,9 @@
 Color frames[2][MATRIX_ROWS][MATRIX_COLS];
 int frame_index = 0;
 
+// Current map's background, copied under each frame
+static Color background[MATRIX_ROWS][MATRIX_COLS];
+
 static uint8_t gamma_lut[256];
 
 static inline void my_gpio_put(uint pin, bool val) {
@@ -55,6 +59,7 @@ void init_framebuffers(Color color) {
         for (int col = 0; col < MATRIX_COLS; col++) {
             frames[0][row][col] = color;
             frames[1][row][col] = color;
+            background[row][col] = color;
 
         }
     }
@@ -77,6 +82,10 @@ void swap_frames() {
     frame_index = !frame_index;
 }
 
+const Color *drawing_frame() {
+    return &frames[frame_index][0][0];
+}
+
 void reset_row_sel() {
     for (int row_sel = A; row_sel <= D; row_sel++) {
         my_gpio_put(row_sel, 0);
@@ -128,6 +137,11 @@ void render_frame() {
     }
 }
 
+void matrix_blank() {
+    // render_frame leaves the last row lit until the next frame starts
+    sio_hw->gpio_set = (1u << OE);
+}
+
 void set_towers(Tower* towers) {
     for (int i = 0; i < 13; i++) {
         Tower tower = towers[i];
@@ -151,49 +165,37 @@ void set_tower(Tower tower) {
     }
 }
 
-void set_path() {
-    for (int col = 0; col < 18; col++) {
-        frames[frame_index][14][col] = PATH;
-        frames[frame_index][15][col] = PATH;
-        frames[frame_index][16][col] = PATH;
+bool load_background(const MapRecord *map) {
+    const uint8_t *rgb = map_palette(map);
+    Color palette[MAP_PALETTE_MAX];
+    for (int i = 0; i < map->palette_count; i++) {
+        palette[i] = Color(rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2]);
     }
 
-    for (int row = 5; row < 17; row++) {
-        frames[frame_index][row][16] = PATH;
-        frames[frame_index][row][17] = PATH;
-        frames[frame_index][row][18] = PATH;
-    }
-    
-    for (int col = 16; col < 33; col++) {
-        frames[frame_index][5][col] = PATH;
-        frames[frame_index][6][col] = PATH;
-        frames[frame_index][7][col] = PATH;
+    // Runs go straight into the layer, row-major like the layer itself
+    Color *out = &background[0][0];
+    Color *end = out + MATRIX_ROWS * MATRIX_COLS;
+    const uint8_t *runs = map_background(map);
 
-    }
+    for (uint32_t i = 0; i < map->background_size; i++) {
+        int length = (runs[i] >> 4) + 1;
+        int index = runs[i] & 0x0F;
+        if (index >= map->palette_count || out + length > end) break;
 
-    for (int row = 5; row < 27; row++) {
-        frames[frame_index][row][30] = PATH;
-        frames[frame_index][row][31] = PATH;
-        frames[frame_index][row][32] = PATH;
+        Color color = palette[index];
+        for (int n = 0; n < length; n++) *out++ = color;
     }
 
-    for (int col = 33; col < 49; col++) {
-        frames[frame_index][24][col] = PATH;
-        frames[frame_index][25][col] = PATH;
-        frames[frame_index][26][col] = PATH;
-    }
-    
-    for (int row = 14; row < 27; row++) {
-        frames[frame_index][row][46] = PATH;
-        frames[frame_index][row][47] = PATH;
-        frames[frame_index][row][48] = PATH;
-    }
+    if (out == end) return true;
 
-    for (int col = 46; col < 64; col++) {
-        frames[frame_index][14][col] = PATH;
-        frames[frame_index][15][col] = PATH;
-        frames[frame_index][16][col] = PATH;
-    }
+    // Bad runs, fall back to the plain base color
+    Color base(map->background[0], map->background[1], map->background[2]);
+    for (out = &background[0][0]; out < end; out++) *out = base;
+    return false;
+}
+
+void set_background() {
+    memcpy(frames[frame_index], background, sizeof(background));
 }
 
 void set_tree(int x, int y) {
@@ -208,4 +210,45 @@ void set_tree(int x, int y) {
 
 void set_pixel(int x, int y, Color color) {
     frames[frame_index][y][x] = color;
-}
\ No newline at end of file
+}
+
+// Each lit run in a glyph column is one vertical span
+static inline void draw_glyph(int x, int y, const uint8_t *columns, Color color, const Font *font) {
+    for (int col = 0; col < font->width; col++, x++) {
+        uint32_t bits = columns[col];
+        if (!bits || x < 0 || x >= MATRIX_COLS) continue;
+
+        while (bits) {
+            int top = __builtin_ctz(bits);
+            int length = __builtin_ctz(~(bits >> top));
+            bits &= ~(((1u << length) - 1) << top);
+
+            int start = y + top;
+            int end = start + length;
+            if (start < 0) start = 0;
+            if (end > MATRIX_ROWS) end = MATRIX_ROWS;
+            for (int row = start; row < end; row++) {
+                frames[frame_index][row][x] = color;
+            }
+        }
+    }
+}
+
+int draw_text(int x, int y, const char *text, Color color, const Font *font) {
+    // Whole line off the top or bottom, only the width matters
+    bool visible = y < MATRIX_ROWS && y + font->height > 0;
+
+    for (; *text; text++) {
+        if (visible && x < MATRIX_COLS && x + font->width > 0) {
+            draw_glyph(x, y, font_glyph(font, *text), color, font);
+        }
+        x += font->width + 1;
+    }
+    return x;
+}
+
+int draw_int(int x, int y, int32_t value, Color color, const Font *font, int min_digits) {
+    char digits[FORMAT_INT_MAX];
+    format_int(digits, value, min_digits);
+    return draw_text(x, y, digits, color, font);
+}
@@ -3,6 +3,8 @@
 
 #include "../tower/tower.hh"
 #include "color.hh"
+#include "../maps/map_blob.hh"
+#include "../font/font.hh"
 
 
 /*  NOTES:
@@ -22,11 +24,23 @@ void init_matrix();
  */
 void swap_frames();
 
+/**
+ * @brief the frame core0 draws into, shown after the next swap
+ * 
+ * @return MATRIX_ROWS x MATRIX_COLS pixels, row major
+ */
+const Color *drawing_frame();
+
 /**
  * @brief renders one frame
  */
 void render_frame();
 
+/**
+ * @brief turns the panel off (OE high) until the next render_frame
+ */
+void matrix_blank();
+
 /**
  * @brief adds all towers to framebuffer at repective (x, y)
  * 
@@ -42,11 +56,20 @@ void set_towers(Tower* towers);
 void set_tower(Tower tower);
 
 /**
- * @brief adds predefined path to framebuffer
+ * @brief decompresses a map's prerendered background into the
+ * background layer, call once at level load
  * 
- * @param towers pointer to first element of Tower array
+ * @param map map record from map_get()
+ * @return false if the runs are corrupt, the layer is then the map's
+ * base color
  */
-void set_path();
+bool load_background(const MapRecord *map);
+
+/**
+ * @brief copies the background layer into the framebuffer, call first
+ * when drawing a frame
+ */
+void set_background();
 
 /**
  * @brief adds tree to framebuffer at pos (x, y)
@@ -65,4 +88,24 @@ void set_tree(int x, int y);
  */
 void set_pixel(int x, int y, Color color);
 
+/**
+ * @brief draws 'text' into the framebuffer, clipped to the panel
+ * 
+ * @param x left edge of the first glyph
+ * @param y top edge of the glyphs
+ * @param text string to draw
+ * @param color color of lit pixels, unlit pixels are left alone
+ * @param font font_small or font_large
+ * @return x just past the last glyph, for drawing more on the line
+ */
+int draw_text(int x, int y, const char *text, Color color, const Font *font);
+
+/**
+ * @brief draws a decimal number, same as draw_text with format_int
+ * 
+ * @param min_digits pad with leading zeros up to this many digits
+ * @return x just past the last glyph
+ */
+int draw_int(int x, int y, int32_t value, Color color, const Font *font, int min_digits = 1);
+
 #endif // MATRIX_H
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include "log.hh"
+
+#if LOG_DEFERRED
+
+#include "pico/stdlib.h"
+#include "pico/stdio_usb.h"
+#include "hardware/sync.h"
+#include "usb_packet.hh"
+
+#define RING_MASK (LOG_RING_SIZE - 1)
+#define CORES 2
+
+// Records sent per drain call, spreads a burst over a few calls
+#define DRAIN_PER_CALL 8
+
+static_assert(sizeof(void *) != 4 || sizeof(LogRecord) == 32, "LogRecord should stay 32 bytes");
+static_assert((LOG_RING_SIZE & RING_MASK) == 0, "ring size must be a power of two");
+
+struct LogRing {
+    LogRecord records[LOG_RING_SIZE];
+    volatile uint32_t head;          // written by the owning core
+    volatile uint32_t tail;          // written by core0's drain
+    volatile uint32_t dropped;
+};
+
+static LogRing rings[CORES];
+
+static UsbPacket packet;
+static uint16_t seq = 0;
+static uint32_t dropped_sent[CORES];
+
+LogRecord *log_reserve(uint32_t *irq) {
+    LogRing *ring = &rings[get_core_num()];
+
+    *irq = save_and_disable_interrupts();
+    uint32_t head = ring->head;
+    if (head - ring->tail == LOG_RING_SIZE) {
+        ring->dropped = ring->dropped + 1;
+        restore_interrupts(*irq);
+        return NULL;
+    }
+
+    LogRecord *record = &ring->records[head & RING_MASK];
+    record->time_us = time_us_32();
+    return record;
+}
+
+void log_commit(uint32_t irq) {
+    LogRing *ring = &rings[get_core_num()];
+
+    // Record contents before the index that publishes them
+    __dmb();
+    ring->head = ring->head + 1;
+    restore_interrupts(irq);
+}
+
+uint32_t log_dropped() {
+    return rings[0].dropped + rings[1].dropped;
+}
+
+static void put_u32(uint8_t *out, uint32_t value) {
+    out[0] = value & 0xFF;
+    out[1] = (value >> 8) & 0xFF;
+    out[2] = (value >> 16) & 0xFF;
+    out[3] = value >> 24;
+}
+
+// Builds the next packet: a drop count if a ring lost records since the
+// last one, else the oldest record of the two rings. False if there is none
+static bool next_packet() {
+    for (int core = 0; core < CORES; core++) {
+        uint32_t dropped = rings[core].dropped;
+        if (dropped == dropped_sent[core]) continue;
+
+        uint8_t *payload = usb_packet_begin(&packet, packet_log_dropped, seq++);
+        payload[0] = core;
+        put_u32(payload + 1, dropped);
+        usb_packet_end(&packet, 5);
+        dropped_sent[core] = dropped;
+        return true;
+    }
+
+    int core = -1;
+    uint32_t oldest_us = 0;
+    for (int i = 0; i < CORES; i++) {
+        LogRing *ring = &rings[i];
+        if (ring->tail == ring->head) continue;
+
+        __dmb();
+        uint32_t time_us = ring->records[ring->tail & RING_MASK].time_us;
+        if (core < 0 || (int32_t)(time_us - oldest_us) < 0) {
+            core = i;
+            oldest_us = time_us;
+        }
+    }
+    if (core < 0) return false;
+
+    LogRing *ring = &rings[core];
+    const LogRecord *record = &ring->records[ring->tail & RING_MASK];
+
+    uint8_t *payload = usb_packet_begin(&packet, packet_log, seq++);
+    payload[0] = core;
+    put_u32(payload + 1, (uint32_t)(uintptr_t)record->format);
+    put_u32(payload + 5, record->time_us);
+    memcpy(payload + 9, record->args, record->length);
+    usb_packet_end(&packet, 9 + record->length);
+
+    // Copied out, the slot can be reused
+    __dmb();
+    ring->tail = ring->tail + 1;
+    return true;
+}
+
+void log_drain() {
+    // Keep them in the rings until someone is listening
+    if (!stdio_usb_connected()) return;
+
+    for (int i = 0; i < DRAIN_PER_CALL; i++) {
+        if (!usb_packet_send(&packet)) return;
+        if (!next_packet()) return;
+    }
+    usb_packet_send(&packet);
+}
+
+#endif // LOG_DEFERRED
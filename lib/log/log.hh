@@ -0,0 +1,219 @@
+#ifndef LOG_HH
+#define LOG_HH
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <tuple>
+#include <type_traits>
+
+/*  NOTES:
+
+    Deferred logging for hot paths, in place of printf:
+
+        LOG("Card on reader, tower: %d", scanned_tower);
+
+    No formatting on the board. A call stores the format string's
+    address, a timestamp and the raw argument bytes in this core's ring
+    and returns, a few hundred ns. log_drain() (core0 main loop) ships
+    the records as usb_packet packets and tools/log_expand formats them
+    with the strings read out of firmware.elf. No newline at the end,
+    every record is one line.
+
+    Arguments are checked against the format at compile time:
+        %d %i %u %x %X %o %c    any integer, enum or bool up to 32 bits
+        %lld %llu %llx ...      64-bit integers
+        %f %e %g                float or double, sent as float
+        %s                      C string, copied, cut to what fits
+    Up to LOG_ARGS_MAX bytes of arguments (4 per number, 8 per 64-bit,
+    1 + length per string), later ones are dropped whole and show up as
+    "..." on the host.
+
+    One ring per core, written by that core's code and its IRQs (kept
+    apart by masking interrupts for the few cycles a record takes) and
+    read by core0. A full ring drops the new record and counts it, the
+    host prints how many were lost. Nothing ever blocks.
+
+    Build with -DLOG_DEFERRED=0 (build_flags in platformio.ini) and LOG
+    is a plain printf with a newline, no host tool needed.
+
+*/
+
+#ifndef LOG_DEFERRED
+#define LOG_DEFERRED 1
+#endif
+
+#define LOG_ARGS_MAX 23
+#define LOG_RING_SIZE 64      // records per core, power of two
+
+#if LOG_DEFERRED
+
+enum LogArgKind : uint8_t {
+    log_arg_int,
+    log_arg_int64,
+    log_arg_float,
+    log_arg_string,
+};
+
+// 32 bytes on the board
+struct LogRecord {
+    const char *format;
+    uint32_t time_us;
+    uint8_t length;                 // argument bytes used
+    uint8_t args[LOG_ARGS_MAX];
+};
+
+// ====== Compile-time format check ======
+
+template <typename T>
+constexpr LogArgKind log_arg_kind() {
+    using U = std::decay_t<T>;
+    constexpr bool string = std::is_same<U, const char *>::value || std::is_same<U, char *>::value;
+    static_assert(string || std::is_arithmetic<U>::value || std::is_enum<U>::value,
+                  "LOG takes numbers, enums and C strings");
+
+    if constexpr (string) return log_arg_string;
+    else if constexpr (std::is_floating_point<U>::value) return log_arg_float;
+    else if constexpr (sizeof(U) > 4) return log_arg_int64;
+    else return log_arg_int;
+}
+
+template <typename Tuple>
+struct LogArgs;
+
+template <typename... T>
+struct LogArgs<std::tuple<T...>> {
+    static constexpr int count = sizeof...(T);
+    static constexpr LogArgKind kinds[sizeof...(T) + 1] = {log_arg_kind<T>()..., log_arg_int};
+};
+
+constexpr bool log_format_matches(const char *format, const LogArgKind *kinds, int count) {
+    int arg = 0;
+    for (int i = 0; format[i]; i++) {
+        if (format[i] != '%') continue;
+        if (format[++i] == '%') continue;
+
+        while (format[i] == '-' || format[i] == '+' || format[i] == ' ' || format[i] == '#' ||
+               format[i] == '0') i++;
+        while ((format[i] >= '0' && format[i] <= '9') || format[i] == '.') i++;
+
+        int longs = 0;
+        while (format[i] == 'h' || format[i] == 'l' || format[i] == 'z' || format[i] == 't') {
+            if (format[i] == 'l') longs++;
+            i++;
+        }
+
+        LogArgKind want = log_arg_int;
+        switch (format[i]) {
+            case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c':
+                want = longs >= 2 ? log_arg_int64 : log_arg_int;
+                break;
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+                want = log_arg_float;
+                break;
+            case 's':
+                want = log_arg_string;
+                break;
+            default:
+                return false;       // '*' widths, %p, %n and the rest
+        }
+        if (arg == count || kinds[arg++] != want) return false;
+    }
+    return arg == count;
+}
+
+// ====== Recording ======
+
+struct LogCursor {
+    uint8_t *out;
+    const uint8_t *end;
+    bool full;                      // an argument didn't fit, drop the rest
+};
+
+template <typename T>
+inline void log_put(LogCursor *cursor, T value) {
+    if (cursor->full) return;
+    int room = cursor->end - cursor->out;
+    constexpr LogArgKind kind = log_arg_kind<T>();
+
+    if constexpr (kind == log_arg_string) {
+        const char *text = value ? value : "";
+        if (room < 1) {
+            cursor->full = true;
+            return;
+        }
+        int length = 0;
+        while (length < room - 1 && text[length]) length++;
+        *cursor->out = length;
+        memcpy(cursor->out + 1, text, length);
+        cursor->out += 1 + length;
+    } else {
+        using Stored = std::conditional_t<kind == log_arg_float, float,
+                       std::conditional_t<kind == log_arg_int64, uint64_t, uint32_t>>;
+        Stored stored = (Stored)value;
+        if (room < (int)sizeof(stored)) {
+            cursor->full = true;
+            return;
+        }
+        memcpy(cursor->out, &stored, sizeof(stored));
+        cursor->out += sizeof(stored);
+    }
+}
+
+/**
+ * @brief claims the next record in this core's ring, interrupts stay
+ * off until log_commit. use LOG instead
+ *
+ * @param irq saved interrupt state for log_commit
+ * @return NULL if the ring is full (counted, interrupts restored)
+ */
+LogRecord *log_reserve(uint32_t *irq);
+
+/**
+ * @brief publishes the reserved record
+ */
+void log_commit(uint32_t irq);
+
+template <typename... Args>
+inline void log_write(const char *format, Args... args) {
+    uint32_t irq;
+    LogRecord *record = log_reserve(&irq);
+    if (!record) return;
+
+    LogCursor cursor = {record->args, record->args + LOG_ARGS_MAX, false};
+    (log_put(&cursor, args), ...);
+    record->format = format;
+    record->length = cursor.out - record->args;
+    log_commit(irq);
+}
+
+#define LOG(format, ...)                                                                       \
+    do {                                                                                       \
+        using LogArgTypes = LogArgs<decltype(std::make_tuple(__VA_ARGS__))>;                   \
+        static_assert(log_format_matches(format, LogArgTypes::kinds, LogArgTypes::count),      \
+                      "LOG arguments don't match \"" format "\"");                             \
+        log_write(format, ##__VA_ARGS__);                                                      \
+    } while (0)
+
+/**
+ * @brief sends waiting records to the host, a few per call. call often
+ * from core0's main loop. records wait in the rings while no host has
+ * the port open
+ */
+void log_drain();
+
+/**
+ * @brief records lost to full rings since boot
+ */
+uint32_t log_dropped();
+
+#else
+
+#define LOG(format, ...) printf(format "\n", ##__VA_ARGS__)
+
+inline void log_drain() {}
+inline uint32_t log_dropped() { return 0; }
+
+#endif // LOG_DEFERRED
+
+#endif // LOG_HH
@@ -0,0 +1,96 @@
+#include <stddef.h>
+
+#include "map_blob.hh"
+
+static uint16_t valid_maps = 0;
+
+static uint32_t crc32(const uint8_t *data, size_t len) {
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int b = 0; b < 8; b++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
+
+static const MapBlobHeader *header() {
+    return (const MapBlobHeader *)map_blob_data;
+}
+
+// Every array a record points at has to lie inside the blob
+static bool record_fits(const MapRecord *map, uint32_t size) {
+    return map->path_offset + map->path_count * sizeof(MapBlobPoint) <= size &&
+           map->slot_offset + map->slot_count * sizeof(MapBlobPoint) <= size &&
+           map->decoration_offset + map->decoration_count * sizeof(MapBlobDecoration) <= size &&
+           map->wave_offset + map->wave_count * sizeof(MapBlobWave) <= size &&
+           map->palette_offset + map->palette_count * 3u <= size &&
+           map->background_offset + map->background_size <= size &&
+           map->palette_count <= MAP_PALETTE_MAX &&
+           map->path_count >= 2;
+}
+
+static bool waves_fit(const MapRecord *map, uint32_t size) {
+    const MapBlobWave *waves = (const MapBlobWave *)(map_blob_data + map->wave_offset);
+    for (uint16_t i = 0; i < map->wave_count; i++) {
+        if (waves[i].event_offset + waves[i].event_count * sizeof(MapSpawnEvent) > size) return false;
+    }
+    return true;
+}
+
+bool map_blob_init() {
+    const MapBlobHeader *h = header();
+    valid_maps = 0;
+
+    if (h->magic != MAP_BLOB_MAGIC || h->version != MAP_BLOB_VERSION) return false;
+    if (h->size < sizeof(MapBlobHeader) + h->map_count * sizeof(MapRecord)) return false;
+    if (crc32(map_blob_data + sizeof(MapBlobHeader), h->size - sizeof(MapBlobHeader)) != h->crc) {
+        return false;
+    }
+
+    const MapRecord *records = (const MapRecord *)(map_blob_data + sizeof(MapBlobHeader));
+    for (uint16_t i = 0; i < h->map_count; i++) {
+        if (!record_fits(&records[i], h->size) || !waves_fit(&records[i], h->size)) return false;
+    }
+
+    valid_maps = h->map_count;
+    return true;
+}
+
+uint16_t map_count() {
+    return valid_maps;
+}
+
+const MapRecord *map_get(uint16_t index) {
+    if (index >= valid_maps) return NULL;
+    return &((const MapRecord *)(map_blob_data + sizeof(MapBlobHeader)))[index];
+}
+
+const MapBlobPoint *map_path(const MapRecord *map) {
+    return (const MapBlobPoint *)(map_blob_data + map->path_offset);
+}
+
+const MapBlobPoint *map_slots(const MapRecord *map) {
+    return (const MapBlobPoint *)(map_blob_data + map->slot_offset);
+}
+
+const MapBlobDecoration *map_decorations(const MapRecord *map) {
+    return (const MapBlobDecoration *)(map_blob_data + map->decoration_offset);
+}
+
+const MapBlobWave *map_waves(const MapRecord *map) {
+    return (const MapBlobWave *)(map_blob_data + map->wave_offset);
+}
+
+const MapSpawnEvent *map_wave_events(const MapBlobWave *wave) {
+    return (const MapSpawnEvent *)(map_blob_data + wave->event_offset);
+}
+
+const uint8_t *map_palette(const MapRecord *map) {
+    return map_blob_data + map->palette_offset;
+}
+
+const uint8_t *map_background(const MapRecord *map) {
+    return map_blob_data + map->background_offset;
+}
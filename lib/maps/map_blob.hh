@@ -0,0 +1,170 @@
+#ifndef MAP_BLOB_HH
+#define MAP_BLOB_HH
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*  NOTES:
+
+    Maps are compiled from the JSON files in gam4/maps by
+    tools/map_compiler/compile_maps.py into map_data.cpp, a byte array
+    that stays in flash. Everything here points straight into it, no
+    copies. Adding a map is just rerunning the compiler.
+
+    Layout (little-endian, every array 4-byte aligned):
+        MapBlobHeader
+        MapRecord[map_count]
+        arrays, found through the offsets in each record (from the
+        start of the blob)
+
+    Bump MAP_BLOB_VERSION (here and in the compiler) whenever the
+    layout changes.
+
+    Backgrounds are prerendered by the compiler (or hand drawn, see
+    its README) and stored as a palette of up to 16 colors plus runs
+    in row-major order. Each run is one byte: the high nibble is the
+    length minus one, the low nibble the palette index. Decoding
+    needs no buffer beyond the destination, see load_background().
+
+    Waves are compiled from spawn groups into one flat list of spawn
+    events per wave, sorted by time. Each event holds its delay after
+    the previous one, so a game only keeps a pointer to the next event
+    and the time left until it, whatever the wave's length.
+
+*/
+
+#define MAP_BLOB_MAGIC 0x504D4454u  // "TDMP"
+#define MAP_BLOB_VERSION 3
+
+#define MAP_PALETTE_MAX 16
+
+enum MapDecorationType {
+    map_tree,
+    map_rock,
+    map_lake,
+};
+
+enum MapEnemyType {
+    map_scout,
+    map_tank,
+    map_splitter,
+    map_ghost,
+};
+
+struct MapBlobHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t map_count;
+    uint32_t size;          // whole blob, header included
+    uint32_t crc;           // CRC-32 of everything after the header
+};
+
+struct MapRecord {
+    char name[16];          // NUL padded
+    uint8_t width;
+    uint8_t height;
+    uint8_t background[3];  // r, g, b, the base color
+    uint8_t palette_count;
+    uint8_t reserved[2];
+    int16_t spawn_x, spawn_y;
+    int16_t end_x, end_y;
+    uint16_t path_count;
+    uint16_t slot_count;
+    uint16_t decoration_count;
+    uint16_t wave_count;
+    uint32_t path_offset;
+    uint32_t slot_offset;
+    uint32_t decoration_offset;
+    uint32_t wave_offset;
+    uint32_t palette_offset;        // r, g, b triplets
+    uint32_t background_offset;     // palette-RLE runs
+    uint32_t background_size;       // bytes of runs
+};
+
+struct MapBlobPoint {
+    int16_t x, y;
+};
+
+struct MapBlobDecoration {
+    int16_t x, y;
+    uint8_t type;           // MapDecorationType
+    uint8_t reserved[3];
+};
+
+struct MapBlobWave {
+    uint32_t event_offset;  // MapSpawnEvent[event_count]
+    uint16_t event_count;
+    uint16_t reserved;
+};
+
+struct MapSpawnEvent {
+    uint16_t delay_ms;      // after the previous event, or the wave start
+    uint8_t type;           // MapEnemyType
+    uint8_t path;           // always 0, maps have one path so far
+};
+
+// The blob itself, in the generated map_data.cpp
+extern const uint8_t map_blob_data[];
+
+static_assert(sizeof(MapBlobHeader) == 16, "blob header layout");
+static_assert(sizeof(MapRecord) == 68, "map record layout");
+static_assert(sizeof(MapBlobDecoration) == 8, "decoration layout");
+static_assert(sizeof(MapBlobWave) == 8, "wave layout");
+static_assert(sizeof(MapSpawnEvent) == 4, "spawn event layout");
+
+/**
+ * @brief checks the blob's magic, version, size and CRC once at boot
+ *
+ * @return false if the blob is unusable, map_count() is then 0
+ */
+bool map_blob_init();
+
+/**
+ * @brief number of maps in the blob
+ */
+uint16_t map_count();
+
+/**
+ * @brief a map record, in flash
+ *
+ * @param index map index, in the order given to the compiler
+ * @return NULL if index is out of range
+ */
+const MapRecord *map_get(uint16_t index);
+
+/**
+ * @brief path waypoints, map->path_count of them
+ */
+const MapBlobPoint *map_path(const MapRecord *map);
+
+/**
+ * @brief suggested tower spots, map->slot_count of them
+ */
+const MapBlobPoint *map_slots(const MapRecord *map);
+
+/**
+ * @brief decorations, map->decoration_count of them
+ */
+const MapBlobDecoration *map_decorations(const MapRecord *map);
+
+/**
+ * @brief wave table, map->wave_count of them
+ */
+const MapBlobWave *map_waves(const MapRecord *map);
+
+/**
+ * @brief a wave's spawn events in time order, wave->event_count of them
+ */
+const MapSpawnEvent *map_wave_events(const MapBlobWave *wave);
+
+/**
+ * @brief background palette, map->palette_count r, g, b triplets
+ */
+const uint8_t *map_palette(const MapRecord *map);
+
+/**
+ * @brief background runs, map->background_size bytes
+ */
+const uint8_t *map_background(const MapRecord *map);
+
+#endif // MAP_BLOB_HH
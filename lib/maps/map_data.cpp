@@ -0,0 +1,168 @@
+// Generated by tools/map_compiler/compile_maps.py, do not edit.
+// Sources: forest.json, canyon.json
+
+#include "pico/platform.h"
+#include "map_blob.hh"
+
+// Stays in flash and is read in place through XIP
+alignas(4) const uint8_t __in_flash("maps") map_blob_data[2544] = {
+    0x54, 0x44, 0x4d, 0x50, 0x03, 0x00, 0x02, 0x00, 0xf0, 0x09, 0x00, 0x00, 0xda, 0xa1, 0xfc, 0x7b,
+    0x46, 0x6f, 0x72, 0x65, 0x73, 0x74, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x40, 0x20, 0x00, 0x3c, 0x00, 0x09, 0x00, 0x00, 0x3f, 0x00, 0x14, 0x00, 0x00, 0x00, 0x0a, 0x00,
+    0x04, 0x00, 0x03, 0x00, 0x03, 0x00, 0x04, 0x00, 0x98, 0x00, 0x00, 0x00, 0xa8, 0x00, 0x00, 0x00,
+    0xb4, 0x00, 0x00, 0x00, 0x34, 0x01, 0x00, 0x00, 0x54, 0x01, 0x00, 0x00, 0x70, 0x01, 0x00, 0x00,
+    0xd5, 0x01, 0x00, 0x00, 0x43, 0x61, 0x6e, 0x79, 0x6f, 0x6e, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x40, 0x20, 0x5a, 0x3c, 0x14, 0x09, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00,
+    0x3f, 0x00, 0x1b, 0x00, 0x06, 0x00, 0x04, 0x00, 0x05, 0x00, 0x04, 0x00, 0x48, 0x03, 0x00, 0x00,
+    0x60, 0x03, 0x00, 0x00, 0x70, 0x03, 0x00, 0x00, 0x90, 0x07, 0x00, 0x00, 0xb0, 0x07, 0x00, 0x00,
+    0xcc, 0x07, 0x00, 0x00, 0x23, 0x02, 0x00, 0x00, 0x3f, 0x00, 0x14, 0x00, 0x14, 0x00, 0x14, 0x00,
+    0x14, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x0a, 0x00, 0x05, 0x00, 0x0a, 0x00, 0x19, 0x00,
+    0x28, 0x00, 0x0f, 0x00, 0x1e, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x14, 0x00, 0x1c, 0x00,
+    0x01, 0x00, 0x00, 0x00, 0x2d, 0x00, 0x08, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xe8, 0x03, 0x00, 0x00, 0xe8, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xe8, 0x03, 0x00, 0x00,
+    0xe8, 0x03, 0x00, 0x00, 0xe8, 0x03, 0x00, 0x00, 0xe8, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xe8, 0x03, 0x00, 0x00, 0xe8, 0x03, 0x00, 0x00, 0xe8, 0x03, 0x00, 0x00, 0xe8, 0x03, 0x00, 0x00,
+    0xe8, 0x03, 0x00, 0x00, 0xe8, 0x03, 0x00, 0x00, 0xe8, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xe8, 0x03, 0x00, 0x00, 0xe8, 0x03, 0x00, 0x00, 0xe8, 0x03, 0x00, 0x00, 0xe8, 0x03, 0x00, 0x00,
+    0xe8, 0x03, 0x00, 0x00, 0xe8, 0x03, 0x00, 0x00, 0xe8, 0x03, 0x00, 0x00, 0xe8, 0x03, 0x00, 0x00,
+    0xe8, 0x03, 0x00, 0x00, 0xcc, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0xd8, 0x00, 0x00, 0x00,
+    0x05, 0x00, 0x00, 0x00, 0xec, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x0c, 0x01, 0x00, 0x00,
+    0x0a, 0x00, 0x00, 0x00, 0x00, 0x3c, 0x00, 0x0c, 0x48, 0x0c, 0x00, 0x30, 0x00, 0x4b, 0x63, 0x2a,
+    0x00, 0x00, 0x96, 0x57, 0x3e, 0x08, 0xff, 0xc1, 0x07, 0xe1, 0xa3, 0x00, 0x4b, 0x4b, 0x4b, 0x00,
+    0xa0, 0x01, 0x30, 0x01, 0x40, 0x02, 0x30, 0x11, 0x30, 0x02, 0x60, 0x01, 0x00, 0x02, 0xd0, 0x01,
+    0x50, 0x02, 0x80, 0x01, 0xb0, 0x02, 0x30, 0x02, 0x30, 0x02, 0xb0, 0x02, 0x90, 0x01, 0x10, 0x01,
+    0x50, 0x02, 0x00, 0x01, 0x50, 0x01, 0xd0, 0x02, 0xf0, 0xf0, 0x01, 0x40, 0x01, 0xf0, 0xf0, 0xf0,
+    0xf0, 0x10, 0x11, 0x02, 0xf0, 0x30, 0x23, 0x80, 0x02, 0x00, 0x01, 0x50, 0x02, 0xf0, 0x30, 0x01,
+    0x80, 0x01, 0x20, 0x02, 0x30, 0x02, 0x10, 0x23, 0x50, 0x02, 0x50, 0x01, 0x70, 0x01, 0x00, 0x01,
+    0xb0, 0x02, 0xf0, 0x50, 0x02, 0x23, 0xc0, 0x24, 0x40, 0x01, 0x00, 0x01, 0x50, 0x02, 0x20, 0x12,
+    0xf0, 0x90, 0x05, 0x80, 0x12, 0x10, 0x54, 0xc0, 0x02, 0x10, 0x01, 0x80, 0x01, 0x60, 0x02, 0x00,
+    0x01, 0x10, 0x02, 0x20, 0x25, 0x80, 0x02, 0x10, 0x54, 0x10, 0x02, 0x40, 0x01, 0x40, 0x06, 0x07,
+    0x46, 0x07, 0xc6, 0x60, 0x01, 0x70, 0x02, 0x70, 0x24, 0x50, 0x01, 0x70, 0x26, 0x07, 0x06, 0x07,
+    0x46, 0x07, 0x96, 0x70, 0x02, 0x01, 0x60, 0x01, 0xe0, 0x02, 0x70, 0xf6, 0x56, 0x30, 0x01, 0x80,
+    0x11, 0xf0, 0x20, 0x02, 0xd0, 0x02, 0x00, 0x11, 0x10, 0x01, 0x20, 0x02, 0x26, 0x20, 0x01, 0x50,
+    0x01, 0xf0, 0xa0, 0x02, 0x40, 0x02, 0x00, 0x02, 0x90, 0x01, 0x20, 0x26, 0xf0, 0x50, 0x01, 0x02,
+    0x10, 0x01, 0x10, 0x01, 0x12, 0x50, 0x22, 0x20, 0x01, 0x00, 0x02, 0x10, 0x11, 0x30, 0x02, 0x10,
+    0x02, 0x01, 0x00, 0x06, 0x07, 0x06, 0x70, 0x01, 0xf0, 0xa0, 0x01, 0xa0, 0x02, 0x10, 0x11, 0x70,
+    0x26, 0xf0, 0x02, 0x10, 0x01, 0x10, 0x01, 0x50, 0x02, 0xd0, 0x01, 0xf0, 0x26, 0xf0, 0xd0, 0x02,
+    0x80, 0x02, 0x20, 0x02, 0x70, 0x01, 0x20, 0x01, 0x20, 0x26, 0x00, 0x11, 0x10, 0x02, 0x30, 0x01,
+    0xd0, 0x01, 0x80, 0x01, 0x00, 0x01, 0xa0, 0x01, 0x02, 0x90, 0x07, 0x06, 0x07, 0x01, 0x10, 0x01,
+    0x30, 0x02, 0x20, 0x02, 0x00, 0x01, 0x30, 0x11, 0x50, 0x02, 0x80, 0x01, 0x00, 0x02, 0xe0, 0x01,
+    0x40, 0x07, 0x36, 0x07, 0x76, 0x07, 0xf6, 0x16, 0x07, 0x26, 0x17, 0x06, 0x07, 0x16, 0x07, 0x06,
+    0x00, 0x01, 0xd0, 0x02, 0x10, 0xb6, 0x07, 0x06, 0x07, 0xa6, 0x07, 0x16, 0x07, 0x66, 0x07, 0x66,
+    0x10, 0x02, 0x20, 0x01, 0xa0, 0x01, 0x00, 0x07, 0xf6, 0xf6, 0xa6, 0xf0, 0xb0, 0x01, 0x90, 0x01,
+    0x80, 0x02, 0x40, 0x02, 0x50, 0x02, 0xb0, 0x02, 0xd0, 0x02, 0x50, 0x01, 0x70, 0x01, 0x60, 0x01,
+    0x80, 0x02, 0x50, 0x01, 0x70, 0x01, 0x00, 0x01, 0xf0, 0xf0, 0x30, 0x01, 0x90, 0x01, 0x10, 0x02,
+    0x10, 0x01, 0x80, 0x02, 0x20, 0x01, 0xe0, 0x02, 0x80, 0x01, 0x80, 0x01, 0x80, 0x02, 0x01, 0x60,
+    0x02, 0xc0, 0x01, 0x02, 0xd0, 0x01, 0x10, 0x01, 0x30, 0x02, 0x40, 0x02, 0x20, 0x01, 0xf0, 0x70,
+    0x01, 0x18, 0x00, 0x02, 0x90, 0x02, 0x90, 0x11, 0x70, 0x02, 0xf0, 0x30, 0x11, 0x30, 0x02, 0x00,
+    0x28, 0xf0, 0x20, 0x02, 0x10, 0x02, 0x50, 0x01, 0xd0, 0x02, 0x30, 0x01, 0x20, 0x01, 0x20, 0x02,
+    0x50, 0x02, 0x60, 0x02, 0xc0, 0x02, 0x10, 0x01, 0x70, 0x01, 0xf0, 0xb0, 0x02, 0x30, 0x01, 0xf0,
+    0x10, 0x01, 0x10, 0x02, 0xf0, 0xb0, 0x01, 0x00, 0x02, 0x10, 0x01, 0xf0, 0x30, 0x01, 0x10, 0x01,
+    0x80, 0x11, 0x50, 0x01, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x32, 0x00, 0x04, 0x00,
+    0x32, 0x00, 0x10, 0x00, 0x0c, 0x00, 0x10, 0x00, 0x0c, 0x00, 0x1b, 0x00, 0x3f, 0x00, 0x1b, 0x00,
+    0x1e, 0x00, 0x0a, 0x00, 0x38, 0x00, 0x16, 0x00, 0x05, 0x00, 0x16, 0x00, 0x20, 0x00, 0x16, 0x00,
+    0x3a, 0x00, 0x09, 0x00, 0x01, 0x00, 0x00, 0x00, 0x28, 0x00, 0x0b, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x04, 0x00, 0x0c, 0x00, 0x01, 0x00, 0x00, 0x00, 0x19, 0x00, 0x15, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x37, 0x00, 0x0d, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xe8, 0x03, 0x00, 0x00,
+    0xe8, 0x03, 0x00, 0x00, 0xe8, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x03, 0x00, 0x00,
+    0x20, 0x03, 0x00, 0x00, 0x20, 0x03, 0x00, 0x00, 0x20, 0x03, 0x00, 0x00, 0x20, 0x03, 0x00, 0x00,
+    0x00, 0x00, 0x01, 0x00, 0x20, 0x03, 0x00, 0x00, 0x20, 0x03, 0x00, 0x00, 0x78, 0x05, 0x01, 0x00,
+    0x00, 0x00, 0x02, 0x00, 0xb0, 0x04, 0x02, 0x00, 0xb0, 0x04, 0x02, 0x00, 0x58, 0x02, 0x03, 0x00,
+    0x58, 0x02, 0x02, 0x00, 0x84, 0x03, 0x03, 0x00, 0x2c, 0x01, 0x02, 0x00, 0xb0, 0x04, 0x02, 0x00,
+    0x00, 0x00, 0x03, 0x00, 0xdc, 0x05, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x32, 0x00, 0x01, 0x00, 0x64, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x64, 0x00, 0x01, 0x00,
+    0x32, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x32, 0x00, 0x01, 0x00, 0x64, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x64, 0x00, 0x03, 0x00, 0x32, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x32, 0x00, 0x03, 0x00, 0x64, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x03, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x64, 0x00, 0x03, 0x00, 0x32, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x32, 0x00, 0x03, 0x00, 0x64, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x64, 0x00, 0x01, 0x00, 0x32, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x64, 0x00, 0x03, 0x00, 0x32, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x32, 0x00, 0x01, 0x00, 0x00, 0x00, 0x03, 0x00,
+    0x64, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x64, 0x00, 0x03, 0x00, 0x32, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x32, 0x00, 0x03, 0x00,
+    0x64, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x64, 0x00, 0x01, 0x00, 0x00, 0x00, 0x03, 0x00,
+    0x32, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x32, 0x00, 0x03, 0x00,
+    0x64, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x32, 0x00, 0x01, 0x00,
+    0x64, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x64, 0x00, 0x03, 0x00,
+    0x32, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x32, 0x00, 0x03, 0x00,
+    0x64, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00,
+    0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x96, 0x00, 0x03, 0x00, 0xe8, 0x03, 0x03, 0x00,
+    0x98, 0x03, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0xa8, 0x03, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00,
+    0xd0, 0x03, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 0xf8, 0x03, 0x00, 0x00, 0xe6, 0x00, 0x00, 0x00,
+    0x5a, 0x3c, 0x14, 0x66, 0x48, 0x20, 0x4e, 0x30, 0x08, 0xff, 0xc1, 0x07, 0xe1, 0xa3, 0x00, 0x4b,
+    0x4b, 0x4b, 0x00, 0x00, 0x96, 0x4b, 0x63, 0x2a, 0x57, 0x3e, 0x08, 0x00, 0x60, 0x01, 0xa0, 0x01,
+    0xd0, 0x02, 0x00, 0x12, 0x40, 0x01, 0x40, 0x02, 0xf0, 0x50, 0x12, 0x70, 0x01, 0x80, 0x01, 0x90,
+    0x02, 0x10, 0x02, 0x20, 0x02, 0xf0, 0x01, 0x70, 0x12, 0x20, 0x02, 0x50, 0x11, 0x80, 0x02, 0x20,
+    0x02, 0x80, 0x01, 0x00, 0x02, 0xf0, 0x63, 0x04, 0x23, 0x04, 0xa3, 0x04, 0x33, 0x14, 0x33, 0x24,
+    0x73, 0x04, 0x33, 0x04, 0x20, 0x11, 0x60, 0x02, 0x73, 0x04, 0x33, 0x04, 0xe3, 0x04, 0xf3, 0x53,
+    0x40, 0x01, 0x10, 0x01, 0x10, 0x01, 0x23, 0x04, 0xf3, 0x23, 0x04, 0xd3, 0x04, 0x13, 0x04, 0x73,
+    0x04, 0x03, 0x60, 0x02, 0xf0, 0x10, 0x01, 0xf0, 0x12, 0x20, 0x01, 0x10, 0x02, 0x80, 0x03, 0x04,
+    0x03, 0x40, 0x01, 0xa0, 0x01, 0x50, 0x02, 0x00, 0x01, 0x70, 0x02, 0x20, 0x02, 0x80, 0x01, 0xa0,
+    0x23, 0x00, 0x01, 0x50, 0x02, 0x70, 0x02, 0x01, 0x10, 0x01, 0x10, 0x02, 0x00, 0x02, 0x00, 0x02,
+    0xc0, 0x01, 0x00, 0x02, 0x50, 0x02, 0x50, 0x01, 0x02, 0x00, 0x03, 0x04, 0x03, 0x40, 0x15, 0xa0,
+    0x02, 0x30, 0x01, 0x30, 0x01, 0x02, 0x01, 0x30, 0x01, 0xf0, 0x60, 0x02, 0x00, 0x13, 0x04, 0x20,
+    0x01, 0x00, 0x25, 0x60, 0x02, 0xf0, 0x50, 0x01, 0x02, 0x90, 0x02, 0x15, 0x40, 0x01, 0x02, 0x00,
+    0x23, 0x30, 0x01, 0x20, 0x01, 0x50, 0x15, 0x00, 0x02, 0x00, 0x01, 0x02, 0x10, 0x02, 0x10, 0x01,
+    0xf0, 0x40, 0x01, 0x00, 0x25, 0x20, 0x02, 0x10, 0x02, 0x23, 0x10, 0x01, 0x26, 0x20, 0x01, 0x40,
+    0x25, 0x01, 0x30, 0x02, 0x10, 0x02, 0xf0, 0x80, 0x01, 0x70, 0x23, 0x10, 0x56, 0x70, 0x01, 0xd0,
+    0x01, 0x90, 0x02, 0x10, 0x01, 0x02, 0x01, 0x70, 0x01, 0x30, 0x23, 0x10, 0x56, 0xb0, 0x02, 0x01,
+    0xf0, 0x40, 0x02, 0x00, 0x02, 0x00, 0x02, 0x90, 0x02, 0x10, 0x23, 0x30, 0x26, 0x30, 0x01, 0x30,
+    0x02, 0x60, 0x53, 0x04, 0x23, 0x04, 0xf3, 0x63, 0x14, 0x33, 0x40, 0x01, 0x20, 0x01, 0x50, 0x02,
+    0x50, 0x53, 0x04, 0xe3, 0x04, 0x03, 0x04, 0x33, 0x04, 0x13, 0x04, 0x13, 0x04, 0x43, 0xf0, 0x60,
+    0xf3, 0x23, 0x04, 0x73, 0x14, 0x33, 0x04, 0x43, 0x40, 0x01, 0x10, 0x01, 0x60, 0x02, 0x60, 0x03,
+    0x14, 0xe0, 0x02, 0x40, 0x02, 0xc0, 0x02, 0x00, 0x01, 0x30, 0x01, 0x02, 0x10, 0x01, 0x50, 0x02,
+    0x20, 0x12, 0x10, 0x23, 0xa0, 0x01, 0x00, 0x01, 0x60, 0x01, 0xf0, 0xf0, 0x40, 0x11, 0x13, 0x04,
+    0x70, 0x01, 0x00, 0x27, 0x20, 0x01, 0x30, 0x02, 0x40, 0x02, 0x00, 0x01, 0x12, 0xf0, 0x20, 0x02,
+    0x80, 0x23, 0x90, 0x27, 0x30, 0x01, 0x50, 0x01, 0x30, 0x01, 0x40, 0x01, 0x20, 0x02, 0x10, 0x01,
+    0x00, 0x02, 0x40, 0x01, 0x20, 0x02, 0x40, 0x02, 0x13, 0x04, 0x30, 0x02, 0x20, 0x02, 0x00, 0x27,
+    0x01, 0x30, 0x02, 0x70, 0x01, 0x00, 0x02, 0x40, 0x01, 0x20, 0x02, 0x20, 0x02, 0x20, 0x01, 0x20,
+    0x01, 0x80, 0x23, 0x10, 0x12, 0x60, 0x08, 0x20, 0x02, 0x11, 0x00, 0x01, 0x00, 0x01, 0x40, 0x01,
+    0x30, 0x01, 0x02, 0x80, 0x01, 0x60, 0x11, 0x50, 0x02, 0x00, 0x23, 0x40, 0x01, 0x20, 0x02, 0x28,
+    0x00, 0x11, 0xb0, 0x02, 0xb0, 0x02, 0x40, 0x02, 0x80, 0x02, 0x10, 0x01, 0x23, 0x60, 0x02, 0x20,
+    0x01, 0xf0, 0x00, 0x02, 0xb0, 0x01, 0x00, 0x01, 0x00, 0x02, 0x30, 0x12, 0x30, 0x02, 0x10, 0x02,
+    0x03, 0x04, 0x73, 0x04, 0x23, 0x04, 0xb3, 0x04, 0x53, 0x04, 0xc3, 0x04, 0x33, 0x20, 0x02, 0x20,
+    0x02, 0x20, 0x03, 0x04, 0xd3, 0x04, 0xb3, 0x04, 0xd3, 0x04, 0x73, 0xb0, 0x04, 0x63, 0x14, 0xf3,
+    0xe3, 0x04, 0x03, 0x14, 0x53, 0x04, 0x60, 0x02, 0x10, 0x02, 0xf0, 0x30, 0x01, 0xe0, 0x01, 0x30,
+    0x01, 0xb0, 0x01, 0xf0, 0x40, 0x02, 0x70, 0x02, 0x10, 0x02, 0x00, 0x01, 0x30, 0x02, 0x30, 0x21,
+    0x50, 0x02, 0x30, 0x02, 0xc0, 0x12, 0x80, 0x01, 0xe0, 0x01, 0xa0, 0x02, 0x10, 0x01, 0x90, 0x00,
+};
@@ -0,0 +1,183 @@
+#include "profiler.hh"
+
+#include <stdlib.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/stdio_usb.h"
+#include "hardware/clocks.h"
+#include "hardware/structs/systick.h"
+#include "hardware/sync.h"
+#include "usb_command.hh"
+#include "usb_packet.hh"
+
+#define CORES 2
+
+// Samples per core, power of two. ~50 ms of slack at 10 kHz
+#define RING_SIZE 512
+#define RING_MASK (RING_SIZE - 1)
+
+// Samples per packet, fills most of a packet
+#define SAMPLES_PER_PACKET 31
+#define SAMPLE_SIZE 8
+#define PACKET_HEADER 6
+
+// Packets sent per drain call
+#define PACKETS_PER_DRAIN 4
+
+#define SYSTICK_ENABLE (1u << 0)
+#define SYSTICK_TICKINT (1u << 1)
+#define SYSTICK_CLKSOURCE (1u << 2)      // processor clock
+#define SYSTICK_RELOAD_MAX 0xFFFFFF
+
+static_assert(PACKET_HEADER + SAMPLES_PER_PACKET * SAMPLE_SIZE <= USB_PACKET_PAYLOAD_MAX,
+              "samples must fit a packet");
+
+struct Sample {
+    uint32_t pc;
+    uint32_t lr;
+};
+
+struct SampleRing {
+    Sample samples[RING_SIZE];
+    volatile uint32_t head;          // written by this core's SysTick
+    volatile uint32_t tail;          // written by core0's drain
+    volatile uint32_t dropped;
+};
+
+static SampleRing rings[CORES];
+
+// Requested rate, 0 = off. Each core applies it when the generation moves
+static volatile uint32_t rate_hz = 0;
+static volatile uint32_t generation = 0;
+static uint32_t applied[CORES];
+
+static UsbPacket packet;
+static uint16_t seq = 0;
+static int next_core = 0;
+
+// Runs in the SysTick exception. 'frame' is what the exception pushed:
+// r0-r3, r12, lr, pc, xpsr
+extern "C" void profiler_sample(const uint32_t *frame) {
+    SampleRing *ring = &rings[get_core_num()];
+
+    uint32_t head = ring->head;
+    if (head - ring->tail == RING_SIZE) {
+        ring->dropped = ring->dropped + 1;
+        return;
+    }
+
+    Sample *sample = &ring->samples[head & RING_MASK];
+    sample->pc = frame[6];
+    sample->lr = frame[5];
+    __dmb();
+    ring->head = head + 1;
+}
+
+// Finds the stack the interrupted code was using (bit 2 of EXC_RETURN)
+// and hands its exception frame to profiler_sample, which returns
+// straight from the exception. Thumb-1 only, runs on M0+ and M33
+extern "C" __attribute__((naked)) void isr_systick() {
+    __asm volatile(
+        "movs r0, #4\n"
+        "mov r1, lr\n"
+        "tst r0, r1\n"
+        "beq 1f\n"
+        "mrs r0, psp\n"
+        "b 2f\n"
+        "1:\n"
+        "mrs r0, msp\n"
+        "2:\n"
+        "ldr r1, =profiler_sample\n"
+        "bx r1\n"
+        ".align 2\n"
+        ".ltorg\n");
+}
+
+void profiler_core_poll() {
+    uint core = get_core_num();
+    uint32_t current = generation;
+    if (applied[core] == current) return;
+    applied[core] = current;
+
+    systick_hw->csr = 0;
+    uint32_t hz = rate_hz;
+    if (hz == 0) return;
+
+    uint32_t reload = clock_get_hz(clk_sys) / hz - 1;
+    if (reload > SYSTICK_RELOAD_MAX) reload = SYSTICK_RELOAD_MAX;
+    systick_hw->rvr = reload;
+    systick_hw->cvr = 0;
+    systick_hw->csr = SYSTICK_CLKSOURCE | SYSTICK_TICKINT | SYSTICK_ENABLE;
+}
+
+static bool profile_command(int argc, char **argv) {
+    if (argc < 2 || argc > 3) return false;
+
+    uint32_t hz;
+    if (strcmp(argv[1], "on") == 0) {
+        hz = argc == 3 ? strtoul(argv[2], NULL, 10) : PROFILER_DEFAULT_HZ;
+        if (hz < PROFILER_MIN_HZ || hz > PROFILER_MAX_HZ) return false;
+    } else if (strcmp(argv[1], "off") == 0 && argc == 2) {
+        hz = 0;
+    } else {
+        return false;
+    }
+
+    rate_hz = hz;
+    generation = generation + 1;
+    return true;
+}
+
+void profiler_init() {
+    usb_command_register("profile", profile_command, "on [hz]|off");
+}
+
+static void put_u32(uint8_t *out, uint32_t value) {
+    out[0] = value & 0xFF;
+    out[1] = (value >> 8) & 0xFF;
+    out[2] = (value >> 16) & 0xFF;
+    out[3] = value >> 24;
+}
+
+// Packs up to SAMPLES_PER_PACKET of one core's samples, cores take turns
+static bool next_packet() {
+    for (int i = 0; i < CORES; i++) {
+        int core = (next_core + i) % CORES;
+        SampleRing *ring = &rings[core];
+
+        uint32_t tail = ring->tail;
+        uint32_t count = ring->head - tail;
+        if (count == 0) continue;
+        if (count > SAMPLES_PER_PACKET) count = SAMPLES_PER_PACKET;
+        __dmb();
+
+        uint8_t *payload = usb_packet_begin(&packet, packet_profile, seq++);
+        payload[0] = core;
+        payload[1] = count;
+        put_u32(payload + 2, ring->dropped);
+
+        uint8_t *out = payload + PACKET_HEADER;
+        for (uint32_t n = 0; n < count; n++, out += SAMPLE_SIZE) {
+            const Sample *sample = &ring->samples[(tail + n) & RING_MASK];
+            put_u32(out, sample->pc);
+            put_u32(out + 4, sample->lr);
+        }
+        usb_packet_end(&packet, out - payload);
+
+        __dmb();
+        ring->tail = tail + count;
+        next_core = (core + 1) % CORES;
+        return true;
+    }
+    return false;
+}
+
+void profiler_drain() {
+    if (!stdio_usb_connected()) return;
+
+    for (int i = 0; i < PACKETS_PER_DRAIN; i++) {
+        if (!usb_packet_send(&packet)) return;
+        if (!next_packet()) return;
+    }
+    usb_packet_send(&packet);
+}
@@ -0,0 +1,59 @@
+#ifndef PROFILER_HH
+#define PROFILER_HH
+
+#include <stdint.h>
+
+/*  NOTES:
+
+    Sampling profiler. Each core's own SysTick interrupts it at a fixed
+    rate and records where it was: the PC and LR the exception pushed.
+    Nothing has to be instrumented, time in ISRs, the SDK and libm
+    (sqrtf...) shows up too. tools/profiler symbolizes the samples
+    against firmware.elf and prints flat profiles and folded stacks for
+    flame graphs.
+
+    Host commands (usb_command):
+        profile on [hz]     default PROFILER_DEFAULT_HZ, PROFILER_MIN_HZ
+                            to PROFILER_MAX_HZ
+        profile off
+
+    SysTick is per core, so each core arms its own from
+    profiler_core_poll(), which both cores' loops call. A rate change
+    takes effect on a core the next time it gets there.
+
+    Samples go into a per-core ring (written by that core's SysTick,
+    read by core0) and out over USB as usb_packet packets:
+
+        core u8, count u8, dropped u32, then count x (pc u32, lr u32)
+
+    dropped counts samples lost to a full ring since boot. A sample
+    costs a few dozen cycles, so 1 kHz on both cores is well under 0.1%
+    of the CPU. The USB side is 8 bytes per sample.
+
+    LR is only a hint at the caller: it is exact in a leaf function, in
+    a function that has already called something it may be stale.
+
+*/
+
+#define PROFILER_DEFAULT_HZ 1000
+#define PROFILER_MIN_HZ 10
+#define PROFILER_MAX_HZ 20000
+
+/**
+ * @brief registers the profile command, call once at boot
+ */
+void profiler_init();
+
+/**
+ * @brief starts, stops or retunes this core's sampling when the host
+ * asked for it, call from each core's loop
+ */
+void profiler_core_poll();
+
+/**
+ * @brief sends waiting samples to the host, call often from core0's
+ * main loop
+ */
+void profiler_drain();
+
+#endif // PROFILER_HH
@@ -0,0 +1,246 @@
+#include <string.h>
+#include <stdio.h>
+
+#include "loadout.hh"
+
+// Debug flag
+#define DEBUG_LOADOUT 0
+
+#define LOADOUT_MAGIC0 'T'
+#define LOADOUT_MAGIC1 'D'
+#define LOADOUT_VERSION 1
+
+// NTAG21x user memory starts at page 4, one READ returns four pages
+#define NTAG_FIRST_PAGE 4
+#define NTAG_CMD_READ   0x30
+#define NTAG_CMD_WRITE  0xA2
+
+// Sector 1, block 0: sector 0 holds the manufacturer block
+#define MIFARE_BLOCK      4
+#define MIFARE_CMD_AUTH_A 0x60
+#define MIFARE_CMD_READ   0x30
+#define MIFARE_CMD_WRITE  0xA0
+
+static const uint8_t MIFARE_DEFAULT_KEY[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+struct CacheEntry {
+    bool used;
+    uint8_t uid_len;
+    uint8_t uid[10];
+    bool has_loadout;
+    loadout_t loadout;
+    uint32_t stamp;   // last use, oldest entry is evicted first
+};
+
+static CacheEntry cache[LOADOUT_CACHE_SIZE];
+static uint32_t cache_clock = 0;
+
+// ====== Card format ======
+
+static uint8_t crc8(const uint8_t *data, size_t len) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+void loadout_encode(const loadout_t *loadout, uint8_t *raw) {
+    memset(raw, 0, LOADOUT_SIZE);
+    raw[0] = LOADOUT_MAGIC0;
+    raw[1] = LOADOUT_MAGIC1;
+    raw[2] = LOADOUT_VERSION;
+    raw[3] = loadout->tower;
+    raw[4] = loadout->level;
+    memcpy(&raw[5], loadout->name, strnlen(loadout->name, LOADOUT_NAME_MAX));
+    raw[15] = crc8(raw, LOADOUT_SIZE - 1);
+}
+
+bool loadout_decode(const uint8_t *raw, loadout_t *loadout) {
+    if (raw[0] != LOADOUT_MAGIC0 || raw[1] != LOADOUT_MAGIC1 || raw[2] != LOADOUT_VERSION) {
+        return false;
+    }
+    if (crc8(raw, LOADOUT_SIZE - 1) != raw[15]) return false;
+
+    loadout->tower = raw[3];
+    loadout->level = raw[4];
+    memcpy(loadout->name, &raw[5], LOADOUT_NAME_MAX);
+    loadout->name[LOADOUT_NAME_MAX] = '\0';
+    return true;
+}
+
+// ====== Cache ======
+
+static CacheEntry *cache_find(const uint8_t *uid, uint8_t uid_len) {
+    for (int i = 0; i < LOADOUT_CACHE_SIZE; i++) {
+        if (cache[i].used && cache[i].uid_len == uid_len &&
+            memcmp(cache[i].uid, uid, uid_len) == 0) {
+            return &cache[i];
+        }
+    }
+    return NULL;
+}
+
+static void cache_store(const uint8_t *uid, uint8_t uid_len, bool has_loadout, const loadout_t *loadout) {
+    CacheEntry *entry = cache_find(uid, uid_len);
+
+    if (!entry) {
+        entry = &cache[0];
+        for (int i = 0; i < LOADOUT_CACHE_SIZE; i++) {
+            if (!cache[i].used) {
+                entry = &cache[i];
+                break;
+            }
+            if (cache[i].stamp < entry->stamp) entry = &cache[i];
+        }
+        entry->used = true;
+        entry->uid_len = uid_len;
+        memcpy(entry->uid, uid, uid_len);
+    }
+
+    entry->has_loadout = has_loadout;
+    if (has_loadout) entry->loadout = *loadout;
+    entry->stamp = ++cache_clock;
+}
+
+bool loadout_cache_lookup(const uint8_t *uid, uint8_t uid_len,
+                          bool *has_loadout, loadout_t *loadout) {
+    CacheEntry *entry = cache_find(uid, uid_len);
+    if (!entry) return false;
+
+    entry->stamp = ++cache_clock;
+    *has_loadout = entry->has_loadout;
+    if (entry->has_loadout) *loadout = entry->loadout;
+    return true;
+}
+
+void loadout_cache_invalidate(const uint8_t *uid, uint8_t uid_len) {
+    CacheEntry *entry = cache_find(uid, uid_len);
+    if (entry) entry->used = false;
+}
+
+void loadout_cache_clear(void) {
+    memset(cache, 0, sizeof(cache));
+    cache_clock = 0;
+}
+
+// ====== Card exchanges ======
+
+// Sends the card command for the current step
+static bool send_step(loadout_xfer_t *xfer) {
+    uint8_t cmd[2 + LOADOUT_SIZE + 4];
+    uint8_t len = 0;
+
+    if (xfer->classic && xfer->step == 0) {
+        // AUTH A: block, key, last four UID bytes
+        cmd[len++] = MIFARE_CMD_AUTH_A;
+        cmd[len++] = MIFARE_BLOCK;
+        memcpy(&cmd[len], MIFARE_DEFAULT_KEY, 6);
+        len += 6;
+        memcpy(&cmd[len], &xfer->uid[xfer->uid_len - 4], 4);
+        len += 4;
+    } else if (xfer->classic) {
+        cmd[len++] = xfer->write ? MIFARE_CMD_WRITE : MIFARE_CMD_READ;
+        cmd[len++] = MIFARE_BLOCK;
+        if (xfer->write) {
+            memcpy(&cmd[len], xfer->raw, LOADOUT_SIZE);
+            len += LOADOUT_SIZE;
+        }
+    } else if (xfer->write) {
+        // NTAG WRITE is one 4-byte page at a time
+        cmd[len++] = NTAG_CMD_WRITE;
+        cmd[len++] = NTAG_FIRST_PAGE + xfer->step;
+        memcpy(&cmd[len], &xfer->raw[xfer->step * 4], 4);
+        len += 4;
+    } else {
+        cmd[len++] = NTAG_CMD_READ;
+        cmd[len++] = NTAG_FIRST_PAGE;
+    }
+
+    return pn532_uart_start_data_exchange(xfer->dev, xfer->tg, cmd, len,
+                                          LOADOUT_TIMEOUT_MS, NULL, NULL);
+}
+
+static bool start(loadout_xfer_t *xfer, pn532_uart_t *dev, const pn532_target_t *target, bool write) {
+    if (pn532_uart_busy(dev)) return false;
+
+    xfer->dev = dev;
+    xfer->write = write;
+    // SAK bit 3 set = MIFARE Classic, NTAG/Ultralight report 0x00
+    xfer->classic = (target->sel_res & 0x08) != 0;
+    xfer->step = 0;
+    xfer->tg = target->tg;
+    xfer->uid_len = target->uid_len;
+    memcpy(xfer->uid, target->uid, target->uid_len);
+
+    if (!send_step(xfer)) {
+        xfer->status = LOADOUT_FAILED;
+        return false;
+    }
+    xfer->status = LOADOUT_BUSY;
+    return true;
+}
+
+bool loadout_start_read(loadout_xfer_t *xfer, pn532_uart_t *dev, const pn532_target_t *target) {
+    xfer->has_loadout = false;
+    return start(xfer, dev, target, false);
+}
+
+bool loadout_start_write(loadout_xfer_t *xfer, pn532_uart_t *dev,
+                         const pn532_target_t *target, const loadout_t *loadout) {
+    if (pn532_uart_busy(dev)) return false;
+
+    // Whatever happens next, the cached copy no longer matches the card
+    loadout_cache_invalidate(target->uid, target->uid_len);
+
+    xfer->has_loadout = true;
+    xfer->loadout = *loadout;
+    xfer->loadout.name[LOADOUT_NAME_MAX] = '\0';
+    loadout_encode(&xfer->loadout, xfer->raw);
+    return start(xfer, dev, target, true);
+}
+
+static loadout_status_t fail(loadout_xfer_t *xfer) {
+#if DEBUG_LOADOUT
+    printf("loadout: %s failed at step %d\r\n", xfer->write ? "write" : "read", xfer->step);
+#endif
+    xfer->status = LOADOUT_FAILED;
+    return xfer->status;
+}
+
+loadout_status_t loadout_poll(loadout_xfer_t *xfer) {
+    if (xfer->status != LOADOUT_BUSY) return xfer->status;
+
+    pn532_status_t status = pn532_uart_poll(xfer->dev);
+    if (status == PN532_WAIT_ACK || status == PN532_WAIT_RESPONSE) return LOADOUT_BUSY;
+
+    uint8_t len;
+    const uint8_t *reply = pn532_uart_get_data_exchange(xfer->dev, &len);
+    if (!reply) return fail(xfer);
+
+    bool last;
+    if (xfer->classic) {
+        last = xfer->step == 1;
+    } else {
+        last = !xfer->write || xfer->step == LOADOUT_SIZE / 4 - 1;
+    }
+
+    if (!last) {
+        xfer->step++;
+        if (!send_step(xfer)) return fail(xfer);
+        return LOADOUT_BUSY;
+    }
+
+    if (!xfer->write) {
+        if (len < LOADOUT_SIZE) return fail(xfer);
+        memcpy(xfer->raw, reply, LOADOUT_SIZE);
+        xfer->has_loadout = loadout_decode(xfer->raw, &xfer->loadout);
+    }
+
+    cache_store(xfer->uid, xfer->uid_len, xfer->has_loadout, &xfer->loadout);
+    xfer->status = LOADOUT_DONE;
+    return xfer->status;
+}
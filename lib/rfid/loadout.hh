@@ -0,0 +1,137 @@
+#ifndef LOADOUT_HH
+#define LOADOUT_HH
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "pn532_uart.hh"
+
+/*  NOTES:
+
+    A loadout is 16 bytes on the card, the size of one NTAG READ
+    (pages 4-7) or one MIFARE Classic block (block 4, key A FF..FF):
+
+        0-1   magic "TD"
+        2     format version
+        3     tower type
+        4     upgrade level
+        5-14  player name, NUL padded
+        15    CRC-8 over bytes 0-14
+
+    A torn write fails the CRC and reads back as "no loadout".
+
+    Reads go through a UID-keyed cache, so the UART only carries page
+    reads the first time a card is seen in a session. Writes drop the
+    card's entry before touching the card and store the new loadout
+    once the last page is written.
+
+*/
+
+#define LOADOUT_SIZE 16
+#define LOADOUT_NAME_MAX 10
+#define LOADOUT_CACHE_SIZE 16
+
+// Time the card gets to answer one READ/WRITE/AUTH
+#define LOADOUT_TIMEOUT_MS 50
+
+typedef struct {
+    uint8_t tower;    // TowerType
+    uint8_t level;    // upgrade level
+    char name[LOADOUT_NAME_MAX + 1];
+} loadout_t;
+
+typedef enum {
+    LOADOUT_IDLE,     // nothing started
+    LOADOUT_BUSY,     // card exchange in flight
+    LOADOUT_DONE,     // finished, see has_loadout / loadout
+    LOADOUT_FAILED,   // card left, NACKed or timed out
+} loadout_status_t;
+
+// One read or write in progress, steps through several InDataExchanges
+typedef struct {
+    pn532_uart_t *dev;
+    loadout_status_t status;
+    bool write;
+    bool classic;     // MIFARE Classic: AUTH before READ/WRITE
+    uint8_t step;
+    uint8_t tg;
+    uint8_t uid_len;
+    uint8_t uid[10];
+    uint8_t raw[LOADOUT_SIZE];
+
+    bool has_loadout; // false for blank or foreign cards
+    loadout_t loadout;
+} loadout_xfer_t;
+
+/**
+ * Pack a loadout into its 16-byte card format
+ *
+ * @param loadout Loadout to pack
+ * @param raw Output, LOADOUT_SIZE bytes
+ */
+void loadout_encode(const loadout_t *loadout, uint8_t *raw);
+
+/**
+ * Unpack 16 bytes read from a card
+ *
+ * @param raw LOADOUT_SIZE bytes
+ * @param loadout Output
+ * @return false if the bytes are not a valid loadout
+ */
+bool loadout_decode(const uint8_t *raw, loadout_t *loadout);
+
+/**
+ * Look a card up in the cache
+ *
+ * @param uid UID bytes
+ * @param uid_len Number of UID bytes
+ * @param has_loadout Set to whether the card carries a loadout
+ * @param loadout Filled if it does
+ * @return true if the card was read earlier this session
+ */
+bool loadout_cache_lookup(const uint8_t *uid, uint8_t uid_len,
+                          bool *has_loadout, loadout_t *loadout);
+
+/**
+ * Forget what is cached for a card, the next tap reads it again
+ */
+void loadout_cache_invalidate(const uint8_t *uid, uint8_t uid_len);
+
+/**
+ * Empty the cache
+ */
+void loadout_cache_clear(void);
+
+/**
+ * Start reading the loadout of a target listed by the last scan
+ * The result is cached when the read finishes
+ *
+ * @param xfer Transfer state
+ * @param dev PN532 the target was listed on
+ * @param target Target from pn532_uart_get_passive_targets()
+ * @return false if the PN532 is busy
+ */
+bool loadout_start_read(loadout_xfer_t *xfer, pn532_uart_t *dev, const pn532_target_t *target);
+
+/**
+ * Start writing a loadout to a target listed by the last scan
+ * Invalidates the card's cache entry right away
+ *
+ * @param xfer Transfer state
+ * @param dev PN532 the target was listed on
+ * @param target Target from pn532_uart_get_passive_targets()
+ * @param loadout Loadout to write
+ * @return false if the PN532 is busy
+ */
+bool loadout_start_write(loadout_xfer_t *xfer, pn532_uart_t *dev,
+                         const pn532_target_t *target, const loadout_t *loadout);
+
+/**
+ * Advance a read or write, never blocks
+ *
+ * @param xfer Transfer state
+ * @return LOADOUT_BUSY until the transfer finishes
+ */
+loadout_status_t loadout_poll(loadout_xfer_t *xfer);
+
+#endif // LOADOUT_HH
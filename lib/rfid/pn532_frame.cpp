@@ -0,0 +1,117 @@
+#include "pn532_frame.hh"
+#include <string.h>
+
+const uint8_t PN532_ACK_FRAME[6] = {0x00, 0x00, 0xFF, 0x00, 0xFF, 0x00};
+
+static uint8_t calc_len_checksum(uint8_t len) {
+    return (uint8_t)(~len + 1);
+}
+
+static uint8_t calc_data_checksum(uint8_t tfi, const uint8_t *data, uint8_t len) {
+    uint16_t sum = tfi;
+    for (uint8_t i = 0; i < len; i++) {
+        sum += data[i];
+    }
+    return (uint8_t)(~sum + 1);
+}
+
+void pn532_parser_reset(pn532_parser_t *p) {
+    p->state = PN532_RX_PREAMBLE;
+    p->len = 0;
+    p->sum = 0;
+    p->tfi = 0;
+    p->data_len = 0;
+}
+
+// Drop the current frame. A 00 may already be the start of the next one.
+static pn532_frame_result_t resync(pn532_parser_t *p, uint8_t c) {
+    pn532_parser_reset(p);
+    if (c == PN532_STARTCODE1) p->state = PN532_RX_START;
+    return PN532_FRAME_ERROR;
+}
+
+pn532_frame_result_t pn532_parser_feed(pn532_parser_t *p, uint8_t c) {
+    switch (p->state) {
+        case PN532_RX_PREAMBLE:
+            if (c == PN532_STARTCODE1) p->state = PN532_RX_START;
+            break;
+
+        case PN532_RX_START:
+            // Any number of 00s may precede the FF
+            if (c == PN532_STARTCODE2) p->state = PN532_RX_LEN;
+            else if (c != PN532_STARTCODE1) p->state = PN532_RX_PREAMBLE;
+            break;
+
+        case PN532_RX_LEN:
+            p->len = c;
+            p->state = PN532_RX_LCS;
+            break;
+
+        case PN532_RX_LCS:
+            // 00 FF is ACK, FF 00 is NACK
+            if (p->len == 0x00 && c == 0xFF) {
+                pn532_parser_reset(p);
+                return PN532_FRAME_ACK;
+            }
+            if (p->len == 0xFF && c == 0x00) {
+                pn532_parser_reset(p);
+                return PN532_FRAME_NACK;
+            }
+            // Extended frames (FF FF) fail the LCS check and are dropped
+            if ((uint8_t)(p->len + c) != 0x00 || p->len == 0x00) {
+                return resync(p, c);
+            }
+            p->state = PN532_RX_TFI;
+            break;
+
+        case PN532_RX_TFI:
+            p->tfi = c;
+            p->sum = c;
+            p->data_len = 0;
+            p->state = (p->len > 1) ? PN532_RX_DATA : PN532_RX_DCS;
+            break;
+
+        case PN532_RX_DATA:
+            p->data[p->data_len++] = c;
+            p->sum += c;
+            if (p->data_len == p->len - 1) p->state = PN532_RX_DCS;
+            break;
+
+        case PN532_RX_DCS:
+            if ((uint8_t)(p->sum + c) != 0x00) {
+                return resync(p, c);
+            }
+            p->state = PN532_RX_PREAMBLE;
+            return PN532_FRAME_DATA;
+    }
+
+    return PN532_FRAME_PENDING;
+}
+
+size_t pn532_frame_build(uint8_t *out, uint8_t tfi, uint8_t cmd,
+                         const uint8_t *params, uint8_t params_len) {
+    if (params_len > PN532_FRAME_MAX_DATA - 1) return 0;
+
+    uint8_t len = params_len + 2;  // TFI + CMD + params
+    size_t idx = 0;
+
+    // Build frame: PRE + START1 + START2 + LEN + LCS + TFI + CMD + PARAMS + DCS + POST
+    out[idx++] = PN532_PREAMBLE;
+    out[idx++] = PN532_STARTCODE1;
+    out[idx++] = PN532_STARTCODE2;
+    out[idx++] = len;
+    out[idx++] = calc_len_checksum(len);
+    out[idx++] = tfi;
+    out[idx++] = cmd;
+
+    if (params_len > 0 && params) {
+        memcpy(out + idx, params, params_len);
+        idx += params_len;
+    }
+
+    // calc_data_checksum adds TFI to the sum, then sums CMD + params
+    out[idx++] = calc_data_checksum(tfi, &out[6], len - 1);
+    out[idx++] = PN532_POSTAMBLE;
+
+    return idx;
+}
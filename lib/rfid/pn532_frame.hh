@@ -0,0 +1,91 @@
+#ifndef PN532_FRAME_HH
+#define PN532_FRAME_HH
+
+#include <stdint.h>
+#include <stddef.h>
+
+// PN532 Frame constants
+#define PN532_PREAMBLE      0x00
+#define PN532_STARTCODE1    0x00
+#define PN532_STARTCODE2    0xFF
+#define PN532_POSTAMBLE     0x00
+
+#define PN532_HOST_TO_PN532 0xD4
+#define PN532_PN532_TO_HOST 0xD5
+#define PN532_ERROR_TFI     0x7F
+
+// Commands
+#define PN532_CMD_GETFIRMWAREVERSION  0x02
+#define PN532_CMD_SAMCONFIGURATION    0x14
+#define PN532_CMD_INDATAEXCHANGE      0x40
+#define PN532_CMD_INLISTPASSIVETARGET 0x4A
+
+// LEN is one byte and covers TFI + data, so at most 254 data bytes
+#define PN532_FRAME_MAX_DATA 254
+
+// PRE + START1 + START2 + LEN + LCS + TFI + data + DCS + POST
+#define PN532_FRAME_MAX_SIZE (PN532_FRAME_MAX_DATA + 8)
+
+// ACK frame: 00 00 FF 00 FF 00
+extern const uint8_t PN532_ACK_FRAME[6];
+
+typedef enum {
+    PN532_RX_PREAMBLE,   // hunting for 00
+    PN532_RX_START,      // saw 00, waiting for FF
+    PN532_RX_LEN,
+    PN532_RX_LCS,
+    PN532_RX_TFI,
+    PN532_RX_DATA,
+    PN532_RX_DCS,
+} pn532_rx_state_t;
+
+typedef enum {
+    PN532_FRAME_PENDING,  // need more bytes
+    PN532_FRAME_ACK,
+    PN532_FRAME_NACK,
+    PN532_FRAME_DATA,     // complete data frame in parser->tfi / data / data_len
+    PN532_FRAME_ERROR,    // bad LCS/DCS, parser already resynced
+} pn532_frame_result_t;
+
+typedef struct {
+    pn532_rx_state_t state;
+    uint8_t len;          // LEN field (TFI + data)
+    uint8_t sum;          // running TFI + data sum for DCS
+    uint8_t tfi;
+    uint8_t data_len;     // bytes of data received so far
+    uint8_t data[PN532_FRAME_MAX_DATA];
+} pn532_parser_t;
+
+/**
+ * Reset parser to hunt for the next start code
+ *
+ * @param p Pointer to parser
+ */
+void pn532_parser_reset(pn532_parser_t *p);
+
+/**
+ * Feed one received byte into the frame parser
+ *
+ * Data frames are reported as soon as the DCS byte checks out, the
+ * postamble is consumed as part of hunting for the next frame.
+ *
+ * @param p Pointer to parser
+ * @param c Received byte
+ * @return PN532_FRAME_PENDING until a full frame (or an error) is seen
+ */
+pn532_frame_result_t pn532_parser_feed(pn532_parser_t *p, uint8_t c);
+
+/**
+ * Build a normal information frame
+ *
+ * @param out Output buffer, at least PN532_FRAME_MAX_SIZE bytes
+ * @param tfi PN532_HOST_TO_PN532 or PN532_PN532_TO_HOST
+ * @param cmd Command (or response) code
+ * @param params Parameter bytes following the command code
+ * @param params_len Number of parameter bytes
+ * @return frame length in bytes, 0 if params do not fit
+ */
+size_t pn532_frame_build(uint8_t *out, uint8_t tfi, uint8_t cmd,
+                         const uint8_t *params, uint8_t params_len);
+
+#endif // PN532_FRAME_HH
@@ -3,15 +3,75 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "pico/stdlib.h"
 #include "hardware/uart.h"
 
+#include "pn532_frame.hh"
+
+// Must stay 256 so the uint8_t ring indices wrap on their own
+#define PN532_RX_RING_SIZE 256
+
+// Time allowed for the PN532 to ACK a command frame
+#define PN532_ACK_TIMEOUT_MS 100
+
+typedef enum {
+    PN532_IDLE,           // nothing submitted yet
+    PN532_WAIT_ACK,       // command sent, waiting for ACK
+    PN532_WAIT_RESPONSE,  // ACKed, waiting for response frame
+    PN532_DONE,           // response received, see pn532_uart_response()
+    PN532_ERROR,          // NACK, error frame or unexpected response
+    PN532_TIMEOUT,        // no ACK/response in time, command aborted
+} pn532_status_t;
+
+// InListPassiveTarget returns at most two targets
+#define PN532_MAX_TARGETS 2
+
 typedef struct {
+    uint8_t tg;           // logical target number
+    uint8_t sens_res[2];  // ATQA
+    uint8_t sel_res;      // SAK
+    uint8_t uid_len;
+    uint8_t uid[10];
+} pn532_target_t;
+
+typedef struct pn532_uart pn532_uart_t;
+
+/**
+ * Completion callback, called from pn532_uart_poll() (never from the IRQ)
+ *
+ * @param dev Device the command ran on
+ * @param status PN532_DONE, PN532_ERROR or PN532_TIMEOUT
+ * @param ctx User pointer passed to pn532_uart_submit()
+ */
+typedef void (*pn532_callback_t)(pn532_uart_t *dev, pn532_status_t status, void *ctx);
+
+struct pn532_uart {
     uart_inst_t *uart;
-} pn532_uart_t;
+
+    // Filled by the UART RX IRQ, drained by pn532_uart_poll()
+    uint8_t rx_ring[PN532_RX_RING_SIZE];
+    volatile uint8_t rx_head;
+    volatile uint8_t rx_tail;
+    volatile uint32_t rx_overruns;
+
+    pn532_parser_t parser;
+
+    // Command in flight
+    volatile pn532_status_t status;
+    uint8_t cmd;
+    uint32_t response_timeout_ms;
+    absolute_time_t deadline;
+    pn532_callback_t callback;
+    void *ctx;
+
+    // Response payload (bytes after the response code)
+    uint8_t response[PN532_FRAME_MAX_DATA];
+    uint8_t response_len;
+};
 
 /**
- * Initialize PN532 via UART
- * 
+ * Initialize PN532 via UART and hook up the RX interrupt
+ *
  * @param dev Pointer to pn532_uart_t structure
  * @param uart UART instance (uart0 or uart1)
  * @param tx_pin GPIO pin for UART TX
@@ -21,24 +81,141 @@ typedef struct {
 void pn532_uart_init(pn532_uart_t *dev, uart_inst_t *uart, uint tx_pin, uint rx_pin, uint baud_rate);
 
 /**
- * Get firmware version from PN532
- * 
+ * Send a command frame and return immediately
+ *
+ * @param dev Pointer to pn532_uart_t structure
+ * @param cmd Command code
+ * @param params Parameter bytes (may be NULL)
+ * @param params_len Number of parameter bytes
+ * @param timeout_ms Time allowed for the response after the ACK
+ * @param callback Called once on completion (may be NULL)
+ * @param ctx Passed to callback
+ * @return false if a command is already in flight
+ */
+bool pn532_uart_submit(pn532_uart_t *dev, uint8_t cmd,
+                       const uint8_t *params, uint8_t params_len,
+                       uint32_t timeout_ms,
+                       pn532_callback_t callback, void *ctx);
+
+/**
+ * Parse received bytes and advance the command state machine
+ * Never blocks, call once per game loop
+ *
+ * @param dev Pointer to pn532_uart_t structure
+ * @return current status
+ */
+pn532_status_t pn532_uart_poll(pn532_uart_t *dev);
+
+/**
+ * @return true while a command is waiting for its ACK or response
+ */
+bool pn532_uart_busy(const pn532_uart_t *dev);
+
+/**
+ * Cancel the command in flight (sends ACK, which aborts the PN532)
+ *
+ * @param dev Pointer to pn532_uart_t structure
+ */
+void pn532_uart_abort(pn532_uart_t *dev);
+
+/**
+ * Response payload of the last completed command
+ *
+ * @param dev Pointer to pn532_uart_t structure
+ * @param len Pointer to store payload length
+ * @return pointer to payload, valid until the next submit
+ */
+const uint8_t *pn532_uart_response(const pn532_uart_t *dev, uint8_t *len);
+
+/**
+ * Spin on pn532_uart_poll() until the command completes (boot-time only)
+ *
+ * @param dev Pointer to pn532_uart_t structure
+ * @return final status
+ */
+pn532_status_t pn532_uart_wait(pn532_uart_t *dev);
+
+/**
+ * Get firmware version from PN532 (blocking)
+ *
  * @param dev Pointer to pn532_uart_t structure
  * @return 32-bit firmware version (IC|Ver|Rev|Support) or 0 on failure
  */
 uint32_t pn532_uart_get_firmware_version(pn532_uart_t *dev);
 
 /**
- * Configure SAM (Secure Access Module)
- * 
+ * Configure SAM (Secure Access Module) (blocking)
+ *
  * @param dev Pointer to pn532_uart_t structure
  * @return true on success, false on failure
  */
 bool pn532_uart_sam_config(pn532_uart_t *dev);
 
 /**
- * Read passive ISO14443A target (MIFARE cards, etc.)
- * 
+ * Start an InListPassiveTarget for ISO14443A targets without blocking
+ *
+ * @param dev Pointer to pn532_uart_t structure
+ * @param max_targets MaxTg, 1 or 2 (the PN532 limit)
+ * @param timeout_ms Time to wait for a tag after the ACK
+ * @param callback Called once on completion (may be NULL)
+ * @param ctx Passed to callback
+ * @return false if a command is already in flight
+ */
+bool pn532_uart_start_passive_target(pn532_uart_t *dev, uint8_t max_targets,
+                                     uint32_t timeout_ms,
+                                     pn532_callback_t callback, void *ctx);
+
+/**
+ * Parse the variable-length target list of a completed InListPassiveTarget
+ *
+ * @param dev Pointer to pn532_uart_t structure
+ * @param targets Array to fill
+ * @param max_targets Size of targets
+ * @return number of targets stored (0 if none or malformed)
+ */
+uint8_t pn532_uart_get_passive_targets(const pn532_uart_t *dev,
+                                       pn532_target_t *targets, uint8_t max_targets);
+
+/**
+ * Pull the first UID out of a completed InListPassiveTarget response
+ *
+ * @param dev Pointer to pn532_uart_t structure
+ * @param uid_buf Buffer to store UID (at least 10 bytes)
+ * @param uid_len Pointer to store UID length
+ * @return true if a target was listed
+ */
+bool pn532_uart_get_passive_target(const pn532_uart_t *dev, uint8_t *uid_buf, uint8_t *uid_len);
+
+/**
+ * Send card-level bytes to a target listed by the last InListPassiveTarget,
+ * without blocking (InDataExchange)
+ *
+ * @param dev Pointer to pn532_uart_t structure
+ * @param tg Logical target number from pn532_target_t
+ * @param data Bytes for the card, e.g. NTAG READ (0x30, page)
+ * @param len Number of bytes
+ * @param timeout_ms Time allowed for the card to answer after the ACK
+ * @param callback Called once on completion (may be NULL)
+ * @param ctx Passed to callback
+ * @return false if a command is already in flight or data is too long
+ */
+bool pn532_uart_start_data_exchange(pn532_uart_t *dev, uint8_t tg,
+                                    const uint8_t *data, uint8_t len,
+                                    uint32_t timeout_ms,
+                                    pn532_callback_t callback, void *ctx);
+
+/**
+ * Card reply of a completed InDataExchange
+ *
+ * @param dev Pointer to pn532_uart_t structure
+ * @param len Pointer to store reply length
+ * @return pointer to the reply, NULL if the PN532 reported an error
+ */
+const uint8_t *pn532_uart_get_data_exchange(const pn532_uart_t *dev, uint8_t *len);
+
+/**
+ * Read passive ISO14443A target (MIFARE cards, etc.) (blocking)
+ *
  * @param dev Pointer to pn532_uart_t structure
  * @param uid_buf Buffer to store UID (at least 10 bytes)
  * @param uid_len Pointer to store UID length
@@ -50,4 +227,4 @@ bool pn532_uart_read_passive_target(pn532_uart_t *dev,
                                     uint8_t *uid_len,
                                     uint32_t timeout_ms);
 
-#endif // PN532_UART_HH
\ No newline at end of file
+#endif // PN532_UART_HH
@@ -1,54 +1,247 @@
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h>
 #include "pico/stdlib.h"
 
 #include "rfid.hh"
 #include "rfid_reader_uart.hh"
+#include "tag_registry.hh"
+#include "soft_timer.hh"
+#include "log.hh"
 
-#define RFID_TIMER_MS 1000
+// Scans no longer block, so the reader can be polled often
+#define RFID_TIMER_MS 250
+
+// Scans a card has to be missing from before it counts as removed
+#define LEAVE_MISSES 2
+
+#define PRESENCE_SLOTS 4
+#define EVENT_QUEUE_SIZE 8
+
+struct Presence {
+    bool used;
+    bool needs_read;    // not in the loadout cache, arrive after the read
+    bool needs_write;   // rfid_write_loadout() was armed when it arrived
+    pn532_target_t target;
+    uint8_t misses;
+    TowerType tower;
+    bool has_loadout;
+    loadout_t loadout;
+};
 
 volatile bool rfid_flag = false;
-uint8_t uid[10];
-uint8_t uid_len;
-
-TowerType match_monkey(uint8_t rfid_tag[10]) {
-    switch (rfid_tag[1]) {
-        case 0xC7: return dart;
-        case 0x76: return ninja;
-        case 0x35: return bomb;
-        case 0xD7: return sniper;
-    }
+static SoftTimer scan_timer;
+
+static Presence presence[PRESENCE_SLOTS];
+static RfidEvent events[EVENT_QUEUE_SIZE];
+static uint8_t event_head = 0;
+static uint8_t event_count = 0;
+
+static bool learning = false;
+static TowerType learn_tower = blank;
+
+static bool writing = false;
+static loadout_t write_loadout;
+
+// Page read/write in flight, for one presence slot
+static loadout_xfer_t xfer;
+static Presence *xfer_slot = NULL;
+
+TowerType match_monkey(const uint8_t *rfid_tag, uint8_t len) {
+    return tag_registry_lookup(rfid_tag, len);
 }
 
-void rfid_isr() {
-    hw_clear_bits(&timer0_hw->intr, 1 << 1);
+static void learn_card(const uint8_t *rfid_tag, uint8_t len) {
+    learning = false;
 
-    rfid_flag = true;
+    if (!tag_registry_bind(rfid_tag, len, learn_tower)) {
+        LOG("Learn failed (registry or store full?)");
+        return;
+    }
+    LOG("Learned card as %d (%d cards)", learn_tower, tag_registry_count());
+}
 
-    uint32_t target = timer0_hw->timerawl + RFID_TIMER_MS * 1000;
-    timer0_hw->alarm[1] = target;
+static void rfid_tick(void *ctx) {
+    (void)ctx;
+    rfid_flag = true;
 }
 
 void init_rfid() {
+    tag_registry_init();
     pn532_uart_reader_init();
-    
-    timer0_hw->inte |= 1 << 1;
 
-    uint alarm1_irq = timer_hardware_alarm_get_irq_num(timer0_hw, 1);
-    irq_set_exclusive_handler(alarm1_irq, rfid_isr);
-    irq_set_enabled(alarm1_irq, true);
+    soft_timer_start(&scan_timer, RFID_TIMER_MS * 1000, RFID_TIMER_MS * 1000, rfid_tick, NULL);
+}
+
+static void push_event(RfidEventType type, const Presence *p) {
+    if (event_count == EVENT_QUEUE_SIZE) return;
+
+    RfidEvent *event = &events[(event_head + event_count) % EVENT_QUEUE_SIZE];
+    event->type = type;
+    event->time_us = time_us_32();
+    event->tower = p->tower;
+    event->uid_len = p->target.uid_len;
+    memcpy(event->uid, p->target.uid, p->target.uid_len);
+    event->has_loadout = p->has_loadout;
+    if (p->has_loadout) event->loadout = p->loadout;
+    event_count++;
+}
+
+// A loadout on the card beats the registry binding
+static void apply_loadout(Presence *p, bool has_loadout, const loadout_t *loadout) {
+    p->has_loadout = has_loadout;
+    if (!has_loadout) return;
+
+    p->loadout = *loadout;
+    if (loadout->tower < blank) p->tower = (TowerType)loadout->tower;
+}
+
+// Turns one scan's target list into debounced arrive/leave edges
+static void update_presence(const pn532_target_t *targets, uint8_t count) {
+    bool seen[PRESENCE_SLOTS] = {false};
+
+    for (uint8_t t = 0; t < count; t++) {
+        const pn532_target_t *target = &targets[t];
+        int slot = -1;
+        int free_slot = -1;
+
+        for (int i = 0; i < PRESENCE_SLOTS; i++) {
+            if (!presence[i].used) {
+                if (free_slot < 0) free_slot = i;
+                continue;
+            }
+            if (presence[i].target.uid_len == target->uid_len &&
+                memcmp(presence[i].target.uid, target->uid, target->uid_len) == 0) {
+                slot = i;
+                break;
+            }
+        }
+
+        if (slot >= 0) {
+            // Tg can change between scans
+            presence[slot].target = *target;
+            presence[slot].misses = 0;
+            seen[slot] = true;
+            continue;
+        }
+        if (free_slot < 0) continue;
+
+        if (learning) learn_card(target->uid, target->uid_len);
+
+        Presence *p = &presence[free_slot];
+        p->used = true;
+        p->target = *target;
+        p->misses = 0;
+        p->tower = match_monkey(target->uid, target->uid_len);
+        p->has_loadout = false;
+        seen[free_slot] = true;
 
-    uint32_t target = timer0_hw->timerawl + RFID_TIMER_MS * 1000;
-    timer0_hw->alarm[1] = target;
+        if (writing) {
+            writing = false;
+            p->needs_write = true;
+            p->needs_read = false;
+            continue;
+        }
+
+        bool has_loadout;
+        loadout_t loadout;
+        if (loadout_cache_lookup(target->uid, target->uid_len, &has_loadout, &loadout)) {
+            apply_loadout(p, has_loadout, &loadout);
+            push_event(tag_arrived, p);
+        } else {
+            p->needs_read = true;
+        }
+    }
+
+    for (int i = 0; i < PRESENCE_SLOTS; i++) {
+        if (!presence[i].used || seen[i]) continue;
+        if (++presence[i].misses >= LEAVE_MISSES) {
+            push_event(tag_left, &presence[i]);
+            presence[i].used = false;
+        }
+    }
+}
+
+// Runs page reads/writes for new cards one at a time. Targets stay
+// selected until the next scan, so scans wait until this is done.
+// Returns true while there is card work left
+static bool service_loadouts() {
+    if (xfer_slot) {
+        loadout_status_t status = loadout_poll(&xfer);
+        if (status == LOADOUT_BUSY) return true;
+
+        Presence *p = xfer_slot;
+        xfer_slot = NULL;
+        p->needs_read = false;
+        p->needs_write = false;
+
+        // Card gone or unreadable: still arrive, with the registry tower
+        if (status == LOADOUT_DONE) apply_loadout(p, xfer.has_loadout, &xfer.loadout);
+        push_event(tag_arrived, p);
+    }
+
+    for (int i = 0; i < PRESENCE_SLOTS; i++) {
+        Presence *p = &presence[i];
+        if (!p->used || !(p->needs_read || p->needs_write)) continue;
+
+        bool started = p->needs_write
+            ? pn532_uart_start_loadout_write(&xfer, &p->target, &write_loadout)
+            : pn532_uart_start_loadout_read(&xfer, &p->target);
+
+        if (started) {
+            xfer_slot = p;
+            return true;
+        }
+
+        // Reader not usable, don't hold the card back
+        p->needs_read = false;
+        p->needs_write = false;
+        push_event(tag_arrived, p);
+    }
+
+    return false;
 }
 
-TowerType sample_rfid() {
-    if (pn532_uart_read_uid(uid, &uid_len)) {
-        printf("Tag scanned\n");
-        return match_monkey(uid);
-    } else {
-        printf("No tag\n");
-        return blank;
+bool poll_rfid(RfidEvent *event) {
+    pn532_target_t targets[PN532_MAX_TARGETS];
+    uint8_t count = 0;
+
+    switch (pn532_uart_poll_targets(targets, &count)) {
+        case RFID_SCAN_TAG:
+        case RFID_SCAN_NO_TAG:
+            update_presence(targets, count);
+            break;
+        default:
+            break;
     }
+
+    bool busy = service_loadouts();
+
+    // Timer only kicks off a scan, the reply is collected on later calls.
+    // A scan deselects the cards, so it waits for pending page reads
+    if (rfid_flag && !busy) {
+        rfid_flag = false;
+        pn532_uart_start_scan();
+    }
+
+    if (event_count == 0) return false;
+
+    *event = events[event_head];
+    event_head = (event_head + 1) % EVENT_QUEUE_SIZE;
+    event_count--;
+    return true;
+}
+
+void rfid_learn(TowerType tower) {
+    learn_tower = tower;
+    learning = true;
 }
 
+bool rfid_learning() {
+    return learning;
+}
+
+void rfid_write_loadout(const loadout_t *loadout) {
+    write_loadout = *loadout;
+    writing = true;
+}
@@ -1,7 +1,9 @@
 #ifndef RFID_HH
 #define RFID_HH
 
+#include <stdint.h>
 #include "tower.hh"
+#include "loadout.hh"
 
 extern volatile bool rfid_flag;
 
@@ -10,12 +12,55 @@ extern volatile bool rfid_flag;
  */
 void init_rfid();
 
+enum RfidEventType {
+    tag_arrived,
+    tag_left,
+};
+
+struct RfidEvent {
+    RfidEventType type;
+    uint32_t time_us;    // time_us_32() when the scan reply came in
+    TowerType tower;     // what the card is bound to
+    uint8_t uid[10];
+    uint8_t uid_len;
+    bool has_loadout;    // card carries its own loadout
+    loadout_t loadout;   // tower/level/name written on the card
+};
+
+/**
+ * @brief services the rfid reader without blocking, call every loop
+ * 
+ * starts a scan (up to two cards) each time the timer fires, collects
+ * the reply on a later call and tracks which cards are on the reader.
+ * a card arrives the first scan it shows up in and leaves after it is
+ * missing from two scans in a row. the first time a card is seen its
+ * loadout pages are read, later taps come from the cache
+ * 
+ * @param event set to the next arrive/leave event
+ * @return true if an event was returned, call again until false
+ */
+bool poll_rfid(RfidEvent *event);
+
+/**
+ * @brief arms learn mode: the next card scanned is bound to 'tower'
+ * and saved to flash (blank unbinds the card)
+ * 
+ * @param tower TowerType to bind
+ */
+void rfid_learn(TowerType tower);
+
+/**
+ * @brief true while learn mode is waiting for a card
+ */
+bool rfid_learning();
+
 /**
- * @brief samples rfid one time returns scanned_tower
+ * @brief arms a loadout write: the next card placed on the reader gets
+ * 'loadout' written to it, its arrive event reports the new loadout
  * 
- * @return TowerType of rfid scanned
+ * @param loadout tower, upgrade level and player name to write
  */
-TowerType sample_rfid();
+void rfid_write_loadout(const loadout_t *loadout);
 
 
 #endif // RFID_HH
\ No newline at end of file
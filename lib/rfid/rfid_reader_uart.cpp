@@ -4,8 +4,12 @@
 #include "rfid_reader_uart.hh"
 #include "pn532_uart.hh"
 
+// Time the PN532 gets to find a tag before the scan is aborted
+#define SCAN_TIMEOUT_MS 200
+
 static pn532_uart_t pn532;
 static bool pn532_ready = false;
+static bool scan_pending = false;
 
 void pn532_uart_reader_init(void) {
     // RP2350 Proton Board connections for UART
@@ -55,5 +59,37 @@ bool pn532_uart_read_uid(uint8_t *uid, uint8_t *uid_len) {
     }
     
     // Use a timeout appropriate for tag reading
-    return pn532_uart_read_passive_target(&pn532, uid, uid_len, 200);
-}
\ No newline at end of file
+    return pn532_uart_read_passive_target(&pn532, uid, uid_len, SCAN_TIMEOUT_MS);
+}
+
+bool pn532_uart_start_scan(void) {
+    if (!pn532_ready || scan_pending) return false;
+
+    // Up to two cards resolve in one round-trip
+    scan_pending = pn532_uart_start_passive_target(&pn532, PN532_MAX_TARGETS,
+                                                   SCAN_TIMEOUT_MS, NULL, NULL);
+    return scan_pending;
+}
+
+rfid_scan_result_t pn532_uart_poll_targets(pn532_target_t *targets, uint8_t *count) {
+    if (!pn532_ready) return RFID_SCAN_IDLE;
+
+    pn532_status_t status = pn532_uart_poll(&pn532);
+    if (!scan_pending) return RFID_SCAN_IDLE;
+    if (status == PN532_WAIT_ACK || status == PN532_WAIT_RESPONSE) return RFID_SCAN_BUSY;
+
+    scan_pending = false;
+    *count = pn532_uart_get_passive_targets(&pn532, targets, PN532_MAX_TARGETS);
+    return (*count > 0) ? RFID_SCAN_TAG : RFID_SCAN_NO_TAG;
+}
+
+bool pn532_uart_start_loadout_read(loadout_xfer_t *xfer, const pn532_target_t *target) {
+    if (!pn532_ready || scan_pending) return false;
+    return loadout_start_read(xfer, &pn532, target);
+}
+
+bool pn532_uart_start_loadout_write(loadout_xfer_t *xfer, const pn532_target_t *target,
+                                    const loadout_t *loadout) {
+    if (!pn532_ready || scan_pending) return false;
+    return loadout_start_write(xfer, &pn532, target, loadout);
+}
@@ -3,6 +3,15 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "pn532_uart.hh"
+#include "loadout.hh"
+
+typedef enum {
+    RFID_SCAN_IDLE,    // no scan started
+    RFID_SCAN_BUSY,    // scan in flight
+    RFID_SCAN_TAG,     // scan finished with at least one tag
+    RFID_SCAN_NO_TAG,  // scan finished without a tag
+} rfid_scan_result_t;
 
 /**
  * Initialize PN532 via UART
@@ -12,7 +21,7 @@
 void pn532_uart_reader_init(void);
 
 /**
- * Try to read a tag UID
+ * Try to read a tag UID (blocking, up to ~300 ms)
  * 
  * @param uid Buffer to store UID (at least 10 bytes)
  * @param uid_len Pointer to store UID length
@@ -20,4 +29,42 @@ void pn532_uart_reader_init(void);
  */
 bool pn532_uart_read_uid(uint8_t *uid, uint8_t *uid_len);
 
+/**
+ * Start a tag scan without waiting for the result
+ * 
+ * @return false if the reader is not ready or a scan is already running
+ */
+bool pn532_uart_start_scan(void);
+
+/**
+ * Advance the scan in flight, never blocks
+ * Reports RFID_SCAN_TAG / RFID_SCAN_NO_TAG once per finished scan
+ * 
+ * @param targets Array of PN532_MAX_TARGETS to fill
+ * @param count Pointer to store number of targets found
+ * @return scan state
+ */
+rfid_scan_result_t pn532_uart_poll_targets(pn532_target_t *targets, uint8_t *count);
+
+/**
+ * Start reading the loadout of a card listed by the last scan
+ * Poll the transfer with loadout_poll()
+ * 
+ * @param xfer Transfer state
+ * @param target Target from pn532_uart_poll_targets()
+ * @return false if the reader is not ready or busy
+ */
+bool pn532_uart_start_loadout_read(loadout_xfer_t *xfer, const pn532_target_t *target);
+
+/**
+ * Start writing a loadout to a card listed by the last scan
+ * 
+ * @param xfer Transfer state
+ * @param target Target from pn532_uart_poll_targets()
+ * @param loadout Loadout to write
+ * @return false if the reader is not ready or busy
+ */
+bool pn532_uart_start_loadout_write(loadout_xfer_t *xfer, const pn532_target_t *target,
+                                    const loadout_t *loadout);
+
 #endif // RFID_READER_UART_H
\ No newline at end of file
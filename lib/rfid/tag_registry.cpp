@@ -0,0 +1,183 @@
+#include <string.h>
+#include "pico/stdlib.h"
+
+#include "tag_registry.hh"
+#include "kv_store.hh"
+
+// Store keys: "t" + UID -> tower, "seed" -> SEED_VERSION last bound
+#define KEY_PREFIX 't'
+static const char SEEDED_KEY[] = "seed";
+
+struct TagSlot {
+    uint8_t uid_len;  // 0 = empty
+    uint8_t uid[TAG_UID_MAX];
+    uint8_t tower;
+};
+
+struct SeedTag {
+    uint8_t uid_len;  // 0 ends the list
+    uint8_t uid[TAG_UID_MAX];
+    TowerType tower;
+};
+
+// Cards handed out before the registry existed. Only their second UID
+// byte was ever recorded (C7 dart, 76 ninja, 35 bomb, D7 sniper), list
+// each one's full UID here, lib/rfid/test.c prints it, and bump
+// SEED_VERSION. A store gets the list once per version, so unbinding or
+// rebinding a card sticks until the list changes. Version 0 is empty
+static const uint8_t SEED_VERSION = 0;
+
+static const SeedTag SEED_TAGS[] = {
+    {0, {0}, blank},
+};
+
+static_assert((TAG_REGISTRY_CAPACITY & (TAG_REGISTRY_CAPACITY - 1)) == 0, "capacity must be a power of two");
+
+static TagSlot table[TAG_REGISTRY_CAPACITY];
+static uint16_t entry_count = 0;
+
+// ====== Hashing ======
+
+static uint32_t hash_uid(const uint8_t *uid, uint8_t uid_len) {
+    // FNV-1a
+    uint32_t h = 2166136261u ^ uid_len;
+    for (uint8_t i = 0; i < uid_len; i++) {
+        h ^= uid[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static bool valid_uid_len(uint8_t uid_len) {
+    return uid_len == 4 || uid_len == 7 || uid_len == 10;
+}
+
+static bool slot_matches(const TagSlot *slot, const uint8_t *uid, uint8_t uid_len) {
+    return slot->uid_len == uid_len && memcmp(slot->uid, uid, uid_len) == 0;
+}
+
+// Index of the UID's slot, or of the empty slot where it would go
+static uint32_t find_slot(const uint8_t *uid, uint8_t uid_len) {
+    uint32_t mask = TAG_REGISTRY_CAPACITY - 1;
+    uint32_t i = hash_uid(uid, uid_len) & mask;
+
+    while (table[i].uid_len != 0 && !slot_matches(&table[i], uid, uid_len)) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+// Backward-shift delete keeps linear probing chains intact without tombstones
+static void remove_slot(uint32_t hole) {
+    uint32_t mask = TAG_REGISTRY_CAPACITY - 1;
+    uint32_t i = hole;
+
+    for (;;) {
+        i = (i + 1) & mask;
+        if (table[i].uid_len == 0) break;
+
+        uint32_t home = hash_uid(table[i].uid, table[i].uid_len) & mask;
+        // Move the entry back if its home is not within (hole, i]
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            table[hole] = table[i];
+            hole = i;
+        }
+    }
+
+    table[hole].uid_len = 0;
+    entry_count--;
+}
+
+// ====== Store ======
+
+static uint8_t make_key(const uint8_t *uid, uint8_t uid_len, uint8_t *key) {
+    key[0] = KEY_PREFIX;
+    memcpy(&key[1], uid, uid_len);
+    return uid_len + 1;
+}
+
+// RAM table only, persisting is up to the caller
+static bool table_bind(const uint8_t *uid, uint8_t uid_len, TowerType type) {
+    uint32_t i = find_slot(uid, uid_len);
+    TagSlot *slot = &table[i];
+
+    if (type == blank) {
+        if (slot->uid_len != 0) remove_slot(i);
+        return true;
+    }
+
+    if (slot->uid_len == 0) {
+        if (entry_count >= TAG_REGISTRY_MAX_ENTRIES) return false;
+        slot->uid_len = uid_len;
+        memcpy(slot->uid, uid, uid_len);
+        entry_count++;
+    }
+    slot->tower = (uint8_t)type;
+    return true;
+}
+
+static void load_binding(const uint8_t *key, uint8_t key_len,
+                         const uint8_t *value, uint16_t value_len, void *ctx) {
+    (void)ctx;
+    uint8_t uid_len = key_len - 1;
+    if (valid_uid_len(uid_len) && value_len == 1 && value[0] < blank) {
+        table_bind(&key[1], uid_len, (TowerType)value[0]);
+    }
+}
+
+static void seed_tags() {
+    // Nothing stored counts as version 0
+    uint8_t seeded = 0;
+    kv_get(SEEDED_KEY, sizeof(SEEDED_KEY) - 1, &seeded, 1);
+    if (seeded >= SEED_VERSION) return;
+
+    for (const SeedTag *tag = SEED_TAGS; tag->uid_len; tag++) {
+        tag_registry_bind(tag->uid, tag->uid_len, tag->tower);
+    }
+
+    seeded = SEED_VERSION;
+    kv_put(SEEDED_KEY, sizeof(SEEDED_KEY) - 1, &seeded, 1);
+}
+
+// ====== Public API ======
+
+void tag_registry_init() {
+    memset(table, 0, sizeof(table));
+    entry_count = 0;
+
+    const uint8_t prefix = KEY_PREFIX;
+    kv_foreach(&prefix, 1, load_binding, NULL);
+
+    seed_tags();
+}
+
+TowerType tag_registry_lookup(const uint8_t *uid, uint8_t uid_len) {
+    if (!valid_uid_len(uid_len)) return blank;
+
+    const TagSlot *slot = &table[find_slot(uid, uid_len)];
+    return (slot->uid_len != 0) ? (TowerType)slot->tower : blank;
+}
+
+bool tag_registry_bind(const uint8_t *uid, uint8_t uid_len, TowerType type) {
+    if (!valid_uid_len(uid_len)) return false;
+
+    // Room in the table first, so the store never holds what RAM can't
+    uint32_t i = find_slot(uid, uid_len);
+    if (type != blank && table[i].uid_len == 0 && entry_count >= TAG_REGISTRY_MAX_ENTRIES) {
+        return false;
+    }
+
+    uint8_t key[1 + TAG_UID_MAX];
+    uint8_t key_len = make_key(uid, uid_len, key);
+    uint8_t value = (uint8_t)type;
+
+    // A single append, never an erase, so this is fine mid-game
+    bool saved = (type == blank) ? kv_delete(key, key_len) : kv_put(key, key_len, &value, 1);
+    if (!saved) return false;
+
+    return table_bind(uid, uid_len, type);
+}
+
+uint16_t tag_registry_count() {
+    return entry_count;
+}
@@ -0,0 +1,51 @@
+#ifndef TAG_REGISTRY_HH
+#define TAG_REGISTRY_HH
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tower.hh"
+
+// Open-addressed table, must be a power of two
+#define TAG_REGISTRY_CAPACITY 512
+
+// Keeps the load factor under 2/3
+#define TAG_REGISTRY_MAX_ENTRIES 340
+
+#define TAG_UID_MAX 10
+
+/**
+ * @brief clears the table and loads saved bindings from the key-value
+ * store (mount it first)
+ */
+void tag_registry_init();
+
+/**
+ * @brief looks up a card by its full UID, O(1) on average
+ *
+ * @param uid UID bytes (4, 7 or 10)
+ * @param uid_len number of UID bytes
+ * @return bound TowerType, blank if the card is unknown
+ */
+TowerType tag_registry_lookup(const uint8_t *uid, uint8_t uid_len);
+
+/**
+ * @brief binds a card to a tower type and saves it, takes effect
+ * immediately
+ *
+ * binding to blank removes the card. saving appends one record to the
+ * key-value store and never erases
+ *
+ * @param uid UID bytes
+ * @param uid_len number of UID bytes
+ * @param type TowerType to bind
+ * @return false if the UID is invalid, the table is full or the store
+ * is out of space
+ */
+bool tag_registry_bind(const uint8_t *uid, uint8_t uid_len, TowerType type);
+
+/**
+ * @return number of registered cards
+ */
+uint16_t tag_registry_count();
+
+#endif // TAG_REGISTRY_HH
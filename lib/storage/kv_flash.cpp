@@ -0,0 +1,66 @@
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "hardware/flash.h"
+
+#include "kv_flash.hh"
+#include "kv_store.hh"
+
+#define KV_FLASH_OFFSET (PICO_FLASH_SIZE_BYTES - KV_FLASH_SECTORS * FLASH_SECTOR_SIZE)
+
+// A sector erase takes ~50 ms, a page program well under 1 ms
+#define ERASE_TIMEOUT_MS 500
+#define PROGRAM_TIMEOUT_MS 50
+
+struct FlashOp {
+    uint32_t offset;
+    const uint8_t *data;
+    uint32_t len;
+};
+
+static void (*pause_hook)(bool pause) = NULL;
+static kv_backend_t backend;
+
+static const uint8_t *kv_flash_map(uint32_t offset) {
+    return (const uint8_t *)(XIP_BASE + KV_FLASH_OFFSET + offset);
+}
+
+static void do_program(void *param) {
+    const FlashOp *op = (const FlashOp *)param;
+    flash_range_program(KV_FLASH_OFFSET + op->offset, op->data, op->len);
+}
+
+static void do_erase(void *param) {
+    const FlashOp *op = (const FlashOp *)param;
+    flash_range_erase(KV_FLASH_OFFSET + op->offset, FLASH_SECTOR_SIZE);
+}
+
+static bool kv_flash_program(uint32_t offset, const uint8_t *data, uint32_t len) {
+    FlashOp op = {offset, data, len};
+
+    // Parks core1 for well under a millisecond, fine mid-game
+    return flash_safe_execute(do_program, &op, PROGRAM_TIMEOUT_MS) == PICO_OK;
+}
+
+static bool kv_flash_erase(uint32_t offset) {
+    FlashOp op = {offset, NULL, 0};
+
+    // Let core1 finish its frame and blank the panel first, otherwise
+    // the row it was lighting stays on for the whole erase
+    if (pause_hook) pause_hook(true);
+    bool ok = flash_safe_execute(do_erase, &op, ERASE_TIMEOUT_MS) == PICO_OK;
+    if (pause_hook) pause_hook(false);
+    return ok;
+}
+
+bool kv_flash_init(void (*pause_display)(bool pause)) {
+    pause_hook = pause_display;
+
+    backend.sector_size = FLASH_SECTOR_SIZE;
+    backend.page_size = FLASH_PAGE_SIZE;
+    backend.sector_count = KV_FLASH_SECTORS;
+    backend.map = kv_flash_map;
+    backend.program = kv_flash_program;
+    backend.erase = kv_flash_erase;
+
+    return kv_mount(&backend);
+}
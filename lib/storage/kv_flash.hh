@@ -0,0 +1,30 @@
+#ifndef KV_FLASH_HH
+#define KV_FLASH_HH
+
+#include <stdbool.h>
+
+// Sectors in the store, the last ones in flash
+#define KV_FLASH_SECTORS 8
+
+/*  NOTES:
+
+    Flash can't be read while a sector is erased, and core1's HUB75
+    scan runs from flash, so scanning can't continue through an erase.
+    Instead core1 is parked at a frame boundary with the panel blanked
+    for the ~50 ms an erase takes. That is why kv_maintain() only runs
+    at boot and in menus. Page programs (every kv_put) take well under
+    a millisecond and just hold core1 through flash_safe_execute.
+
+*/
+
+/**
+ * @brief mounts the key-value store on the reserved flash region
+ *
+ * @param pause_display called with true before an erase and false
+ * after it, so the display can be parked at a frame boundary. may be
+ * NULL before core1 is running
+ * @return true if the store mounted
+ */
+bool kv_flash_init(void (*pause_display)(bool pause));
+
+#endif // KV_FLASH_HH
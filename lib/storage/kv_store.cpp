@@ -0,0 +1,574 @@
+#include <string.h>
+
+#include "kv_store.hh"
+
+#define SECTOR_MAGIC 0x474C564Bu  // "KVLG"
+#define REC_PUT 0x50              // 'P'
+#define REC_DEL 0x44              // 'D'
+
+// Sectors kept erased for compaction, puts never take the last one
+#define RESERVE_SECTORS 1
+
+#define MAX_PAGE_SIZE 256
+#define MAX_RECORD_SIZE (sizeof(RecordHeader) + KV_KEY_MAX + KV_VALUE_MAX)
+
+// Any record fits in three pages wherever it starts
+#define WRITE_BUF_SIZE (3 * MAX_PAGE_SIZE)
+
+struct SectorHeader {
+    uint32_t magic;
+    uint32_t seq;          // higher = newer
+    uint32_t erase_count;
+    uint32_t crc;          // over the fields above
+};
+
+struct RecordHeader {
+    uint8_t key_len;       // 0xFF = erased, end of log
+    uint8_t type;
+    uint16_t value_len;
+    uint32_t crc;          // over key_len..value_len, key and value
+};
+
+static_assert(sizeof(SectorHeader) == 16, "flash layout");
+static_assert(sizeof(RecordHeader) == 8, "flash layout");
+static_assert((KV_INDEX_SIZE & (KV_INDEX_SIZE - 1)) == 0, "index size must be a power of two");
+
+enum SectorState : uint8_t {
+    SECTOR_ERASED,   // blank, can be opened
+    SECTOR_LOG,      // holds records
+    SECTOR_DIRTY,    // foreign, torn or reclaimed, needs an erase
+};
+
+struct Sector {
+    SectorState state;
+    bool sealed;           // no more appends (full or torn tail)
+    uint32_t seq;
+    uint32_t erase_count;
+    uint32_t end;          // first free byte
+    uint32_t live;         // bytes of records the index points at
+};
+
+struct Slot {
+    uint32_t offset;       // record offset in the region, 0 = empty
+    uint32_t hash;
+};
+
+static const kv_backend_t *flash = NULL;
+static Sector sectors[KV_MAX_SECTORS];
+static Slot slots[KV_INDEX_SIZE];
+static uint16_t key_count = 0;
+
+static int head = -1;      // sector taking appends
+static uint32_t max_seq = 0;
+static uint32_t scanned = 0;
+
+static uint32_t crc_table[256];
+static uint8_t write_buf[WRITE_BUF_SIZE] __attribute__((aligned(4)));
+
+// ====== Helpers ======
+
+static void init_crc_table() {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int b = 0; b < 8; b++) {
+            c = (c >> 1) ^ (0xEDB88320u & -(c & 1));
+        }
+        crc_table[i] = c;
+    }
+}
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t *data, uint32_t len) {
+    for (uint32_t i = 0; i < len; i++) {
+        crc = crc_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+static uint32_t record_crc(const RecordHeader *rh, const uint8_t *key, const uint8_t *value) {
+    uint32_t crc = crc32_update(0xFFFFFFFFu, (const uint8_t *)rh, 4);
+    crc = crc32_update(crc, key, rh->key_len);
+    crc = crc32_update(crc, value, rh->value_len);
+    return ~crc;
+}
+
+static uint32_t header_crc(const SectorHeader *sh) {
+    return ~crc32_update(0xFFFFFFFFu, (const uint8_t *)sh, 12);
+}
+
+static uint32_t record_size(uint8_t key_len, uint16_t value_len) {
+    return (sizeof(RecordHeader) + key_len + value_len + 3) & ~3u;
+}
+
+static uint32_t hash_key(const uint8_t *key, uint8_t key_len) {
+    // FNV-1a
+    uint32_t h = 2166136261u;
+    for (uint8_t i = 0; i < key_len; i++) {
+        h ^= key[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static uint32_t sector_base(int s) {
+    return (uint32_t)s * flash->sector_size;
+}
+
+static int sector_of(uint32_t offset) {
+    return (int)(offset / flash->sector_size);
+}
+
+static RecordHeader read_header(uint32_t offset) {
+    RecordHeader rh;
+    memcpy(&rh, flash->map(offset), sizeof(rh));
+    return rh;
+}
+
+static bool is_blank(uint32_t offset, uint32_t len) {
+    const uint8_t *p = flash->map(offset);
+    for (uint32_t i = 0; i < len; i++) {
+        if (p[i] != 0xFF) return false;
+    }
+    return true;
+}
+
+static uint8_t count_state(SectorState state) {
+    uint8_t n = 0;
+    for (int s = 0; s < flash->sector_count; s++) {
+        if (sectors[s].state == state) n++;
+    }
+    return n;
+}
+
+// ====== Index ======
+
+static bool slot_matches(const Slot *slot, uint32_t hash, const uint8_t *key, uint8_t key_len) {
+    if (slot->hash != hash) return false;
+    RecordHeader rh = read_header(slot->offset);
+    return rh.key_len == key_len &&
+           memcmp(flash->map(slot->offset + sizeof(RecordHeader)), key, key_len) == 0;
+}
+
+// Index of the key's slot, or of the empty slot where it would go
+static uint32_t find_slot(const uint8_t *key, uint8_t key_len, uint32_t hash) {
+    uint32_t mask = KV_INDEX_SIZE - 1;
+    uint32_t i = hash & mask;
+
+    while (slots[i].offset != 0 && !slot_matches(&slots[i], hash, key, key_len)) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+static void account(uint32_t offset, bool add) {
+    RecordHeader rh = read_header(offset);
+    uint32_t size = record_size(rh.key_len, rh.value_len);
+    Sector *sector = &sectors[sector_of(offset)];
+    if (add) sector->live += size;
+    else sector->live -= size;
+}
+
+// Same backward-shift delete as the tag registry, no tombstones
+static void remove_slot(uint32_t hole) {
+    uint32_t mask = KV_INDEX_SIZE - 1;
+    uint32_t i = hole;
+
+    account(slots[hole].offset, false);
+
+    for (;;) {
+        i = (i + 1) & mask;
+        if (slots[i].offset == 0) break;
+
+        uint32_t home = slots[i].hash & mask;
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            slots[hole] = slots[i];
+            hole = i;
+        }
+    }
+
+    slots[hole].offset = 0;
+    key_count--;
+}
+
+// Points the key at a newer record, false if the index is full
+static bool index_put(const uint8_t *key, uint8_t key_len, uint32_t offset) {
+    uint32_t hash = hash_key(key, key_len);
+    uint32_t i = find_slot(key, key_len, hash);
+
+    if (slots[i].offset != 0) {
+        account(slots[i].offset, false);
+    } else {
+        if (key_count >= KV_MAX_KEYS) return false;
+        key_count++;
+    }
+
+    slots[i].offset = offset;
+    slots[i].hash = hash;
+    account(offset, true);
+    return true;
+}
+
+static void index_delete(const uint8_t *key, uint8_t key_len) {
+    uint32_t i = find_slot(key, key_len, hash_key(key, key_len));
+    if (slots[i].offset != 0) remove_slot(i);
+}
+
+// ====== Log ======
+
+// Walks one sector's records into the index
+static void replay(int s) {
+    Sector *sector = &sectors[s];
+    uint32_t base = sector_base(s);
+    uint32_t off = sizeof(SectorHeader);
+
+    while (off + sizeof(RecordHeader) <= flash->sector_size) {
+        RecordHeader rh = read_header(base + off);
+        if (rh.key_len == 0xFF) break;
+
+        uint32_t size = record_size(rh.key_len, rh.value_len);
+        bool sane = rh.key_len >= 1 && rh.key_len <= KV_KEY_MAX &&
+                    (rh.type == REC_PUT || rh.type == REC_DEL) &&
+                    rh.value_len <= KV_VALUE_MAX && off + size <= flash->sector_size;
+
+        const uint8_t *key = flash->map(base + off + sizeof(RecordHeader));
+        if (!sane || record_crc(&rh, key, key + rh.key_len) != rh.crc) {
+            // Torn by a power cut, nothing after it can be trusted
+            sector->sealed = true;
+            break;
+        }
+
+        if (rh.type == REC_PUT) index_put(key, rh.key_len, base + off);
+        else index_delete(key, rh.key_len);
+        off += size;
+    }
+
+    scanned += off;
+    sector->end = off;
+
+    // Half-programmed bytes past the end would corrupt the next append
+    if (!sector->sealed && off < flash->sector_size &&
+        !is_blank(base + off, flash->sector_size - off)) {
+        sector->sealed = true;
+    }
+}
+
+static bool program(uint32_t offset, const uint8_t *data, uint32_t len) {
+    uint32_t page = flash->page_size;
+    uint32_t first = offset & ~(page - 1);
+    uint32_t last = (offset + len - 1) & ~(page - 1);
+    uint32_t span = last - first + page;
+
+    // Unwritten bytes stay 0xFF, programming them is a no-op
+    memset(write_buf, 0xFF, span);
+    memcpy(&write_buf[offset - first], data, len);
+    if (!flash->program(first, write_buf, span)) return false;
+
+    return memcmp(flash->map(offset), data, len) == 0;
+}
+
+static uint32_t known_max_erase_count() {
+    uint32_t max = 0;
+    for (int s = 0; s < flash->sector_count; s++) {
+        if (sectors[s].erase_count > max) max = sectors[s].erase_count;
+    }
+    return max;
+}
+
+// Starts appending to the next erased sector around the ring
+static bool open_sector(bool compacting) {
+    uint8_t erased = count_state(SECTOR_ERASED);
+    if (erased == 0 || (!compacting && erased <= RESERVE_SECTORS)) return false;
+
+    int start = (head < 0) ? 0 : head + 1;
+    for (int i = 0; i < flash->sector_count; i++) {
+        int s = (start + i) % flash->sector_count;
+        if (sectors[s].state != SECTOR_ERASED) continue;
+
+        SectorHeader sh;
+        sh.magic = SECTOR_MAGIC;
+        sh.seq = max_seq + 1;
+        sh.erase_count = sectors[s].erase_count;
+        sh.crc = header_crc(&sh);
+
+        if (head >= 0) sectors[head].sealed = true;
+
+        if (!program(sector_base(s), (const uint8_t *)&sh, sizeof(sh))) {
+            sectors[s].state = SECTOR_DIRTY;
+            return false;
+        }
+
+        max_seq = sh.seq;
+        sectors[s].state = SECTOR_LOG;
+        sectors[s].sealed = false;
+        sectors[s].seq = sh.seq;
+        sectors[s].end = sizeof(SectorHeader);
+        sectors[s].live = 0;
+        head = s;
+        return true;
+    }
+    return false;
+}
+
+// Appends one record, returns its offset or 0
+static uint32_t append(const uint8_t *record, uint32_t size, bool compacting) {
+    if (head < 0 || sectors[head].sealed || sectors[head].end + size > flash->sector_size) {
+        if (!open_sector(compacting)) return 0;
+    }
+
+    Sector *sector = &sectors[head];
+    uint32_t offset = sector_base(head) + sector->end;
+
+    if (!program(offset, record, size)) {
+        // Bits that did flip are junk now, never append after them
+        sector->sealed = true;
+        return 0;
+    }
+
+    sector->end += size;
+    return offset;
+}
+
+static uint32_t write_record(uint8_t type, const uint8_t *key, uint8_t key_len,
+                             const uint8_t *value, uint16_t value_len) {
+    static uint8_t record[MAX_RECORD_SIZE + 4] __attribute__((aligned(4)));
+
+    RecordHeader rh;
+    rh.key_len = key_len;
+    rh.type = type;
+    rh.value_len = value_len;
+    rh.crc = record_crc(&rh, key, value);
+
+    uint32_t size = record_size(key_len, value_len);
+    memset(record, 0xFF, size);
+    memcpy(record, &rh, sizeof(rh));
+    memcpy(record + sizeof(rh), key, key_len);
+    if (value_len) memcpy(record + sizeof(rh) + key_len, value, value_len);
+
+    return append(record, size, false);
+}
+
+static bool erase_sector(int s) {
+    uint32_t count = sectors[s].erase_count;
+    if (!flash->erase(sector_base(s))) return false;
+
+    sectors[s].state = SECTOR_ERASED;
+    sectors[s].sealed = false;
+    sectors[s].seq = 0;
+    sectors[s].end = 0;
+    sectors[s].live = 0;
+    sectors[s].erase_count = count + 1;
+    return true;
+}
+
+static uint32_t garbage_bytes() {
+    uint32_t garbage = 0;
+    for (int s = 0; s < flash->sector_count; s++) {
+        if (sectors[s].state == SECTOR_LOG) {
+            garbage += sectors[s].end - sizeof(SectorHeader) - sectors[s].live;
+        }
+    }
+    return garbage;
+}
+
+static int oldest_log_sector() {
+    int oldest = -1;
+    for (int s = 0; s < flash->sector_count; s++) {
+        if (sectors[s].state != SECTOR_LOG || s == head) continue;
+        if (oldest < 0 || sectors[s].seq < sectors[oldest].seq) oldest = s;
+    }
+    return oldest;
+}
+
+// Moves the sector's live records to the head of the log
+static bool compact(int victim) {
+    static uint8_t record[MAX_RECORD_SIZE + 4] __attribute__((aligned(4)));
+    uint32_t base = sector_base(victim);
+
+    for (uint32_t i = 0; i < KV_INDEX_SIZE; i++) {
+        uint32_t offset = slots[i].offset;
+        if (offset == 0 || offset < base || offset >= base + flash->sector_size) continue;
+
+        RecordHeader rh = read_header(offset);
+        uint32_t size = record_size(rh.key_len, rh.value_len);
+        memcpy(record, flash->map(offset), size);
+
+        uint32_t moved = append(record, size, true);
+        if (moved == 0) return false;
+
+        account(offset, false);
+        slots[i].offset = moved;
+        account(moved, true);
+    }
+
+    sectors[victim].state = SECTOR_DIRTY;
+    return true;
+}
+
+// ====== Public API ======
+
+bool kv_mount(const kv_backend_t *backend) {
+    if (backend->sector_count < RESERVE_SECTORS + 2 || backend->sector_count > KV_MAX_SECTORS ||
+        backend->page_size > MAX_PAGE_SIZE ||
+        backend->sector_size < sizeof(SectorHeader) + MAX_RECORD_SIZE) {
+        return false;
+    }
+
+    flash = backend;
+    init_crc_table();
+    memset(sectors, 0, sizeof(sectors));
+    memset(slots, 0, sizeof(slots));
+    key_count = 0;
+    head = -1;
+    max_seq = 0;
+    scanned = 0;
+
+    int order[KV_MAX_SECTORS];
+    int logs = 0;
+
+    for (int s = 0; s < flash->sector_count; s++) {
+        SectorHeader sh;
+        memcpy(&sh, flash->map(sector_base(s)), sizeof(sh));
+        scanned += sizeof(sh);
+
+        if (sh.magic == SECTOR_MAGIC && sh.crc == header_crc(&sh)) {
+            sectors[s].state = SECTOR_LOG;
+            sectors[s].seq = sh.seq;
+            sectors[s].erase_count = sh.erase_count;
+            if (sh.seq > max_seq) max_seq = sh.seq;
+
+            // Insertion sort by sequence, there are only a handful
+            int j = logs++;
+            while (j > 0 && sectors[order[j - 1]].seq > sh.seq) {
+                order[j] = order[j - 1];
+                j--;
+            }
+            order[j] = s;
+        } else if (is_blank(sector_base(s), flash->sector_size)) {
+            sectors[s].state = SECTOR_ERASED;
+            scanned += flash->sector_size;
+        } else {
+            sectors[s].state = SECTOR_DIRTY;
+        }
+    }
+
+    for (int i = 0; i < logs; i++) {
+        // Older sectors are full by definition
+        sectors[order[i]].sealed = (i != logs - 1);
+        replay(order[i]);
+    }
+    if (logs > 0) head = order[logs - 1];
+
+    // Erased sectors lost their count, assume the worst
+    uint32_t max_count = known_max_erase_count();
+    for (int s = 0; s < flash->sector_count; s++) {
+        if (sectors[s].state != SECTOR_LOG) sectors[s].erase_count = max_count;
+    }
+
+    return true;
+}
+
+int kv_get(const void *key, uint8_t key_len, void *buf, uint16_t size) {
+    if (!flash || key_len == 0 || key_len > KV_KEY_MAX) return -1;
+
+    const uint8_t *k = (const uint8_t *)key;
+    uint32_t i = find_slot(k, key_len, hash_key(k, key_len));
+    if (slots[i].offset == 0) return -1;
+
+    RecordHeader rh = read_header(slots[i].offset);
+    uint16_t n = rh.value_len < size ? rh.value_len : size;
+    memcpy(buf, flash->map(slots[i].offset + sizeof(RecordHeader) + rh.key_len), n);
+    return rh.value_len;
+}
+
+bool kv_put(const void *key, uint8_t key_len, const void *value, uint16_t value_len) {
+    if (!flash || key_len == 0 || key_len > KV_KEY_MAX || value_len > KV_VALUE_MAX) return false;
+
+    const uint8_t *k = (const uint8_t *)key;
+    uint32_t i = find_slot(k, key_len, hash_key(k, key_len));
+    if (slots[i].offset == 0 && key_count >= KV_MAX_KEYS) return false;
+
+    uint32_t offset = write_record(REC_PUT, k, key_len, (const uint8_t *)value, value_len);
+    if (offset == 0) return false;
+
+    return index_put(k, key_len, offset);
+}
+
+bool kv_delete(const void *key, uint8_t key_len) {
+    if (!flash || key_len == 0 || key_len > KV_KEY_MAX) return false;
+
+    const uint8_t *k = (const uint8_t *)key;
+    uint32_t i = find_slot(k, key_len, hash_key(k, key_len));
+    if (slots[i].offset == 0) return true;
+
+    if (write_record(REC_DEL, k, key_len, NULL, 0) == 0) return false;
+
+    remove_slot(i);
+    return true;
+}
+
+void kv_foreach(const void *prefix, uint8_t prefix_len,
+                void (*visit)(const uint8_t *key, uint8_t key_len,
+                              const uint8_t *value, uint16_t value_len, void *ctx),
+                void *ctx) {
+    if (!flash) return;
+
+    for (uint32_t i = 0; i < KV_INDEX_SIZE; i++) {
+        if (slots[i].offset == 0) continue;
+
+        RecordHeader rh = read_header(slots[i].offset);
+        const uint8_t *key = flash->map(slots[i].offset + sizeof(RecordHeader));
+        if (rh.key_len < prefix_len || memcmp(key, prefix, prefix_len) != 0) continue;
+
+        visit(key, rh.key_len, key + rh.key_len, rh.value_len, ctx);
+    }
+}
+
+bool kv_needs_maintenance() {
+    if (!flash) return false;
+    if (count_state(SECTOR_DIRTY) > 0) return true;
+
+    // Compacting only pays off if something in the log is dead
+    // Start while puts still have one sector to open, so the game path
+    // doesn't run dry before the next safe point
+    return count_state(SECTOR_ERASED) <= RESERVE_SECTORS + 1 &&
+           garbage_bytes() > 0 && oldest_log_sector() >= 0;
+}
+
+bool kv_maintain() {
+    if (!kv_needs_maintenance()) return false;
+
+    int victim = -1;
+    for (int s = 0; s < flash->sector_count; s++) {
+        if (sectors[s].state == SECTOR_DIRTY) {
+            victim = s;
+            break;
+        }
+    }
+
+    if (victim < 0) {
+        victim = oldest_log_sector();
+        if (!compact(victim)) return false;
+    }
+
+    return erase_sector(victim);
+}
+
+void kv_get_stats(kv_stats_t *stats) {
+    memset(stats, 0, sizeof(*stats));
+    if (!flash) return;
+
+    stats->keys = key_count;
+    stats->erased_sectors = count_state(SECTOR_ERASED);
+    stats->dirty_sectors = count_state(SECTOR_DIRTY);
+    stats->min_erase_count = UINT32_MAX;
+    stats->mount_bytes_scanned = scanned;
+
+    for (int s = 0; s < flash->sector_count; s++) {
+        const Sector *sector = &sectors[s];
+        if (sector->state == SECTOR_LOG) {
+            stats->live_bytes += sector->live;
+            stats->used_bytes += sector->end - sizeof(SectorHeader);
+        }
+        if (sector->erase_count < stats->min_erase_count) stats->min_erase_count = sector->erase_count;
+        if (sector->erase_count > stats->max_erase_count) stats->max_erase_count = sector->erase_count;
+    }
+}
@@ -0,0 +1,132 @@
+#ifndef KV_STORE_HH
+#define KV_STORE_HH
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*  NOTES:
+
+    Append-only key-value log over a ring of flash sectors.
+
+    Sector:  header (magic, sequence, erase count, CRC), then records
+    Record:  key_len, type, value_len, CRC, key, value (4-byte aligned)
+
+    Puts and deletes only ever program erased bytes at the end of the
+    active sector. When it fills, the next erased sector in the ring
+    is opened with a higher sequence number. Mount replays sectors in
+    sequence order into a RAM index, so the newest record for a key
+    wins and a record torn by a power cut fails its CRC and is ignored.
+
+    Erasing is left to kv_maintain(): it copies the live records of the
+    oldest sector to the head of the log and erases it. Sectors are
+    reclaimed strictly oldest-first, so erases rotate evenly around
+    the ring. One sector is always held back so that a compaction
+    never runs out of room.
+
+*/
+
+#define KV_KEY_MAX 32
+#define KV_VALUE_MAX 240
+
+// Open-addressed index, must be a power of two
+#define KV_INDEX_SIZE 512
+#define KV_MAX_KEYS 384
+
+// Most sectors a region may have
+#define KV_MAX_SECTORS 16
+
+typedef struct {
+    uint32_t sector_size;   // erase unit
+    uint32_t page_size;     // program unit
+    uint8_t sector_count;
+
+    // Pointer to a byte of the region (memory-mapped flash on the target)
+    const uint8_t *(*map)(uint32_t offset);
+
+    // Program whole pages, bits can only go from 1 to 0
+    bool (*program)(uint32_t offset, const uint8_t *data, uint32_t len);
+
+    // Erase one sector to 0xFF
+    bool (*erase)(uint32_t offset);
+} kv_backend_t;
+
+typedef struct {
+    uint16_t keys;
+    uint8_t erased_sectors;
+    uint8_t dirty_sectors;     // waiting for kv_maintain()
+    uint32_t live_bytes;
+    uint32_t used_bytes;       // including superseded records
+    uint32_t min_erase_count;
+    uint32_t max_erase_count;
+    uint32_t mount_bytes_scanned;
+} kv_stats_t;
+
+/**
+ * @brief mounts the store: reads sector headers and replays the log
+ * into the RAM index. never erases or programs
+ *
+ * @param backend flash access, must outlive the store
+ * @return false if the backend geometry is not supported
+ */
+bool kv_mount(const kv_backend_t *backend);
+
+/**
+ * @brief copies a value out of the store
+ *
+ * @param key key bytes
+ * @param key_len number of key bytes
+ * @param buf destination
+ * @param size size of buf
+ * @return value length, -1 if the key is not stored. at most 'size'
+ * bytes are copied
+ */
+int kv_get(const void *key, uint8_t key_len, void *buf, uint16_t size);
+
+/**
+ * @brief appends a new value for a key, never erases
+ *
+ * @param key key bytes (1 to KV_KEY_MAX)
+ * @param key_len number of key bytes
+ * @param value value bytes (up to KV_VALUE_MAX)
+ * @param value_len number of value bytes
+ * @return false if the log is out of erased space (run kv_maintain())
+ * or the key/value is too long
+ */
+bool kv_put(const void *key, uint8_t key_len, const void *value, uint16_t value_len);
+
+/**
+ * @brief appends a delete marker for a key, never erases
+ *
+ * @return false if the log is out of erased space
+ */
+bool kv_delete(const void *key, uint8_t key_len);
+
+/**
+ * @brief calls 'visit' for every stored key starting with 'prefix'
+ * the store must not be modified from inside 'visit'
+ */
+void kv_foreach(const void *prefix, uint8_t prefix_len,
+                void (*visit)(const uint8_t *key, uint8_t key_len,
+                              const uint8_t *value, uint16_t value_len, void *ctx),
+                void *ctx);
+
+/**
+ * @return true when kv_maintain() has an erase to do
+ */
+bool kv_needs_maintenance();
+
+/**
+ * @brief reclaims at most one sector: compacts the oldest sector if
+ * space is low, then erases it. only call where a flash erase stall
+ * is acceptable (boot, between waves, menus)
+ *
+ * @return true if a sector was erased
+ */
+bool kv_maintain();
+
+/**
+ * @brief fills 'stats' with usage and wear numbers
+ */
+void kv_get_stats(kv_stats_t *stats);
+
+#endif // KV_STORE_HH
@@ -0,0 +1,58 @@
+#include <string.h>
+
+#include "save_data.hh"
+#include "kv_store.hh"
+
+// Bump when a struct layout changes, old values are then ignored
+#define SETTINGS_VERSION 1
+
+static const char SETTINGS_KEY[] = "settings";
+
+static const Settings DEFAULT_SETTINGS = {
+    90,     // volume, same as buzzer_pwm_init()
+    2048,   // ADC midpoint
+    2048,
+    5,      // deadzone until the first boot calibration
+};
+
+// Stored values are a version byte followed by the struct
+template <typename T>
+static bool load_versioned(const char *key, uint8_t version, T *out) {
+    uint8_t buf[1 + sizeof(T)];
+    int len = kv_get(key, strlen(key), buf, sizeof(buf));
+    if (len != (int)sizeof(buf) || buf[0] != version) return false;
+
+    memcpy(out, &buf[1], sizeof(T));
+    return true;
+}
+
+template <typename T>
+static bool save_versioned(const char *key, uint8_t version, const T *value) {
+    uint8_t buf[1 + sizeof(T)];
+    buf[0] = version;
+    memcpy(&buf[1], value, sizeof(T));
+    return kv_put(key, strlen(key), buf, sizeof(buf));
+}
+
+void load_settings(Settings *settings) {
+    if (!load_versioned(SETTINGS_KEY, SETTINGS_VERSION, settings)) {
+        *settings = DEFAULT_SETTINGS;
+    }
+}
+
+// Field by field, the struct has padding that memcmp would see
+static bool settings_equal(const Settings *a, const Settings *b) {
+    return a->volume == b->volume &&
+           a->js_center_x == b->js_center_x &&
+           a->js_center_y == b->js_center_y &&
+           a->js_deadzone == b->js_deadzone;
+}
+
+bool save_settings(const Settings *settings) {
+    Settings stored;
+    if (load_versioned(SETTINGS_KEY, SETTINGS_VERSION, &stored) &&
+        settings_equal(&stored, settings)) {
+        return true;  // unchanged, don't spend flash on it
+    }
+    return save_versioned(SETTINGS_KEY, SETTINGS_VERSION, settings);
+}
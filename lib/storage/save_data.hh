@@ -0,0 +1,28 @@
+#ifndef SAVE_DATA_HH
+#define SAVE_DATA_HH
+
+#include <stdint.h>
+#include <stdbool.h>
+
+struct Settings {
+    uint8_t volume;         // buzzer duty cycle, 0-100
+    uint16_t js_center_x;   // joystick rest position, ADC counts
+    uint16_t js_center_y;
+    uint8_t js_deadzone;    // analog deadzone, percent of half the ADC range
+};
+
+/**
+ * @brief reads settings from the store, defaults for anything missing
+ *
+ * @param settings filled in
+ */
+void load_settings(Settings *settings);
+
+/**
+ * @brief appends settings to the store (no erase)
+ *
+ * @return false if the store is out of space until the next kv_maintain()
+ */
+bool save_settings(const Settings *settings);
+
+#endif // SAVE_DATA_HH
@@ -0,0 +1,177 @@
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+
+#include "soft_timer.hh"
+
+#define ALARM_NUM 0
+
+static SoftTimer *heap[SOFT_TIMER_MAX];
+static uint8_t heap_size = 0;
+
+// True if a is due before b, works across the 32-bit wrap
+static bool before(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) < 0;
+}
+
+// ====== Heap ======
+
+static void heap_set(uint8_t i, SoftTimer *timer) {
+    heap[i] = timer;
+    timer->heap_index = i;
+}
+
+static void sift_up(uint8_t i) {
+    SoftTimer *timer = heap[i];
+    while (i > 0) {
+        uint8_t parent = (i - 1) / 2;
+        if (!before(timer->due_us, heap[parent]->due_us)) break;
+        heap_set(i, heap[parent]);
+        i = parent;
+    }
+    heap_set(i, timer);
+}
+
+static void sift_down(uint8_t i) {
+    SoftTimer *timer = heap[i];
+    for (;;) {
+        uint8_t child = 2 * i + 1;
+        if (child >= heap_size) break;
+        if (child + 1 < heap_size && before(heap[child + 1]->due_us, heap[child]->due_us)) child++;
+        if (!before(heap[child]->due_us, timer->due_us)) break;
+        heap_set(i, heap[child]);
+        i = child;
+    }
+    heap_set(i, timer);
+}
+
+static void heap_push(SoftTimer *timer) {
+    heap_set(heap_size++, timer);
+    sift_up(timer->heap_index);
+}
+
+static void heap_remove(SoftTimer *timer) {
+    uint8_t i = timer->heap_index;
+    timer->heap_index = -1;
+
+    SoftTimer *last = heap[--heap_size];
+    if (i == heap_size) return;
+
+    heap_set(i, last);
+    sift_down(i);
+    sift_up(last->heap_index);
+}
+
+// ====== Alarm ======
+
+static bool is_scheduled(const SoftTimer *timer) {
+    return timer->heap_index >= 0 && timer->heap_index < heap_size && heap[timer->heap_index] == timer;
+}
+
+// Interrupts must be off (or be the alarm IRQ)
+static void arm_alarm() {
+    if (heap_size == 0) {
+        hw_clear_bits(&timer0_hw->inte, 1u << ALARM_NUM);
+        return;
+    }
+    hw_set_bits(&timer0_hw->inte, 1u << ALARM_NUM);
+    timer0_hw->alarm[ALARM_NUM] = heap[0]->due_us;
+
+    // Due time may have passed already, the alarm would then not fire
+    // until the counter wraps, so take the IRQ by hand
+    if (!before(timer0_hw->timerawl, heap[0]->due_us)) {
+        irq_set_pending(timer_hardware_alarm_get_irq_num(timer0_hw, ALARM_NUM));
+    }
+}
+
+static void fire(SoftTimer *timer, uint32_t now) {
+    uint32_t late = now - timer->due_us;
+    timer->fires++;
+    timer->total_late_us += late;
+    if (late > timer->max_late_us) timer->max_late_us = late;
+
+    heap_remove(timer);
+
+    if (timer->period_us) {
+        // Next run is on the original grid, skipping runs already missed
+        timer->due_us += timer->period_us;
+        if (!before(now, timer->due_us)) {
+            uint32_t missed = (now - timer->due_us) / timer->period_us + 1;
+            timer->due_us += missed * timer->period_us;
+            timer->skipped += missed;
+        }
+        heap_push(timer);
+    }
+
+    timer->callback(timer->ctx);
+}
+
+static void soft_timer_isr() {
+    hw_clear_bits(&timer0_hw->intr, 1u << ALARM_NUM);
+
+    uint32_t now = timer0_hw->timerawl;
+    while (heap_size > 0 && !before(now, heap[0]->due_us)) {
+        fire(heap[0], now);
+    }
+
+    arm_alarm();
+}
+
+// ====== Public API ======
+
+void init_soft_timers() {
+    heap_size = 0;
+
+    // Panics if someone else has it, and keeps the SDK from handing it out
+    timer_hardware_alarm_claim(timer0_hw, ALARM_NUM);
+
+    uint irq = timer_hardware_alarm_get_irq_num(timer0_hw, ALARM_NUM);
+    irq_set_exclusive_handler(irq, soft_timer_isr);
+    irq_set_enabled(irq, true);
+}
+
+bool soft_timer_start(SoftTimer *timer, uint32_t delay_us, uint32_t period_us,
+                      soft_timer_callback_t callback, void *ctx) {
+    uint32_t irq_state = save_and_disable_interrupts();
+
+    if (is_scheduled(timer)) {
+        heap_remove(timer);
+    } else if (heap_size == SOFT_TIMER_MAX) {
+        restore_interrupts(irq_state);
+        return false;
+    }
+
+    timer->due_us = timer0_hw->timerawl + delay_us;
+    timer->period_us = period_us;
+    timer->callback = callback;
+    timer->ctx = ctx;
+    heap_push(timer);
+
+    arm_alarm();
+    restore_interrupts(irq_state);
+    return true;
+}
+
+void soft_timer_cancel(SoftTimer *timer) {
+    uint32_t irq_state = save_and_disable_interrupts();
+
+    if (is_scheduled(timer)) {
+        heap_remove(timer);
+        arm_alarm();
+    }
+
+    restore_interrupts(irq_state);
+}
+
+void soft_timer_get_stats(const SoftTimer *timer, SoftTimerStats *stats) {
+    uint32_t irq_state = save_and_disable_interrupts();
+
+    stats->fires = timer->fires;
+    stats->skipped = timer->skipped;
+    stats->max_late_us = timer->max_late_us;
+    stats->mean_late_us = timer->fires ? (uint32_t)(timer->total_late_us / timer->fires) : 0;
+
+    restore_interrupts(irq_state);
+}
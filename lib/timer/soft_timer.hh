@@ -0,0 +1,81 @@
+#ifndef SOFT_TIMER_HH
+#define SOFT_TIMER_HH
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*  NOTES:
+
+    Any number of driver timers on timer0 alarm 0. Pending timers sit
+    in a min-heap by due time and the alarm is always armed for the
+    earliest one. Callbacks run in the alarm IRQ, keep them short.
+
+    A periodic timer is re-armed from the time it was due, not from
+    when the IRQ got around to it, so it never drifts. If it falls more
+    than a whole period behind, the missed runs are skipped (and
+    counted) instead of firing back to back.
+
+    Times are timer0_hw->timerawl microseconds, so periods and delays
+    must stay under ~35 minutes.
+
+    Alarms 1 and 2 are free, the SDK's sleep/alarm pool uses alarm 3.
+
+*/
+
+// Most timers scheduled at once
+#define SOFT_TIMER_MAX 16
+
+typedef void (*soft_timer_callback_t)(void *ctx);
+
+struct SoftTimerStats {
+    uint32_t fires;
+    uint32_t skipped;       // periods missed because the timer ran late
+    uint32_t max_late_us;   // worst time from due to callback
+    uint32_t mean_late_us;
+};
+
+// Owned by the caller, must stay alive while scheduled. Start it out
+// zeroed (static or '= {}'), stats add up across restarts
+struct SoftTimer {
+    uint32_t due_us;
+    uint32_t period_us;     // 0 = one-shot
+    soft_timer_callback_t callback;
+    void *ctx;
+    int8_t heap_index;      // -1 when not scheduled
+
+    uint32_t fires;
+    uint32_t skipped;
+    uint32_t max_late_us;
+    uint64_t total_late_us;
+};
+
+/**
+ * @brief claims timer0 alarm 0 and its IRQ, call before any driver
+ * starts a timer
+ */
+void init_soft_timers();
+
+/**
+ * @brief schedules a timer, restarting it if it was already scheduled
+ *
+ * @param timer caller-owned timer
+ * @param delay_us time until the first callback
+ * @param period_us time between callbacks after that, 0 for one-shot
+ * @param callback called from the alarm IRQ
+ * @param ctx passed to callback
+ * @return false if SOFT_TIMER_MAX timers are already scheduled
+ */
+bool soft_timer_start(SoftTimer *timer, uint32_t delay_us, uint32_t period_us,
+                      soft_timer_callback_t callback, void *ctx);
+
+/**
+ * @brief unschedules a timer, safe from its own callback
+ */
+void soft_timer_cancel(SoftTimer *timer);
+
+/**
+ * @brief copies how late the timer's callbacks have run
+ */
+void soft_timer_get_stats(const SoftTimer *timer, SoftTimerStats *stats);
+
+#endif // SOFT_TIMER_HH
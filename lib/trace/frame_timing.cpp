@@ -0,0 +1,101 @@
+#include "frame_timing.hh"
+
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/stdio_usb.h"
+#include "input.hh"
+#include "usb_command.hh"
+#include "usb_packet.hh"
+
+// Rows waiting for USB, power of two. A frame is one row, so this is
+// how many frames the host side may fall behind
+#define QUEUE_SIZE 8
+#define QUEUE_MASK (QUEUE_SIZE - 1)
+
+#define ROW_FIELDS 6
+
+struct TimingRow {
+    uint32_t fields[ROW_FIELDS];     // frame, input, draw, push, total, dropped
+};
+
+static bool enabled = false;
+static uint32_t frame_number = 0;
+static uint32_t frame_start_us;
+static uint32_t stage_start_us;
+static uint32_t stage_us[TIMING_STAGE_COUNT];
+
+// Filled and drained by core0's main loop only
+static TimingRow queue[QUEUE_SIZE];
+static uint32_t queue_head = 0;
+static uint32_t queue_tail = 0;
+
+static UsbPacket packet;
+static uint16_t seq = 0;
+
+static bool timing_command(int argc, char **argv) {
+    if (argc != 2) return false;
+
+    if (strcmp(argv[1], "on") == 0) {
+        queue_tail = queue_head;
+        enabled = true;
+    } else if (strcmp(argv[1], "off") == 0) {
+        enabled = false;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void frame_timing_init() {
+    usb_command_register("timing", timing_command, "on|off");
+}
+
+void frame_timing_begin() {
+    frame_start_us = time_us_32();
+    stage_start_us = frame_start_us;
+}
+
+void frame_timing_end_stage(FrameTimingStage stage) {
+    uint32_t now = time_us_32();
+    stage_us[stage] = now - stage_start_us;
+    stage_start_us = now;
+}
+
+void frame_timing_end() {
+    uint32_t total = time_us_32() - frame_start_us;
+    frame_number++;
+    if (!enabled) return;
+
+    // Full means the host stopped reading, the gap shows in the frame numbers
+    if (queue_head - queue_tail == QUEUE_SIZE) return;
+
+    TimingRow *row = &queue[queue_head & QUEUE_MASK];
+    row->fields[0] = frame_number;
+    row->fields[1] = stage_us[timing_input];
+    row->fields[2] = stage_us[timing_draw];
+    row->fields[3] = stage_us[timing_push];
+    row->fields[4] = total;
+    row->fields[5] = input_dropped();
+    queue_head++;
+}
+
+static void put_u32(uint8_t *out, uint32_t value) {
+    out[0] = value & 0xFF;
+    out[1] = (value >> 8) & 0xFF;
+    out[2] = (value >> 16) & 0xFF;
+    out[3] = value >> 24;
+}
+
+void frame_timing_drain() {
+    if (!stdio_usb_connected()) return;
+
+    while (usb_packet_send(&packet)) {
+        if (queue_tail == queue_head) return;
+
+        const TimingRow *row = &queue[queue_tail & QUEUE_MASK];
+        uint8_t *payload = usb_packet_begin(&packet, packet_timing, seq++);
+        for (int i = 0; i < ROW_FIELDS; i++) put_u32(payload + 4 * i, row->fields[i]);
+        usb_packet_end(&packet, 4 * ROW_FIELDS);
+        queue_tail++;
+    }
+}
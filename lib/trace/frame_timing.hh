@@ -0,0 +1,59 @@
+#ifndef FRAME_TIMING_HH
+#define FRAME_TIMING_HH
+
+#include <stdint.h>
+
+/*  NOTES:
+
+    Per-frame timing export for hardware-in-the-loop benchmarks. Off
+    until the host sends "timing on" (usb_command), then every frame
+    queues one row, sent as a usb_packet so it can't break up a frame
+    stream packet the way printf text would. Six u32:
+
+        frame, input_us, draw_us, push_us, total_us, dropped
+
+    input, draw and push are the main loop's stages, total is start of
+    input to end of push. dropped is input_dropped() so lost events show
+    up next to the frame that lost them. Rows wait in a short queue for
+    frame_timing_drain(), if the host falls behind the newest are
+    skipped and the frame numbers show the gap.
+
+    tools/scenario_runner reads these. Cheap when off, just a few
+    time_us_32() reads per frame.
+
+*/
+
+enum FrameTimingStage {
+    timing_input,
+    timing_draw,
+    timing_push,
+    TIMING_STAGE_COUNT,
+};
+
+/**
+ * @brief registers the timing command, call once at boot
+ */
+void frame_timing_init();
+
+/**
+ * @brief start of a frame, before input is sampled
+ */
+void frame_timing_begin();
+
+/**
+ * @brief 'stage' just finished, stages run in order
+ */
+void frame_timing_end_stage(FrameTimingStage stage);
+
+/**
+ * @brief end of the frame, queues its row when timing is on
+ */
+void frame_timing_end();
+
+/**
+ * @brief sends queued rows to the host, call from core0's main loop
+ * between frames. never blocks
+ */
+void frame_timing_drain();
+
+#endif // FRAME_TIMING_HH
@@ -0,0 +1,205 @@
+#include "latency_trace.hh"
+
+#if LATENCY_TRACE
+
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+
+// Frames in flight between draw and first scanout, power of two
+#define TRACE_FRAMES 8
+#define TRACE_MASK (TRACE_FRAMES - 1)
+
+// Inputs tagged onto one frame, more than this in a tick are not traced
+#define INPUTS_PER_FRAME 8
+
+#define REPORT_MS 5000
+
+#define BUCKETS 32
+#define BUCKET_MIN_BITS 8     // first bucket starts at 256 us
+
+enum TraceSource {
+    source_button,
+    source_stick,
+    source_tag,
+    SOURCE_COUNT,
+};
+
+static const char *source_names[SOURCE_COUNT] = {"button", "stick", "rfid"};
+
+enum Stage {
+    stage_sim,
+    stage_draw,
+    stage_push,
+    stage_swap,
+    stage_scan,
+    STAGE_COUNT,
+};
+
+struct TracedInput {
+    uint8_t source;
+    uint32_t input_us;
+    uint32_t sim_us;
+};
+
+struct FrameRecord {
+    bool used;
+    uint32_t frame;
+    uint8_t count;
+    TracedInput inputs[INPUTS_PER_FRAME];
+    uint32_t draw_us;
+    uint32_t push_us;
+};
+
+struct Histogram {
+    uint32_t count;
+    uint64_t total_us;
+    uint32_t max_us;
+    uint64_t stage_us[STAGE_COUNT];
+    uint32_t buckets[BUCKETS];
+};
+
+// ====== Core0 state ======
+
+static TracedInput pending[INPUTS_PER_FRAME];
+static uint8_t pending_count = 0;
+static uint32_t frames_pushed = 0;
+static FrameRecord records[TRACE_FRAMES];
+
+static Histogram histograms[SOURCE_COUNT];
+static bool dirty = false;
+static uint32_t last_report_ms = 0;
+
+// ====== Core1 state ======
+
+// Written by core1 only, read by core0 once frames_scanned covers them
+static volatile uint32_t swap_us[TRACE_FRAMES];
+static volatile uint32_t scan_us[TRACE_FRAMES];
+static volatile uint32_t frames_scanned = 0;
+
+static uint32_t frames_swapped = 0;
+static bool scan_pending = false;
+
+// ====== Histograms ======
+
+static uint8_t bucket_for(uint32_t us) {
+    if (us < (1u << BUCKET_MIN_BITS)) return 0;
+
+    uint8_t msb = 31 - __builtin_clz(us);
+    uint8_t half = (us >> (msb - 1)) & 1;   // upper or lower half of the octave
+    int bucket = 2 * (msb - BUCKET_MIN_BITS) + half;
+    return (bucket < BUCKETS) ? bucket : BUCKETS - 1;
+}
+
+static void record(const TracedInput *in, const FrameRecord *frame, uint32_t swap, uint32_t scan) {
+    Histogram *h = &histograms[in->source];
+    uint32_t total = scan - in->input_us;
+
+    h->count++;
+    h->total_us += total;
+    if (total > h->max_us) h->max_us = total;
+    h->buckets[bucket_for(total)]++;
+
+    h->stage_us[stage_sim] += in->sim_us - in->input_us;
+    h->stage_us[stage_draw] += frame->draw_us - in->sim_us;
+    h->stage_us[stage_push] += frame->push_us - frame->draw_us;
+    h->stage_us[stage_swap] += swap - frame->push_us;
+    h->stage_us[stage_scan] += scan - swap;
+    dirty = true;
+}
+
+static void report() {
+    for (int s = 0; s < SOURCE_COUNT; s++) {
+        const Histogram *h = &histograms[s];
+        if (h->count == 0) continue;
+
+        printf("lat %s n=%lu mean=%lu max=%lu", source_names[s], (unsigned long)h->count,
+               (unsigned long)(h->total_us / h->count), (unsigned long)h->max_us);
+        static const char *stage_names[STAGE_COUNT] = {"sim", "draw", "push", "swap", "scan"};
+        for (int st = 0; st < STAGE_COUNT; st++) {
+            printf(" %s=%lu", stage_names[st], (unsigned long)(h->stage_us[st] / h->count));
+        }
+        printf("\nlath %s", source_names[s]);
+        for (int b = 0; b < BUCKETS; b++) printf(" %lu", (unsigned long)h->buckets[b]);
+        printf("\n");
+    }
+}
+
+// ====== Core0 ======
+
+void latency_trace_input(const InputEvent *event) {
+    if (pending_count == INPUTS_PER_FRAME) return;
+
+    TracedInput *in = &pending[pending_count++];
+    switch (event->type) {
+        case input_button: in->source = source_button; break;
+        case input_tag:    in->source = source_tag; break;
+        default:           in->source = source_stick; break;
+    }
+    in->input_us = event->time_us;
+    in->sim_us = time_us_32();
+}
+
+void latency_trace_drawn() {
+    if (pending_count == 0) return;
+
+    // Core1 lags core0 by at most a couple of frames, a slot still in use
+    // here means its scanout was never seen, so it is dropped
+    FrameRecord *frame = &records[frames_pushed & TRACE_MASK];
+    frame->used = true;
+    frame->frame = frames_pushed;
+    frame->count = pending_count;
+    memcpy(frame->inputs, pending, pending_count * sizeof(TracedInput));
+    frame->draw_us = time_us_32();
+    frame->push_us = frame->draw_us;
+    pending_count = 0;
+}
+
+void latency_trace_pushed() {
+    FrameRecord *frame = &records[frames_pushed & TRACE_MASK];
+    if (frame->used && frame->frame == frames_pushed) frame->push_us = time_us_32();
+    frames_pushed++;
+}
+
+void latency_trace_poll() {
+    uint32_t scanned = frames_scanned;
+    __dmb();
+
+    for (int i = 0; i < TRACE_FRAMES; i++) {
+        FrameRecord *frame = &records[i];
+        if (!frame->used || (int32_t)(scanned - frame->frame) <= 0) continue;
+
+        uint32_t slot = frame->frame & TRACE_MASK;
+        for (uint8_t j = 0; j < frame->count; j++) {
+            record(&frame->inputs[j], frame, swap_us[slot], scan_us[slot]);
+        }
+        frame->used = false;
+    }
+
+    uint32_t now = to_ms_since_boot(get_absolute_time());
+    if (dirty && now - last_report_ms >= REPORT_MS) {
+        last_report_ms = now;
+        dirty = false;
+        report();
+    }
+}
+
+// ====== Core1 ======
+
+void latency_trace_swapped() {
+    swap_us[frames_swapped & TRACE_MASK] = time_us_32();
+    frames_swapped++;
+    scan_pending = true;
+}
+
+void latency_trace_scanout() {
+    if (!scan_pending) return;
+    scan_pending = false;
+
+    scan_us[(frames_swapped - 1) & TRACE_MASK] = time_us_32();
+    __dmb();
+    frames_scanned = frames_swapped;
+}
+
+#endif // LATENCY_TRACE
@@ -0,0 +1,83 @@
+#ifndef LATENCY_TRACE_HH
+#define LATENCY_TRACE_HH
+
+#include <stdint.h>
+#include "input.hh"
+
+/*  NOTES:
+
+    Input-to-photon tracing. Build with -DLATENCY_TRACE=1 (build_flags
+    in platformio.ini), otherwise every call here compiles to nothing.
+
+    Each input event handled in a tick is tagged with its hardware
+    timestamp and follows the next frame through the pipeline:
+
+        input -> sim (handled) -> draw (done) -> push (handed to core1)
+              -> swap (core1) -> scan (first scanout of that frame)
+
+    Core1 counts its swaps, which line up one to one with core0's
+    pushes, so no frame id has to travel with the swap request.
+
+    Every few seconds a report goes out on stdio (USB), one block per
+    source that saw input:
+
+        lat <source> n=<count> mean=<us> max=<us> sim=<us> draw=<us> push=<us> swap=<us> scan=<us>
+        lath <source> <32 bucket counts>
+
+    sim..scan are the mean time spent in each stage. Bucket i of the
+    histogram covers input-to-photon times from 256us * 2^(i/2), so two
+    buckets per doubling from 256 us to ~16 s; the first and last also
+    take everything below and above.
+
+*/
+
+#ifndef LATENCY_TRACE
+#define LATENCY_TRACE 0
+#endif
+
+#if LATENCY_TRACE
+
+/**
+ * @brief tags an input event handled this tick (core0)
+ */
+void latency_trace_input(const InputEvent *event);
+
+/**
+ * @brief the frame with this tick's changes is drawn (core0)
+ */
+void latency_trace_drawn();
+
+/**
+ * @brief that frame is being handed to core1, call before core1 can
+ * see it (core0)
+ */
+void latency_trace_pushed();
+
+/**
+ * @brief core1 swapped to the next pushed frame
+ */
+void latency_trace_swapped();
+
+/**
+ * @brief core1 is starting a scan, call right before render_frame
+ */
+void latency_trace_scanout();
+
+/**
+ * @brief collects finished frames and prints reports, once per tick
+ * (core0)
+ */
+void latency_trace_poll();
+
+#else
+
+static inline void latency_trace_input(const InputEvent *) {}
+static inline void latency_trace_drawn() {}
+static inline void latency_trace_pushed() {}
+static inline void latency_trace_swapped() {}
+static inline void latency_trace_scanout() {}
+static inline void latency_trace_poll() {}
+
+#endif // LATENCY_TRACE
+
+#endif // LATENCY_TRACE_HH
@@ -0,0 +1,176 @@
+#include "frame_stream.hh"
+
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/stdio_usb.h"
+#include "usb_command.hh"
+#include "usb_packet.hh"
+
+#define STREAM_ROWS 32
+#define STREAM_COLS 64
+
+// Full frame every this many, for viewers that join late or lose data
+#define STREAM_KEYFRAME_INTERVAL 30
+
+// Rows compared per poll, keeps one poll to a few tens of us
+#define STREAM_ROWS_PER_POLL 8
+
+static_assert(2 + STREAM_COLS * 4 <= USB_PACKET_PAYLOAD_MAX, "a row with no runs merged must fit a packet");
+
+enum EncodeState {
+    encode_idle,
+    encode_rows,
+};
+
+typedef Color Frame[STREAM_ROWS][STREAM_COLS];
+
+// What the viewer holds, the frame being encoded and the newest capture.
+// Encoding and latest trade places when a frame starts
+static Frame buffers[3];
+static Frame *shown = &buffers[0];
+static Frame *encoding = &buffers[1];
+static Frame *latest = &buffers[2];
+static bool latest_ready = false;
+
+static bool streaming = false;
+static bool keyframe_requested = false;
+static EncodeState state = encode_idle;
+static bool keyframe;
+static uint16_t seq = 0;
+static int next_row;
+static uint8_t rows_sent;
+static uint16_t frames_dropped = 0;
+
+// One packet at a time, written out as the USB buffer makes room
+static UsbPacket packet;
+
+static bool same_color(Color a, Color b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b;
+}
+
+static void start_frame() {
+    Frame *next = latest;
+    latest = encoding;
+    encoding = next;
+    latest_ready = false;
+
+    keyframe = keyframe_requested || seq % STREAM_KEYFRAME_INTERVAL == 0;
+    keyframe_requested = false;
+    next_row = 0;
+    rows_sent = 0;
+    state = encode_rows;
+
+    uint8_t *payload = usb_packet_begin(&packet, packet_frame_start, seq);
+    payload[0] = keyframe;
+    usb_packet_end(&packet, 1);
+}
+
+// Builds a row packet if the row changed, false if there is nothing to send
+static bool encode_row(int row) {
+    const Color *pixels = (*encoding)[row];
+    Color *old = (*shown)[row];
+
+    int first = 0;
+    int last = STREAM_COLS - 1;
+    if (!keyframe) {
+        while (first < STREAM_COLS && same_color(pixels[first], old[first])) first++;
+        if (first == STREAM_COLS) return false;
+        while (same_color(pixels[last], old[last])) last--;
+    }
+
+    uint8_t *payload = usb_packet_begin(&packet, packet_row, seq);
+    uint8_t *out = payload;
+    *out++ = row;
+    *out++ = first;
+
+    int col = first;
+    while (col <= last) {
+        Color color = pixels[col];
+        int run = 1;
+        while (col + run <= last && same_color(pixels[col + run], color)) run++;
+
+        *out++ = run;
+        *out++ = color.r;
+        *out++ = color.g;
+        *out++ = color.b;
+        col += run;
+    }
+    usb_packet_end(&packet, out - payload);
+
+    memcpy(old + first, pixels + first, (last - first + 1) * sizeof(Color));
+    rows_sent++;
+    return true;
+}
+
+static void finish_frame() {
+    uint8_t *payload = usb_packet_begin(&packet, packet_frame_end, seq);
+    payload[0] = rows_sent;
+    payload[1] = frames_dropped & 0xFF;
+    payload[2] = frames_dropped >> 8;
+    usb_packet_end(&packet, 3);
+
+    state = encode_idle;
+    seq++;
+}
+
+static void stop() {
+    streaming = false;
+    latest_ready = false;
+    state = encode_idle;
+    usb_packet_cancel(&packet);
+}
+
+static bool stream_command(int argc, char **argv) {
+    if (argc != 2) return false;
+
+    if (strcmp(argv[1], "start") == 0) {
+        streaming = true;
+        keyframe_requested = true;
+    } else if (strcmp(argv[1], "stop") == 0) {
+        stop();
+    } else if (strcmp(argv[1], "key") == 0) {
+        keyframe_requested = true;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void frame_stream_init() {
+    usb_command_register("stream", stream_command, "start|stop|key");
+}
+
+void frame_stream_capture(const Color *frame) {
+    if (!streaming) return;
+
+    if (latest_ready) frames_dropped++;
+    memcpy(*latest, frame, sizeof(Frame));
+    latest_ready = true;
+}
+
+void frame_stream_poll() {
+    if (!streaming) return;
+
+    // Host closed the port, wait for the next stream start
+    if (!stdio_usb_connected()) {
+        stop();
+        return;
+    }
+
+    int rows = 0;
+    while (usb_packet_send(&packet)) {
+        if (state == encode_idle) {
+            if (!latest_ready) return;
+            start_frame();
+        } else if (next_row < STREAM_ROWS) {
+            if (rows++ == STREAM_ROWS_PER_POLL) return;
+            encode_row(next_row++);
+        } else {
+            finish_frame();
+        }
+    }
+}
+
+bool frame_stream_active() {
+    return streaming;
+}
@@ -0,0 +1,66 @@
+#ifndef FRAME_STREAM_HH
+#define FRAME_STREAM_HH
+
+#include <stdint.h>
+#include "../led_matrix/color.hh"
+
+/*  NOTES:
+
+    Streams the frames core0 hands to core1 over USB CDC, for watching
+    the panel on a PC (tools/frame_viewer). Off until the host asks, so
+    a plain serial monitor only ever sees printf text.
+
+    Host to board, usb_command lines:
+        stream start    next frame is a keyframe
+        stream stop
+        stream key      send a keyframe (the viewer lost something)
+
+    Board to host, usb_packet packets. seq is the frame number, every
+    packet of a frame carries it:
+
+        frame start   flags u8 (bit 0: keyframe)
+        row           row u8, x u8, then (count, r, g, b) runs
+        frame end     rows sent u8, frames dropped u16
+
+    A frame only sends the rows that differ from the previous one, each
+    from its first to its last changed pixel, run length encoded. A
+    keyframe sends every row in full, one goes out every
+    STREAM_KEYFRAME_INTERVAL frames so a viewer joining late catches up.
+
+    Everything runs on core0 and never blocks: capture copies the frame
+    (latest one wins if the encoder is behind, the older one counts as
+    dropped), poll compares and encodes a few rows and writes only what
+    the USB buffer has room for. Core1 and the scan are never touched.
+
+    printf text between packets passes through to the viewer's console.
+    Text landing inside a packet breaks its checksum, the viewer then
+    asks for a keyframe.
+
+*/
+
+/**
+ * @brief registers the stream command, call once at boot
+ */
+void frame_stream_init();
+
+/**
+ * @brief copies the frame about to be pushed to core1, call just
+ * before push_frame(). Nothing happens unless a host
+ * asked for the stream
+ *
+ * @param frame MATRIX_ROWS x MATRIX_COLS pixels, row major
+ */
+void frame_stream_capture(const Color *frame);
+
+/**
+ * @brief encodes and sends a bounded slice of the pending frame, call
+ * often from the main loop
+ */
+void frame_stream_poll();
+
+/**
+ * @return true while a host is receiving the stream
+ */
+bool frame_stream_active();
+
+#endif // FRAME_STREAM_HH
@@ -0,0 +1,79 @@
+#include "usb_command.hh"
+
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+
+// Bytes taken per poll, a burst from the host is spread over a few polls
+#define BYTES_PER_POLL 64
+
+struct UsbCommand {
+    const char *name;
+    UsbCommandHandler handler;
+    const char *usage;
+};
+
+static bool info_command(int argc, char **argv) {
+    printf("info build %s %s\n", __DATE__, __TIME__);
+    return true;
+}
+
+static UsbCommand commands[USB_COMMANDS_MAX] = {{"info", info_command, ""}};
+static int command_count = 1;
+
+static char line[USB_COMMAND_LINE_MAX + 1];
+static int line_length = 0;
+static bool line_overflow = false;
+
+bool usb_command_register(const char *name, UsbCommandHandler handler, const char *usage) {
+    if (command_count == USB_COMMANDS_MAX) return false;
+
+    commands[command_count++] = {name, handler, usage};
+    return true;
+}
+
+static void run_line() {
+    char *argv[USB_COMMAND_ARGS_MAX];
+    int argc = 0;
+
+    char *save = NULL;
+    for (char *word = strtok_r(line, " \t", &save); word && argc < USB_COMMAND_ARGS_MAX;
+         word = strtok_r(NULL, " \t", &save)) {
+        argv[argc++] = word;
+    }
+    if (argc == 0) return;
+
+    for (int i = 0; i < command_count; i++) {
+        if (strcmp(argv[0], commands[i].name) != 0) continue;
+
+        if (commands[i].handler(argc, argv)) {
+            printf("ok %s\n", argv[0]);
+        } else {
+            printf("err %s: %s %s\n", argv[0], commands[i].name, commands[i].usage);
+        }
+        return;
+    }
+    printf("err %s: unknown command\n", argv[0]);
+}
+
+void usb_command_poll() {
+    for (int i = 0; i < BYTES_PER_POLL; i++) {
+        int c = getchar_timeout_us(0);
+        if (c < 0) return;
+
+        if (c == '\r' || c == '\n') {
+            line[line_length] = '\0';
+            if (line_overflow) {
+                printf("err line longer than %d\n", USB_COMMAND_LINE_MAX);
+            } else {
+                run_line();
+            }
+            line_length = 0;
+            line_overflow = false;
+        } else if (line_length < USB_COMMAND_LINE_MAX) {
+            line[line_length++] = (char)c;
+        } else {
+            line_overflow = true;
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef USB_COMMAND_HH
+#define USB_COMMAND_HH
+
+/*  NOTES:
+
+    Line based commands from the host over USB serial, the one reader
+    of stdin. Modules register a name and a handler at init, a line is
+    split on spaces and goes to the handler its first word names:
+
+        stream start            -> stream handler, argv = {"stream", "start"}
+
+    Every line gets one reply so a script can count them:
+
+        ok <name>
+        err <name>: <usage>     bad arguments, or an unknown name
+
+    Built in:
+        info                    prints "info build <date> <time>", to
+                                tell firmware builds apart in results
+
+    Polling never blocks, it takes whatever bytes have arrived and runs
+    the lines they complete. Handlers run on core0 in the main loop.
+
+*/
+
+#define USB_COMMANDS_MAX 8
+#define USB_COMMAND_ARGS_MAX 8
+#define USB_COMMAND_LINE_MAX 80
+
+/**
+ * @brief runs one command line
+ *
+ * @param argc number of words, argv[0] is the command name
+ * @return false if the arguments are bad, the usage is then replied
+ */
+typedef bool (*UsbCommandHandler)(int argc, char **argv);
+
+/**
+ * @brief adds a command, call at init
+ *
+ * @param name first word of the line, kept by pointer
+ * @param usage arguments, shown when they are wrong
+ * @return false if the table is full
+ */
+bool usb_command_register(const char *name, UsbCommandHandler handler, const char *usage);
+
+/**
+ * @brief reads what the host sent and runs complete lines, call often
+ * from the main loop
+ */
+void usb_command_poll();
+
+#endif // USB_COMMAND_HH
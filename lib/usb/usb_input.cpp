@@ -0,0 +1,115 @@
+#include "usb_input.hh"
+
+#include <string.h>
+#include "input.hh"
+#include "tag_registry.hh"
+#include "usb_command.hh"
+
+static const char *direction_names[] = {"left", "right", "up", "down", "center"};
+static const char *tower_names[TOWER_TYPE_COUNT] = {"dart", "ninja", "bomb", "sniper", "blank"};
+
+// Index of 'word' in 'names', -1 if it isn't there
+static int find_name(const char *word, const char *const *names, int count) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(word, names[i]) == 0) return i;
+    }
+    return -1;
+}
+
+static int hex_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Same lengths a real card has, false for anything else
+static bool parse_uid(const char *text, uint8_t *uid, uint8_t *uid_len) {
+    int digits = strlen(text);
+    if (digits != 8 && digits != 14 && digits != 20) return false;
+
+    for (int i = 0; i < digits / 2; i++) {
+        int high = hex_digit(text[2 * i]);
+        int low = hex_digit(text[2 * i + 1]);
+        if (high < 0 || low < 0) return false;
+        uid[i] = (uint8_t)(high << 4 | low);
+    }
+    *uid_len = digits / 2;
+    return true;
+}
+
+static bool stick_command(int argc, char **argv) {
+    if (argc != 3) return false;
+
+    InputEvent event = {};
+    if (strcmp(argv[1], "x") == 0) {
+        event.type = input_stick_x;
+    } else if (strcmp(argv[1], "y") == 0) {
+        event.type = input_stick_y;
+    } else {
+        return false;
+    }
+
+    int direction = find_name(argv[2], direction_names, 5);
+    if (direction < 0) return false;
+    if (event.type == input_stick_x && (direction == up || direction == down)) return false;
+    if (event.type == input_stick_y && (direction == left || direction == right)) return false;
+
+    event.direction = (JoystickDirection)direction;
+    input_inject(&event);
+    return true;
+}
+
+static bool button_command(int argc, char **argv) {
+    if (argc != 2) return false;
+
+    bool press = strcmp(argv[1], "press") == 0;
+    bool down = press || strcmp(argv[1], "down") == 0;
+    bool up = press || strcmp(argv[1], "up") == 0;
+    if (!down && !up) return false;
+
+    InputEvent event = {};
+    event.type = input_button;
+    if (down) {
+        event.pressed = true;
+        input_inject(&event);
+    }
+    if (up) {
+        event.pressed = false;
+        input_inject(&event);
+    }
+    return true;
+}
+
+static bool tag_command(int argc, char **argv) {
+    if (argc != 3 && argc != 4) return false;
+
+    InputEvent event = {};
+    event.type = input_tag;
+    if (strcmp(argv[1], "arrive") == 0) {
+        event.rfid.type = tag_arrived;
+    } else if (strcmp(argv[1], "leave") == 0) {
+        event.rfid.type = tag_left;
+    } else {
+        return false;
+    }
+
+    if (!parse_uid(argv[2], event.rfid.uid, &event.rfid.uid_len)) return false;
+
+    if (argc == 4) {
+        int tower = find_name(argv[3], tower_names, TOWER_TYPE_COUNT);
+        if (tower < 0) return false;
+        event.rfid.tower = (TowerType)tower;
+    } else {
+        event.rfid.tower = tag_registry_lookup(event.rfid.uid, event.rfid.uid_len);
+    }
+
+    input_inject(&event);
+    return true;
+}
+
+void usb_input_init() {
+    usb_command_register("stick", stick_command, "x|y left|right|up|down|center");
+    usb_command_register("button", button_command, "down|up|press");
+    usb_command_register("tag", tag_command, "arrive|leave <uid hex> [dart|ninja|bomb|sniper|blank]");
+}
@@ -0,0 +1,30 @@
+#ifndef USB_INPUT_HH
+#define USB_INPUT_HH
+
+/*  NOTES:
+
+    Drives the game from the host, for unattended soak and perf runs
+    (tools/scenario_runner). Each command becomes an input_inject()
+    event, so it reaches handle_input through input_poll exactly like
+    the joystick and the reader would:
+
+        stick x left|right|center
+        stick y up|down|center
+        button down|up|press            press is down then up
+        tag arrive|leave <uid> [tower]  uid in hex, 4, 7 or 10 bytes.
+                                        tower is dart, ninja, bomb,
+                                        sniper or blank, otherwise it
+                                        is looked up in the registry
+
+    The real drivers keep running, so hands off the hardware during a
+    run.
+
+*/
+
+/**
+ * @brief registers the input commands, call once at boot after the
+ * tag registry is loaded
+ */
+void usb_input_init();
+
+#endif // USB_INPUT_HH
@@ -0,0 +1,66 @@
+#include "usb_packet.hh"
+
+#include "pico/stdlib.h"
+#include "pico/stdio_usb.h"
+#include "pico/stdio/driver.h"
+#include "tusb.h"
+
+#define SYNC_0 0xA5
+#define SYNC_1 0x5A
+
+// Packet partly written to USB, nothing else may start until it is done
+static const UsbPacket *sending = NULL;
+
+uint8_t *usb_packet_begin(UsbPacket *packet, UsbPacketType type, uint16_t seq) {
+    uint8_t *data = packet->data;
+    data[0] = SYNC_0;
+    data[1] = SYNC_1;
+    data[2] = type;
+    data[3] = seq & 0xFF;
+    data[4] = seq >> 8;
+    packet->length = 0;
+    packet->written = 0;
+    return data + USB_PACKET_HEADER_SIZE;
+}
+
+void usb_packet_end(UsbPacket *packet, int payload_length) {
+    uint8_t *data = packet->data;
+    data[5] = payload_length & 0xFF;
+    data[6] = payload_length >> 8;
+
+    uint32_t sum1 = 0, sum2 = 0;
+    for (int i = 2; i < USB_PACKET_HEADER_SIZE + payload_length; i++) {
+        sum1 = (sum1 + data[i]) % 255;
+        sum2 = (sum2 + sum1) % 255;
+    }
+
+    int length = USB_PACKET_HEADER_SIZE + payload_length;
+    data[length++] = sum1;
+    data[length++] = sum2;
+    packet->length = length;
+    packet->written = 0;
+}
+
+bool usb_packet_send(UsbPacket *packet) {
+    if (sending && sending != packet) return false;
+
+    while (packet->written < packet->length) {
+        int room = tud_cdc_write_available();
+        if (room <= 0) return false;
+
+        int count = packet->length - packet->written;
+        if (count > room) count = room;
+        stdio_usb.out_chars((const char *)packet->data + packet->written, count);
+        packet->written += count;
+        sending = packet;
+    }
+
+    if (sending == packet) sending = NULL;
+    return true;
+}
+
+void usb_packet_cancel(UsbPacket *packet) {
+    if (sending == packet) sending = NULL;
+    packet->length = 0;
+    packet->written = 0;
+}
@@ -0,0 +1,77 @@
+#ifndef USB_PACKET_HH
+#define USB_PACKET_HH
+
+#include <stdint.h>
+
+/*  NOTES:
+
+    Binary packets to the host over USB CDC, sharing the port with
+    printf text. Little endian:
+
+        A5 5A | type | seq u16 | length u16 | payload | fletcher16 u16
+
+    The checksum covers type through payload. A host scans for the sync
+    bytes, anything outside a packet is text.
+
+    Packets go out in pieces as the USB buffer makes room, but never
+    interleaved: once one has started, the others wait until it is done.
+    Sending never blocks.
+
+*/
+
+#define USB_PACKET_HEADER_SIZE 7
+#define USB_PACKET_CHECKSUM_SIZE 2
+#define USB_PACKET_PAYLOAD_MAX 258
+#define USB_PACKET_MAX (USB_PACKET_HEADER_SIZE + USB_PACKET_PAYLOAD_MAX + USB_PACKET_CHECKSUM_SIZE)
+
+enum UsbPacketType {
+    packet_frame_start = 0x01,      // frame_stream
+    packet_row,
+    packet_frame_end,
+
+    packet_log = 0x10,              // log
+    packet_log_dropped,
+
+    packet_profile = 0x20,          // profiler
+
+    packet_timing = 0x30,           // frame_timing
+
+    packet_display_list = 0x40,     // Cgam dl_capture
+};
+
+struct UsbPacket {
+    uint8_t data[USB_PACKET_MAX];
+    uint16_t length;     // 0 when there is nothing to send
+    uint16_t written;
+};
+
+/**
+ * @brief starts building a packet, the previous one must have been sent
+ *
+ * @return where the payload goes, up to USB_PACKET_PAYLOAD_MAX bytes
+ */
+uint8_t *usb_packet_begin(UsbPacket *packet, UsbPacketType type, uint16_t seq);
+
+/**
+ * @brief finishes the packet, it is then ready to send
+ *
+ * @param payload_length bytes written after usb_packet_begin
+ */
+void usb_packet_end(UsbPacket *packet, int payload_length);
+
+/**
+ * @brief writes as much of the packet as the USB buffer takes, call
+ * until true
+ *
+ * @return true once it is all out (or there was nothing to send),
+ * false if the buffer is full or another packet is still going out
+ */
+bool usb_packet_send(UsbPacket *packet);
+
+/**
+ * @brief throws away the packet, even half sent (the host then sees a
+ * bad checksum)
+ */
+void usb_packet_cancel(UsbPacket *packet);
+
+#endif // USB_PACKET_HH
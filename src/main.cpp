@@ -1,8 +1,11 @@
 #include <stdio.h>
 #include <stdbool.h>
+#include <stdlib.h>
 #include <string>
 #include "pico/stdlib.h"
 #include "pico/multicore.h"
+#include "pico/flash.h"
+#include "hardware/sync.h"
 
 // lib imports
 #include "rfid.hh"
@@ -10,45 +13,167 @@
 #include "matrix.hh"
 #include "oled_display.hh"
 #include "joystick.hh"
+#include "input.hh"
+#include "latency_trace.hh"
+#include "soft_timer.hh"
+#include "map_blob.hh"
 #include "buzzer_pwm.hh"
+#include "kv_store.hh"
+#include "kv_flash.hh"
+#include "save_data.hh"
+#include "frame_stream.hh"
+#include "frame_timing.hh"
+#include "usb_command.hh"
+#include "usb_input.hh"
+#include "log.hh"
+#include "profiler.hh"
 
 TowerType scanned_tower = blank;
 char *towers[] = {"Dart Monkey", "Ninja Monkey", "Bomb Tower", "Sniper Monkey"};
 
-JoystickDirection last_x = center;
-JoystickDirection last_y = center;
 char *directions[] = {"Left", "Right", "Up", "Down", "Center" };
-bool last_select = false;
+TowerType learn_tower = blank;
+
+// Map select runs at boot: left/right browse, select starts the level
+bool choosing_map = true;
+uint16_t map_index = 0;
+const MapRecord *map = NULL;
+
+// Main loop period, ~30 FPS
+#define FRAME_MS 33
+
+// Level load has to fit in one frame at 60 Hz
+#define MAP_LOAD_BUDGET_US 16667
+
+void load_map(uint16_t index) {
+    const MapRecord *next = map_get(index);
+    if (!next) return;
+
+    uint64_t start = time_us_64();
+    bool ok = load_background(next);
+    uint32_t elapsed = (uint32_t)(time_us_64() - start);
+
+    map = next;
+    map_index = index;
+    LOG("Loaded %s in %u us%s", map->name, elapsed, ok ? "" : ", background is corrupt");
+    if (elapsed > MAP_LOAD_BUDGET_US) LOG("  over the %u us budget", MAP_LOAD_BUDGET_US);
+
+    oled_print(choosing_map ? "Choose map: < >" : "Map:", map->name);
+}
+
+void handle_input(const InputEvent *event) {
+    switch (event->type) {
+        case input_tag:
+            if (event->rfid.type == tag_arrived) {
+                scanned_tower = event->rfid.tower;
+                LOG("Card on reader, tower: %d", scanned_tower);
+                if (event->rfid.has_loadout) {
+                    LOG("  %s, level %d", event->rfid.loadout.name, event->rfid.loadout.level);
+                }
+            } else {
+                if (event->rfid.tower == scanned_tower) scanned_tower = blank;
+                LOG("Card removed, tower: %d", event->rfid.tower);
+            }
+            break;
+
+        case input_stick_x:
+            LOG("Joystick X: %s", directions[event->direction]);
+
+            if (choosing_map && map_count() > 0) {
+                if (event->direction == right) load_map((map_index + 1) % map_count());
+                if (event->direction == left) load_map((map_index + map_count() - 1) % map_count());
+            }
+            break;
+
+        case input_stick_y:
+            LOG("Joystick Y: %s", directions[event->direction]);
+            break;
+
+        case input_button:
+            LOG("Joystick Sel: %s", event->pressed ? "true" : "false");
+
+            if (choosing_map) {
+                if (event->pressed) {
+                    choosing_map = false;
+                    load_map(map_index);
+                }
+                break;
+            }
+
+            // Each press arms learn mode for the next tower type,
+            // the next card scanned gets bound to it
+            if (event->pressed) {
+                learn_tower = (TowerType)((learn_tower + 1) % TOWER_TYPE_COUNT);
+                rfid_learn(learn_tower);
+                oled_print("Learn card as:", learn_tower == blank ? "(unbind)" : towers[learn_tower]);
+            }
+            break;
+    }
+}
 
 void sample_peripherals() {
-    if (rfid_flag) {
-        rfid_flag = false;
-        scanned_tower = sample_rfid();
-        printf("Scanned Tower: %d\n", scanned_tower);
+    InputEvent event;
+    while (input_poll(&event)) {
+        handle_input(&event);
+        latency_trace_input(&event);
     }
+}
 
-    if (joystick_flag) {
-        joystick_flag = false;
-        JoystickDirection x = sample_js_x();
-        JoystickDirection y = sample_js_y();
-        bool select = sample_js_select();
-
-        if (x != last_x) {
-            printf("Joystick X: %s\n", directions[x]);
-            last_x = x;
-        } 
-        if (y != last_y) {
-            printf("Joystick Y: %s\n", directions[y]);
-            last_y = y;
-        }
-        if (select != last_select) {
-            printf("Joystick Sel: %s\n", select ? "true" : "false");
-            last_select = select;
+// Core1 parks here while core0 erases a flash sector, the panel is
+// blanked so no row stays lit for the whole erase
+static volatile bool core1_running = false;
+static volatile bool pause_request = false;
+static volatile bool core1_parked = false;
+
+void pause_display(bool pause) {
+    if (!core1_running) return;
+
+    pause_request = pause;
+    while (core1_parked != pause) tight_loop_contents();
+}
+
+// Frame handoff to core1. Not through the FIFO: as a flash lockout
+// victim core1's FIFO IRQ throws away every word that isn't a lockout
+static volatile bool swap_request = false;
+
+void push_frame() {
+    // Stamped before core1 can see the request, it swaps right away
+    latency_trace_pushed();
+    __dmb();
+    swap_request = true;
+
+    // The drawing buffer is free again once core1 has swapped
+    while (swap_request) tight_loop_contents();
+}
+
+// Rest position drift worth a flash write
+#define JS_RECAL_COUNTS 16
+
+void apply_settings() {
+    Settings settings;
+    load_settings(&settings);
+    buzzer_set_volume(settings.volume);
+
+    // Recalibrate on every boot, but only save when it moved
+    uint16_t cx, cy;
+    uint8_t deadzone;
+    if (joystick_calibrate(&cx, &cy, &deadzone)) {
+        if (abs(cx - settings.js_center_x) > JS_RECAL_COUNTS ||
+            abs(cy - settings.js_center_y) > JS_RECAL_COUNTS ||
+            deadzone != settings.js_deadzone) {
+            settings.js_center_x = cx;
+            settings.js_center_y = cy;
+            settings.js_deadzone = deadzone;
+            save_settings(&settings);
         }
+    } else {
+        printf("Joystick moved during calibration, using saved center\n");
     }
+    joystick_set_calibration(settings.js_center_x, settings.js_center_y, settings.js_deadzone);
 }
 
 void init_peripherals() {
+    init_soft_timers();
     init_rfid();
     init_joystick();
     init_oled();
@@ -57,11 +182,27 @@ void init_peripherals() {
 }
 
 void render_matrix() {
+    // Lets core0 pause this core while it writes flash
+    flash_safe_execute_core_init();
+
+    core1_running = true;
+
     for (;;) {
+        latency_trace_scanout();
         render_frame();
-        if (multicore_fifo_rvalid()) {
-            multicore_fifo_pop_blocking();
+        profiler_core_poll();
+        if (swap_request) {
             swap_frames();
+            __dmb();
+            swap_request = false;
+            latency_trace_swapped();
+        }
+
+        if (pause_request) {
+            matrix_blank();
+            core1_parked = true;
+            while (pause_request) tight_loop_contents();
+            core1_parked = false;
         }
     }
 }
@@ -71,26 +212,75 @@ int main() {
     
     // Give time for USB serial to connect
     sleep_ms(3000);
+
+    // Store before peripherals, the tag registry loads from it. Catch up
+    // on erases now, while there is no display to stall
+    if (!kv_flash_init(pause_display)) printf("Save data unavailable\n");
+    while (kv_maintain()) {}
+
     init_peripherals();
+    apply_settings();
+
+    // Host commands over USB, the registry is loaded so tags resolve
+    frame_stream_init();
+    frame_timing_init();
+    usb_input_init();
+    profiler_init();
     
+    if (!map_blob_init()) printf("Map data is corrupt\n");
+
     multicore_launch_core1(render_matrix);
-    oled_print("Hello \1", "I have mucho \2");
+    load_map(0);
     start_sound();
 
+    absolute_time_t next_frame = get_absolute_time();
     for (;;) {
+        frame_timing_begin();
         sample_peripherals();
+        frame_timing_end_stage(timing_input);
         
         //render_game by calling set_pixel(x, y, Color)
+        set_background();
+        if (choosing_map && map) {
+            draw_text(1, 1, map->name, WHITE, &font_small);
+            draw_text(1, 26, "< select >", WHITE, &font_small);
+        }
+
         Tower t1;
         t1.type = ninja;
         t1.x_pos = 10;
         t1.y_pos = 10;
 
         set_tower(t1);
+        latency_trace_drawn();
+        frame_timing_end_stage(timing_draw);
+
+        frame_stream_capture(drawing_frame());
+        push_frame();
+        frame_timing_end_stage(timing_push);
+        latency_trace_poll();
+        frame_timing_end();
+
+        // An erase parks core1 and blanks the panel for ~50 ms, so only
+        // in map select, never mid-game. At most one sector per frame
+        if (choosing_map && kv_needs_maintenance()) kv_maintain();
+
+        // A frame that ran long starts the next one now instead of
+        // trying to catch up
+        next_frame = delayed_by_ms(next_frame, FRAME_MS);
+        if (time_reached(next_frame)) next_frame = get_absolute_time();
 
-        multicore_fifo_push_blocking(1);
-        sleep_ms(250);
-        // call multicore_fifo_push_blocking(1); to swap matrix frames
+        // Serve the host and stream the frame out while waiting for the
+        // next one, at least once even when there is no time left
+        do {
+            usb_command_poll();
+            profiler_core_poll();
+            log_drain();
+            profiler_drain();
+            frame_timing_drain();
+            frame_stream_poll();
+        } while (!time_reached(next_frame));
+        // call push_frame(); to swap matrix frames
 
     }
 }  
@@ -0,0 +1,223 @@
+// Times game_update() while a Bomber run and an Apache strike fly over
+// Canyon's 200-scout wave, compares radius queries against scanning
+// every enemy, and times a frame of 500 particles.
+//
+//   ./ability_bench [capture path]
+//
+// With a path, every strike frame's display list is written there for
+// tools/dl_replay.
+//
+// Exits non-zero if the slowest tick or the 99th percentile particle
+// frame, scaled to the target, is over budget.
+
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "../../Cgam/game_types.h"
+#include "../../lib/maps/map_blob.hh"
+#include "lib/matrix/matrix.h"
+
+// Simulation's share of the 33 ms frame in Cgam/src/main.cpp
+#define TICK_BUDGET_US 4000.0
+
+// Particle update and draw's share of the same frame
+#define PARTICLE_BUDGET_US 1000.0
+#define PARTICLE_LOAD 500
+
+// Rough cost of the same code on a 150 MHz Cortex-M33 relative to this
+// host. An estimate, replace it with a number measured on the board
+#define TARGET_SLOWDOWN 40.0
+
+#define DT (1.0f / 30.0f)
+#define CANYON 1
+#define BIG_WAVE 3
+
+Color framebuffer[MATRIX_ROWS][MATRIX_COLS];
+static GameState game;
+static DrawSnapshot snapshot;
+static DisplayList list;
+static uint8_t serialized[DL_HEADER_SIZE + MAX_DRAW_COMMANDS * DL_COMMAND_SIZE];
+
+typedef std::chrono::steady_clock Clock;
+
+static double micros(Clock::time_point a, Clock::time_point b) {
+    return std::chrono::duration<double, std::micro>(b - a).count();
+}
+
+static int alive() {
+    int n = 0;
+    for (int i = 0; i < game.enemy_count; i++) n += game.enemies[i].alive;
+    return n;
+}
+
+// What bomb_explode() would cost without the index
+static uint8_t scan_radius(float x, float y, float radius, uint8_t* out) {
+    uint8_t found = 0;
+    for (int i = 0; i < game.enemy_count; i++) {
+        const Enemy* e = &game.enemies[i];
+        if (e->alive && distance_squared(x, y, e->x, e->y) <= radius * radius) out[found++] = i;
+    }
+    return found;
+}
+
+static void compare_queries() {
+    const int queries = 100000;
+    uint8_t hits[MAX_ENEMIES];
+    uint32_t a = 0, b = 0;
+
+    game_index_enemies(&game);
+    auto t0 = Clock::now();
+    for (int q = 0; q < queries; q++) {
+        a += game_enemies_in_radius(&game, q % MATRIX_WIDTH, (q / 7) % MATRIX_HEIGHT, 4.0f, hits, MAX_ENEMIES);
+    }
+    auto t1 = Clock::now();
+    for (int q = 0; q < queries; q++) {
+        b += scan_radius(q % MATRIX_WIDTH, (q / 7) % MATRIX_HEIGHT, 4.0f, hits);
+    }
+    auto t2 = Clock::now();
+
+    printf("radius 4:     index %.3f us, scan %.3f us per query (%d enemies)%s\n",
+           micros(t0, t1) / queries, micros(t1, t2) / queries, alive(),
+           a == b ? "" : ", RESULTS DIFFER");
+}
+
+// Update + draw of a pool topped up to PARTICLE_LOAD every frame. Judged
+// on the 99th percentile frame, the worst one is mostly host scheduling
+static double time_particles() {
+    const int frames = 2000;
+    ParticleSystem* ps = &game.particles;
+    particles_init(ps);
+
+    std::vector<double> samples;
+    double worst = 0.0, total = 0.0;
+    for (int f = 0; f < frames; f++) {
+        for (int e = 0; ps->count < PARTICLE_LOAD; e++) {
+            particles_emit(ps, (ParticleEmitter)(e % PARTICLE_EMITTER_COUNT),
+                           (f * 7 + e * 13) % MATRIX_WIDTH, (f * 3 + e * 5) % MATRIX_HEIGHT,
+                           200, 40, 40, 1.0f);
+        }
+
+        auto t0 = Clock::now();
+        particles_update(ps, DT);
+        uint16_t count = particles_snapshot(ps, snapshot.sparks);
+        dl_begin(&list);
+        particles_draw(snapshot.sparks, count, &list);
+        dl_execute(&list);
+        auto t1 = Clock::now();
+
+        double us = micros(t0, t1);
+        if (us > worst) worst = us;
+        total += us;
+        samples.push_back(us);
+    }
+    std::sort(samples.begin(), samples.end());
+    double p99 = samples[frames * 99 / 100];
+
+    // Bursts into a full pool replace the oldest instead of failing
+    uint16_t before = ps->overwritten;
+    while (ps->count < MAX_PARTICLES) particles_emit(ps, PARTICLE_EXPLOSION, 32, 16, 0, 0, 0, 1.0f);
+    particles_emit(ps, PARTICLE_EXPLOSION, 32, 16, 0, 0, 0, 1.0f);
+
+    printf("particles:    %d live, update + draw mean %.1f us, p99 %.1f us, worst %.1f us on this host, "
+           "~%.0f us on target\n", PARTICLE_LOAD, total / frames, p99, worst, p99 * TARGET_SLOWDOWN);
+    printf("              burst into a full pool replaced %u of the oldest\n",
+           (unsigned)(ps->overwritten - before));
+    return p99 * TARGET_SLOWDOWN;
+}
+
+int main(int argc, char** argv) {
+    FILE* capture = NULL;
+    if (argc > 1 && !(capture = fopen(argv[1], "wb"))) {
+        printf("can't write %s\n", argv[1]);
+        return 1;
+    }
+
+    if (!map_blob_init()) {
+        printf("map blob is corrupt\n");
+        return 1;
+    }
+
+    game_init(&game);
+    game_load_map(&game, CANYON);
+    game.money = 1000;
+
+    // Let the big wave fill the path
+    game.wave_number = BIG_WAVE;
+    game_start_wave(&game);
+    int peak = 0;
+    while (game.wave_active && alive() < 190) {
+        game_update(&game, DT);
+        game_update_wave(&game, DT);
+        if (alive() > peak) peak = alive();
+    }
+
+    compare_queries();
+
+    game_activate_ability(&game, ABILITY_BOMBER);
+    game_activate_ability(&game, ABILITY_APACHE);
+    int before = alive();
+    uint16_t score = game.score;
+
+    double worst = 0.0, total = 0.0;
+    double snapshot_worst = 0.0, draw_worst = 0.0, execute_worst = 0.0;
+    uint16_t commands_max = 0;
+    uint32_t culled = 0, merged = 0;
+    int ticks = 0;
+    bool flying = true;
+    while (flying) {
+        auto t0 = Clock::now();
+        game_update(&game, DT);
+        game_update_wave(&game, DT);
+        auto t1 = Clock::now();
+
+        // The two halves of the pipeline in Cgam/src/main.cpp
+        game_snapshot(&game, &snapshot);
+        auto t2 = Clock::now();
+        dl_begin(&list);
+        dl_clear(&list, Color{48, 156, 48});
+        snapshot_draw(&snapshot, &list);
+        auto t3 = Clock::now();
+        dl_execute(&list);
+        auto t4 = Clock::now();
+        if (micros(t1, t2) > snapshot_worst) snapshot_worst = micros(t1, t2);
+        if (micros(t2, t3) > draw_worst) draw_worst = micros(t2, t3);
+        if (micros(t3, t4) > execute_worst) execute_worst = micros(t3, t4);
+        if (list.count > commands_max) commands_max = list.count;
+        culled += list.stats.culled;
+        merged += list.stats.merged;
+
+        if (capture) {
+            size_t bytes = dl_serialize(&list, serialized, sizeof(serialized));
+            fwrite(serialized, 1, bytes, capture);
+        }
+
+        double us = micros(t0, t1);
+        if (us > worst) worst = us;
+        total += us;
+        ticks++;
+
+        flying = false;
+        for (int i = 0; i < MAX_AIRCRAFT; i++) flying |= game.abilities.aircraft[i].active;
+        for (int i = 0; i < MAX_BOMBS; i++) flying |= game.abilities.bombs[i].active;
+    }
+
+    double particle_target = time_particles();
+
+    double target = worst * TARGET_SLOWDOWN;
+    printf("strike:       %d ticks over %d enemies, score +%d, %u bombs lost to a full pool\n",
+           ticks, before, game.score - score, game.abilities.bombs_dropped);
+    printf("game_update:  mean %.1f us, worst %.1f us on this host, ~%.0f us on target\n",
+           total / ticks, worst, target);
+    printf("snapshot:     worst %.1f us, snapshot_draw worst %.1f us on this host (%zu byte snapshot)\n",
+           snapshot_worst, draw_worst, sizeof(DrawSnapshot));
+    printf("display list: execute worst %.1f us, max %u commands (%u bytes), per frame %u culled, %u merged\n",
+           execute_worst, commands_max, DL_HEADER_SIZE + commands_max * DL_COMMAND_SIZE,
+           culled / ticks, merged / ticks);
+    if (capture) fclose(capture);
+    bool ok = target <= TICK_BUDGET_US && particle_target <= PARTICLE_BUDGET_US;
+    printf("%s (budget %.0f us per tick, %.0f us for particles)\n", ok ? "OK" : "OVER BUDGET",
+           TICK_BUDGET_US, PARTICLE_BUDGET_US);
+    return ok ? 0 : 1;
+}
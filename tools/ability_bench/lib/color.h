@@ -0,0 +1,11 @@
+// Host stand-in for the Cgam color header
+#ifndef COLOR_H
+#define COLOR_H
+
+#include <stdint.h>
+
+typedef struct {
+    uint8_t r, g, b;
+} Color;
+
+#endif // COLOR_H
@@ -0,0 +1,12 @@
+// Host stand-in for the Cgam matrix header, drawing goes to memory
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include "../color.h"
+
+#define MATRIX_ROWS 32
+#define MATRIX_COLS 64
+
+extern Color framebuffer[MATRIX_ROWS][MATRIX_COLS];
+
+#endif // MATRIX_H
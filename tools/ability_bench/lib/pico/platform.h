@@ -0,0 +1,7 @@
+// Host stand-in, the map blob is an ordinary array here
+#ifndef PICO_PLATFORM_H
+#define PICO_PLATFORM_H
+
+#define __in_flash(group)
+
+#endif // PICO_PLATFORM_H
@@ -0,0 +1,147 @@
+"""
+Records Cgam's display lists off the board (Cgam/dl_capture) into a
+capture dl_replay reads
+
+Usage:
+    python3 dl_capture.py /dev/ttyACM0 capture.dl [--frames 30] [--seconds 20]
+                          [--record raw.bin]
+    python3 dl_capture.py --replay raw.bin capture.dl
+
+Live, it sends "capture <frames>" and stops after that many lists, or
+sends "capture stop" when the time runs out. printf text from the board
+is printed as it arrives. --record saves the raw bytes, --replay pulls
+the lists out of a saved recording.
+
+The packet format is in Cgam/dl_capture.h, the list format in
+Cgam/display_list.h, keep them in sync.
+"""
+
+import argparse
+import os
+import struct
+import sys
+import time
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+import usb_packet
+from usb_packet import PACKET_DISPLAY_LIST
+
+CHUNK = struct.Struct("<HH")            # frame, offset
+LIST_HEADER = struct.Struct("<2sBBHH")  # magic, version, pad, commands, pad
+LIST_MAGIC = b"DL"
+COMMAND_SIZE = 8
+
+
+class ListAssembler:
+    """Puts lists back together from their pieces"""
+
+    def __init__(self):
+        self.reader = usb_packet.PacketReader()
+        self.lists = []                 # (frame, bytes)
+        self.working = None
+        self.frame = None
+        self.last_seq = None
+        self.broken = 0                 # lists lost to a missing piece
+
+    def feed(self, data):
+        """Returns the text lines this data completes, lists are kept"""
+        lines = []
+        for item in self.reader.feed(data):
+            if isinstance(item, str):
+                lines.append(item)
+            elif item is usb_packet.CORRUPT:
+                self.drop()
+            elif item.kind == PACKET_DISPLAY_LIST:
+                self.packet(item.seq, item.payload)
+        return lines
+
+    def drop(self):
+        if self.working is not None:
+            self.broken += 1
+        self.working = None
+
+    def packet(self, seq, payload):
+        if self.last_seq is not None and seq != (self.last_seq + 1) & 0xFFFF:
+            self.drop()
+        self.last_seq = seq
+
+        frame, offset = CHUNK.unpack_from(payload)
+        piece = payload[CHUNK.size:]
+        if offset == 0:
+            self.drop()
+            self.working = bytearray()
+            self.frame = frame
+        if self.working is None or frame != self.frame or offset != len(self.working):
+            self.drop()
+            return
+
+        self.working += piece
+        if len(self.working) < LIST_HEADER.size:
+            return
+        magic, _, _, commands, _ = LIST_HEADER.unpack_from(self.working)
+        total = LIST_HEADER.size + commands * COMMAND_SIZE
+        if magic != LIST_MAGIC or len(self.working) > total:
+            self.drop()
+        elif len(self.working) == total:
+            self.lists.append((self.frame, bytes(self.working)))
+            self.working = None
+
+
+def capture(port_name, frames, seconds, assembler, record):
+    import serial
+    port = serial.Serial(port_name, timeout=0.05)
+
+    try:
+        port.write(f"capture {frames}\n".encode())
+        end = time.monotonic() + seconds
+        while len(assembler.lists) < frames and time.monotonic() < end:
+            data = port.read(port.in_waiting or 1)
+            if record:
+                record.write(data)
+            for line in assembler.feed(data):
+                print(line)
+        if len(assembler.lists) < frames:
+            port.write(b"capture stop\n")
+    except KeyboardInterrupt:
+        port.write(b"capture stop\n")
+    finally:
+        port.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Record Cgam display lists for dl_replay")
+    parser.add_argument("port", nargs="?", help="serial port, e.g. /dev/ttyACM0 or COM5")
+    parser.add_argument("output", help="capture file to write")
+    parser.add_argument("--frames", type=int, default=30, help="lists to capture, 1 to 1000")
+    parser.add_argument("--seconds", type=float, default=20, help="give up after this long")
+    parser.add_argument("--record", help="also save the raw bytes here")
+    parser.add_argument("--replay", help="read a saved recording instead of a port")
+    args = parser.parse_args()
+
+    assembler = ListAssembler()
+    if args.replay:
+        with open(args.replay, "rb") as f:
+            assembler.feed(f.read())
+    elif args.port:
+        record = open(args.record, "wb") if args.record else None
+        try:
+            capture(args.port, args.frames, args.seconds, assembler, record)
+        finally:
+            if record:
+                record.close()
+    else:
+        parser.error("give a serial port or --replay")
+
+    with open(args.output, "wb") as f:
+        for _, data in assembler.lists:
+            f.write(data)
+
+    frames = [frame for frame, _ in assembler.lists]
+    skipped = sum((b - a - 1) & 0xFFFF for a, b in zip(frames, frames[1:]))
+    print(f"{len(frames)} lists in {args.output}, {skipped} frames skipped on the board, "
+          f"{assembler.broken} lists broken, {assembler.reader.bad_packets} corrupt packets")
+    return 0 if frames else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
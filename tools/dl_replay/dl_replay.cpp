@@ -0,0 +1,97 @@
+// Replays recorded display lists (Cgam/display_list.h) through the same
+// executor the board runs, so a captured frame comes out pixel exact.
+//
+//   ./dl_replay capture.dl [output dir]
+//
+// Prints one line per frame. With an output dir, each frame is also
+// written there as frame_NNNN.ppm, scaled up for viewing.
+// Exits non-zero if the capture is not a whole number of valid lists.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <vector>
+
+#include "../../Cgam/display_list.h"
+#include "../lib/matrix/matrix.h"
+
+#define SCALE 8
+
+Color framebuffer[MATRIX_ROWS][MATRIX_COLS];
+static DisplayList list;
+
+// FNV-1a over the frame, to compare frames without dumping them
+static uint32_t checksum() {
+    uint32_t hash = 2166136261u;
+    const uint8_t* p = (const uint8_t*)framebuffer;
+    for (size_t i = 0; i < sizeof(framebuffer); i++) {
+        hash = (hash ^ p[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static bool write_ppm(const char* dir, int frame) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/frame_%04d.ppm", dir, frame);
+    FILE* out = fopen(path, "wb");
+    if (!out) return false;
+
+    fprintf(out, "P6\n%d %d\n255\n", MATRIX_COLS * SCALE, MATRIX_ROWS * SCALE);
+    for (int y = 0; y < MATRIX_ROWS * SCALE; y++) {
+        for (int x = 0; x < MATRIX_COLS * SCALE; x++) {
+            const Color& c = framebuffer[y / SCALE][x / SCALE];
+            uint8_t rgb[3] = {c.r, c.g, c.b};
+            fwrite(rgb, 1, 3, out);
+        }
+    }
+    fclose(out);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printf("usage: %s capture.dl [output dir]\n", argv[0]);
+        return 1;
+    }
+
+    FILE* in = fopen(argv[1], "rb");
+    if (!in) {
+        printf("can't read %s\n", argv[1]);
+        return 1;
+    }
+    std::vector<uint8_t> data;
+    uint8_t buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), in)) > 0) data.insert(data.end(), buf, buf + n);
+    fclose(in);
+
+    const char* dir = argc > 2 ? argv[2] : NULL;
+    size_t offset = 0;
+    int frame = 0;
+
+    while (offset < data.size()) {
+        size_t used = dl_deserialize(&data[offset], data.size() - offset, &list);
+        if (!used) {
+            printf("frame %d: not a valid display list at byte %zu\n", frame, offset);
+            return 1;
+        }
+        offset += used;
+
+        auto t0 = std::chrono::steady_clock::now();
+        dl_execute(&list);
+        auto t1 = std::chrono::steady_clock::now();
+
+        printf("frame %4d: %4u commands, %5zu bytes, %4u culled, %6.2f us, %08x\n",
+               frame, list.count, used, list.stats.culled,
+               std::chrono::duration<double, std::micro>(t1 - t0).count(), checksum());
+
+        if (dir && !write_ppm(dir, frame)) {
+            printf("can't write to %s\n", dir);
+            return 1;
+        }
+        frame++;
+    }
+
+    printf("%d frames\n", frame);
+    return 0;
+}
@@ -0,0 +1,243 @@
+"""
+Live viewer for the firmware's USB frame stream (lib/usb/frame_stream)
+Shows what the panel shows, in the gam4 LED matrix window
+
+Usage:
+    python3 frame_viewer.py /dev/ttyACM0 [--record stream.bin]
+    python3 frame_viewer.py --replay stream.bin [--headless]
+
+Live, it sends "stream start" and "stream stop" when closed. printf
+text from the board is printed as it arrives. --record saves the raw bytes,
+--replay decodes a saved stream as fast as it can.
+
+The packet format is documented in lib/usb/frame_stream.hh, keep the two
+in sync.
+"""
+
+import argparse
+import os
+import sys
+import time
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+import usb_packet
+from usb_packet import PACKET_FRAME_START, PACKET_ROW, PACKET_FRAME_END
+
+WIDTH = 64
+HEIGHT = 32
+
+# Ask again if a keyframe hasn't shown up this long after asking
+KEYFRAME_RETRY_S = 0.5
+
+
+class StreamDecoder:
+    """Rebuilds frames from the packet stream"""
+
+    def __init__(self):
+        self.reader = usb_packet.PacketReader()
+        self.frame = [[(0, 0, 0)] * WIDTH for _ in range(HEIGHT)]
+        self.working = None
+        self.seq = None             # frame being received
+        self.last_seq = None        # last frame completed
+        self.synced = False         # holding a full picture, deltas apply
+        self.want_keyframe = True
+        self.lines = []
+
+        self.frames = 0
+        self.keyframes = 0
+        self.lost_frames = 0
+        self.board_dropped = 0
+        self.bytes = 0
+
+    @property
+    def bad_packets(self):
+        return self.reader.bad_packets
+
+    def feed(self, data):
+        """
+        Consume received bytes
+
+        Returns:
+            list: frames completed by this data, each HEIGHT rows of
+            WIDTH (r, g, b)
+        """
+        self.bytes += len(data)
+        done = []
+
+        for item in self.reader.feed(data):
+            if isinstance(item, str):
+                self.lines.append(item)
+            elif item is usb_packet.CORRUPT:
+                self.lose_sync()
+            else:
+                frame = self.packet(item.kind, item.seq, item.payload)
+                if frame is not None:
+                    done.append(frame)
+
+        return done
+
+    def lose_sync(self):
+        self.synced = False
+        self.working = None
+        self.want_keyframe = True
+
+    def packet(self, kind, seq, payload):
+        if kind == PACKET_FRAME_START:
+            keyframe = payload[0] & 1
+            expected = self.last_seq is not None and seq == (self.last_seq + 1) & 0xFFFF
+            # Lost: starts that never arrived, and the last one if it never completed
+            if self.seq is not None:
+                self.lost_frames += (seq - self.seq - 1) & 0xFFFF
+                if self.seq != self.last_seq:
+                    self.lost_frames += 1
+
+            if keyframe:
+                self.keyframes += 1
+                self.synced = True
+                self.want_keyframe = False
+            elif not (self.synced and expected):
+                self.lose_sync()
+
+            self.seq = seq
+            self.working = [row[:] for row in self.frame] if self.synced else None
+
+        elif kind == PACKET_ROW:
+            if self.working is None or seq != self.seq:
+                return None
+            row, x = payload[0], payload[1]
+            if row >= HEIGHT:
+                self.lose_sync()
+                return None
+            line = self.working[row]
+            for i in range(2, len(payload) - 3, 4):
+                count, r, g, b = payload[i:i + 4]
+                if x + count > WIDTH:
+                    self.lose_sync()
+                    return None
+                line[x:x + count] = [(r, g, b)] * count
+                x += count
+
+        elif kind == PACKET_FRAME_END:
+            if self.working is None or seq != self.seq:
+                # Missed its start, so some of its rows too
+                self.lose_sync()
+                return None
+            self.board_dropped = payload[1] | (payload[2] << 8)
+            self.frame = self.working
+            self.working = None
+            self.last_seq = seq
+            self.frames += 1
+            return self.frame
+
+        return None
+
+    def take_text(self):
+        """Returns complete lines of printf text received so far"""
+        lines, self.lines = self.lines, []
+        return lines
+
+
+def open_window():
+    sys.path.insert(0, os.path.join(os.path.dirname(__file__), "..", "..", "gam4"))
+    from led_matrix import LEDMatrixSimulator
+    return LEDMatrixSimulator(WIDTH, HEIGHT, pixel_size=10)
+
+
+def report(decoder, elapsed):
+    fps = decoder.frames / elapsed if elapsed > 0 else 0
+    print(f"{decoder.frames} frames ({decoder.keyframes} key), {fps:.1f} fps, "
+          f"{decoder.bytes / max(elapsed, 1e-6) / 1024:.1f} KiB/s, "
+          f"{decoder.bad_packets} bad packets, {decoder.lost_frames} lost, "
+          f"{decoder.board_dropped} dropped on the board")
+
+
+def replay(args):
+    with open(args.replay, "rb") as f:
+        data = f.read()
+
+    decoder = StreamDecoder()
+    matrix = None if args.headless else open_window()
+
+    start = time.monotonic()
+    for offset in range(0, len(data), 4096):
+        for frame in decoder.feed(data[offset:offset + 4096]):
+            if matrix:
+                matrix.buffer = frame
+                if not matrix.update_display():
+                    matrix.close()
+                    return 0
+        for line in decoder.take_text():
+            print(line)
+
+    report(decoder, time.monotonic() - start)
+    if matrix:
+        matrix.close()
+    return 0 if decoder.frames else 1
+
+
+def live(args):
+    import serial
+
+    port = serial.Serial(args.port, timeout=0.01)
+    record = open(args.record, "wb") if args.record else None
+    decoder = StreamDecoder()
+    matrix = open_window()
+
+    port.write(b"stream start\n")
+    start = last_report = time.monotonic()
+    asked = 0.0
+
+    try:
+        running = True
+        while running:
+            data = port.read(port.in_waiting or 1)
+            if record:
+                record.write(data)
+
+            frames = decoder.feed(data)
+            for line in decoder.take_text():
+                print(line)
+
+            now = time.monotonic()
+            if decoder.want_keyframe and now - asked > KEYFRAME_RETRY_S:
+                port.write(b"stream key\n")
+                asked = now
+
+            # Only draw the newest, the window is slower than the stream
+            if frames:
+                matrix.buffer = frames[-1]
+                running = matrix.update_display()
+
+            if now - last_report > 5:
+                report(decoder, now - start)
+                last_report = now
+    except KeyboardInterrupt:
+        pass
+    finally:
+        port.write(b"stream stop\n")
+        port.close()
+        if record:
+            record.close()
+        matrix.close()
+
+    report(decoder, time.monotonic() - start)
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Show the board's USB frame stream")
+    parser.add_argument("port", nargs="?", help="serial port, e.g. /dev/ttyACM0 or COM5")
+    parser.add_argument("--record", help="also save the raw stream here")
+    parser.add_argument("--replay", help="decode a saved stream instead of a port")
+    parser.add_argument("--headless", action="store_true", help="with --replay, no window")
+    args = parser.parse_args()
+
+    if args.replay:
+        return replay(args)
+    if not args.port:
+        parser.error("give a serial port or --replay")
+    return live(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,148 @@
+#include "host_flash.hh"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_SECTORS KV_MAX_SECTORS
+
+static FILE *file = NULL;
+static uint8_t *image = NULL;
+static uint32_t image_size = 0;
+static kv_backend_t backend;
+
+static int32_t power_budget = -1;
+static bool dead = false;
+
+// Erase counters live in RAM next to the image, a real chip has no such thing
+static uint32_t erase_counts[MAX_SECTORS];
+static uint32_t erases = 0;
+static uint32_t programs = 0;
+static uint32_t violations = 0;
+
+static void write_through(uint32_t offset, uint32_t len) {
+    fseek(file, offset, SEEK_SET);
+    fwrite(&image[offset], 1, len, file);
+    fflush(file);
+}
+
+// Bytes the operation may touch before the power goes
+static uint32_t allowance(uint32_t len) {
+    if (power_budget < 0) return len;
+    if ((uint32_t)power_budget >= len) {
+        power_budget -= len;
+        return len;
+    }
+    uint32_t n = power_budget;
+    power_budget = 0;
+    dead = true;
+    return n;
+}
+
+static const uint8_t *flash_map(uint32_t offset) {
+    return &image[offset];
+}
+
+static bool flash_program(uint32_t offset, const uint8_t *data, uint32_t len) {
+    if (dead || offset % backend.page_size || len % backend.page_size ||
+        offset + len > image_size) {
+        return false;
+    }
+
+    programs += len / backend.page_size;
+    uint32_t n = allowance(len);
+    for (uint32_t i = 0; i < n; i++) {
+        // 0xFF is "leave alone", anything else must only clear bits
+        if (data[i] != 0xFF && (data[i] & ~image[offset + i])) violations++;
+        image[offset + i] &= data[i];
+    }
+    write_through(offset, n);
+    return !dead;
+}
+
+static bool flash_erase(uint32_t offset) {
+    if (dead || offset % backend.sector_size || offset >= image_size) return false;
+
+    erases++;
+    erase_counts[offset / backend.sector_size]++;
+    uint32_t n = allowance(backend.sector_size);
+    memset(&image[offset], 0xFF, n);
+    write_through(offset, n);
+    return !dead;
+}
+
+bool host_flash_open(const char *path, uint8_t sectors, uint32_t sector_size, uint32_t page_size) {
+    host_flash_close();
+    if (sectors > MAX_SECTORS) return false;
+
+    image_size = (uint32_t)sectors * sector_size;
+    image = (uint8_t *)malloc(image_size);
+    memset(image, 0xFF, image_size);
+
+    file = fopen(path, "r+b");
+    if (file) {
+        fseek(file, 0, SEEK_END);
+        if ((uint32_t)ftell(file) != image_size) {
+            fclose(file);
+            file = NULL;
+        } else {
+            fseek(file, 0, SEEK_SET);
+            if (fread(image, 1, image_size, file) != image_size) return false;
+        }
+    }
+    if (!file) {
+        file = fopen(path, "w+b");
+        if (!file) return false;
+        write_through(0, image_size);
+        memset(erase_counts, 0, sizeof(erase_counts));
+    }
+
+    backend.sector_size = sector_size;
+    backend.page_size = page_size;
+    backend.sector_count = sectors;
+    backend.map = flash_map;
+    backend.program = flash_program;
+    backend.erase = flash_erase;
+
+    power_budget = -1;
+    dead = false;
+    erases = 0;
+    programs = 0;
+    violations = 0;
+    return true;
+}
+
+void host_flash_close(void) {
+    if (file) fclose(file);
+    free(image);
+    file = NULL;
+    image = NULL;
+}
+
+const kv_backend_t *host_flash_backend(void) {
+    return &backend;
+}
+
+void host_flash_cut_power_after(int32_t bytes) {
+    power_budget = bytes;
+}
+
+bool host_flash_dead(void) {
+    return dead;
+}
+
+uint32_t host_flash_erase_count(uint8_t sector) {
+    return sector < MAX_SECTORS ? erase_counts[sector] : 0;
+}
+
+uint32_t host_flash_erases(void) {
+    return erases;
+}
+
+uint32_t host_flash_programs(void) {
+    return programs;
+}
+
+uint32_t host_flash_violations(void) {
+    return violations;
+}
@@ -0,0 +1,64 @@
+#ifndef HOST_FLASH_HH
+#define HOST_FLASH_HH
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "kv_store.hh"
+
+/*  NOTES:
+
+    File-backed NOR flash image for running lib/storage on Linux.
+    Programming can only clear bits (new = old & data) and erasing
+    sets a sector to 0xFF, like the real part. Every operation is
+    written through to the file, so closing and reopening the image
+    behaves like a reboot.
+
+    host_flash_cut_power_after() makes a later program or erase stop
+    part way through. After that every operation fails until the
+    image is reopened, like a board that lost power.
+
+*/
+
+/**
+ * Open (or create, blank) an image of 'sectors' sectors
+ */
+bool host_flash_open(const char *path, uint8_t sectors, uint32_t sector_size, uint32_t page_size);
+
+/**
+ * Close the image, the file keeps its contents
+ */
+void host_flash_close(void);
+
+/**
+ * Backend for kv_mount()
+ */
+const kv_backend_t *host_flash_backend(void);
+
+/**
+ * Lose power after 'bytes' more bytes are programmed or erased, -1 = never
+ */
+void host_flash_cut_power_after(int32_t bytes);
+
+/**
+ * @return true once a power cut has happened
+ */
+bool host_flash_dead(void);
+
+/**
+ * Erases a sector has seen since the image was created
+ */
+uint32_t host_flash_erase_count(uint8_t sector);
+
+/**
+ * Total erases and page programs since open
+ */
+uint32_t host_flash_erases(void);
+uint32_t host_flash_programs(void);
+
+/**
+ * Programs that tried to set a 0 bit back to 1 (a bug in the caller)
+ */
+uint32_t host_flash_violations(void);
+
+#endif // HOST_FLASH_HH
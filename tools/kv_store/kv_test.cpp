@@ -0,0 +1,317 @@
+// Tests for lib/storage/kv_store on a file-backed flash image.
+//
+//   ./kv_test [image path] [seed]
+//
+// Exits non-zero if any check fails.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <map>
+#include <string>
+
+#include "host_flash.hh"
+#include "kv_store.hh"
+
+#define SECTORS 8
+#define SECTOR_SIZE 4096
+#define PAGE_SIZE 256
+
+static const char *path = "kv_test.img";
+static uint32_t rng = 1;
+static int failures = 0;
+
+#define CHECK(cond, ...) do {                 \
+        if (!(cond)) {                        \
+            failures++;                       \
+            printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+            printf(__VA_ARGS__);              \
+            printf("\n");                     \
+        }                                     \
+    } while (0)
+
+typedef std::map<std::string, std::string> model_t;
+
+static uint32_t rand32() {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static void fresh() {
+    remove(path);
+    host_flash_open(path, SECTORS, SECTOR_SIZE, PAGE_SIZE);
+    kv_mount(host_flash_backend());
+}
+
+// Close and reopen the image, like a power cycle
+static void reboot() {
+    host_flash_open(path, SECTORS, SECTOR_SIZE, PAGE_SIZE);
+    kv_mount(host_flash_backend());
+}
+
+static bool put(const std::string &key, const std::string &value) {
+    return kv_put(key.data(), key.size(), value.data(), value.size());
+}
+
+static bool matches(const model_t &model, const char *when) {
+    bool ok = true;
+    for (const auto &kv : model) {
+        char buf[KV_VALUE_MAX];
+        int len = kv_get(kv.first.data(), kv.first.size(), buf, sizeof(buf));
+        if (len != (int)kv.second.size() || memcmp(buf, kv.second.data(), len) != 0) {
+            CHECK(false, "%s: key '%s' has wrong value (len %d, want %zu)",
+                  when, kv.first.c_str(), len, kv.second.size());
+            ok = false;
+        }
+    }
+
+    kv_stats_t stats;
+    kv_get_stats(&stats);
+    if (stats.keys != model.size()) {
+        CHECK(false, "%s: %u keys stored, expected %zu", when, stats.keys, model.size());
+        ok = false;
+    }
+    return ok;
+}
+
+static std::string random_key(int keys) {
+    char key[16];
+    snprintf(key, sizeof(key), "k%d", (int)(rand32() % keys));
+    return key;
+}
+
+static std::string random_value(int max_len) {
+    std::string value(rand32() % (max_len + 1), '\0');
+    for (auto &c : value) c = (char)rand32();
+    return value;
+}
+
+// Puts may only append. Returns false if the store is full even after maintenance
+static bool put_or_maintain(const std::string &key, const std::string &value) {
+    uint32_t erases = host_flash_erases();
+    bool ok = put(key, value);
+    CHECK(host_flash_erases() == erases, "kv_put erased flash");
+
+    while (!ok && kv_maintain()) {
+        ok = put(key, value);
+    }
+    return ok;
+}
+
+// ====== Tests ======
+
+static void test_basic() {
+    fresh();
+    model_t model;
+
+    CHECK(kv_get("none", 4, NULL, 0) == -1, "missing key found");
+    CHECK(put("volume", "\x32"), "put");
+    CHECK(put("name", "monkey"), "put");
+    CHECK(put("name", "bloon"), "overwrite");
+    model["volume"] = "\x32";
+    model["name"] = "bloon";
+    matches(model, "basic");
+
+    CHECK(kv_delete("volume", 6), "delete");
+    model.erase("volume");
+    CHECK(kv_delete("volume", 6), "delete of a missing key");
+    matches(model, "after delete");
+
+    // Empty values are values
+    CHECK(put("empty", ""), "empty put");
+    model["empty"] = "";
+
+    reboot();
+    matches(model, "after reboot");
+
+    // Prefix iteration, for the tag registry
+    put("t:1", "a");
+    put("t:2", "b");
+    put("x:1", "c");
+    int seen = 0;
+    kv_foreach("t:", 2, [](const uint8_t *, uint8_t, const uint8_t *, uint16_t, void *ctx) {
+        (*(int *)ctx)++;
+    }, &seen);
+    CHECK(seen == 2, "foreach saw %d keys with prefix", seen);
+
+    CHECK(!kv_put("", 0, "x", 1), "empty key accepted");
+    std::string big(KV_VALUE_MAX + 1, 'x');
+    CHECK(!put("big", big), "oversized value accepted");
+    CHECK(host_flash_violations() == 0, "programmed a 0 bit back to 1");
+}
+
+static void test_churn(uint32_t ops) {
+    fresh();
+    model_t model;
+    uint32_t full = 0;
+
+    for (uint32_t i = 0; i < ops; i++) {
+        std::string key = random_key(48);
+
+        if (rand32() % 8 == 0) {
+            CHECK(kv_delete(key.data(), key.size()) || (kv_maintain() && kv_delete(key.data(), key.size())),
+                  "delete failed");
+            model.erase(key);
+        } else {
+            std::string value = random_value(64);
+            if (put_or_maintain(key, value)) model[key] = value;
+            else full++;
+        }
+
+        // Game loop calls maintenance at safe points now and then
+        if (rand32() % 64 == 0) kv_maintain();
+
+        if (i % 5000 == 0) {
+            matches(model, "churn");
+            reboot();
+            matches(model, "churn after reboot");
+        }
+    }
+
+    CHECK(full == 0, "%u puts failed with the store not full", full);
+    matches(model, "churn end");
+
+    kv_stats_t stats;
+    kv_get_stats(&stats);
+    uint32_t min = UINT32_MAX, max = 0;
+    for (int s = 0; s < SECTORS; s++) {
+        uint32_t n = host_flash_erase_count(s);
+        if (n < min) min = n;
+        if (n > max) max = n;
+    }
+    printf("churn:        %u ops, %u keys, erases per sector %u..%u, %u/%u bytes live\n",
+           ops, stats.keys, min, max, stats.live_bytes, stats.used_bytes);
+    CHECK(max - min <= 2, "uneven wear: %u..%u erases", min, max);
+    CHECK(host_flash_violations() == 0, "programmed a 0 bit back to 1");
+}
+
+// Cut the power at a random byte, reboot and check nothing committed was lost
+static void test_power_cut(uint32_t trials) {
+    uint32_t cuts = 0;
+
+    for (uint32_t t = 0; t < trials; t++) {
+        fresh();
+        model_t model;
+
+        // Some history, so compaction has work to do
+        uint32_t warmup = rand32() % 1500;
+        for (uint32_t i = 0; i < warmup; i++) {
+            std::string key = random_key(32);
+            std::string value = random_value(48);
+            if (put_or_maintain(key, value)) model[key] = value;
+        }
+
+        host_flash_cut_power_after(rand32() % 20000);
+
+        std::string pending_key, pending_value;
+        bool pending_delete = false;
+        while (!host_flash_dead()) {
+            pending_key = random_key(32);
+            uint32_t op = rand32() % 16;
+
+            if (op == 0) {
+                pending_key.clear();
+                kv_maintain();
+            } else if (op == 1) {
+                pending_delete = true;
+                if (kv_delete(pending_key.data(), pending_key.size())) model.erase(pending_key);
+            } else {
+                pending_delete = false;
+                pending_value = random_value(48);
+                if (put_or_maintain(pending_key, pending_value)) model[pending_key] = pending_value;
+            }
+        }
+        cuts++;
+
+        host_flash_cut_power_after(-1);
+        reboot();
+
+        // The interrupted op may or may not have landed, everything else must have
+        if (!pending_key.empty()) {
+            char buf[KV_VALUE_MAX];
+            int len = kv_get(pending_key.data(), pending_key.size(), buf, sizeof(buf));
+            bool landed = pending_delete
+                ? len < 0
+                : len == (int)pending_value.size() && memcmp(buf, pending_value.data(), len) == 0;
+            if (landed) {
+                if (pending_delete) model.erase(pending_key);
+                else model[pending_key] = pending_value;
+            }
+        }
+
+        if (!matches(model, "after power cut")) {
+            printf("  trial %u\n", t);
+            break;
+        }
+
+        // And the store keeps working
+        for (int i = 0; i < 200; i++) {
+            std::string key = random_key(32);
+            std::string value = random_value(48);
+            if (put_or_maintain(key, value)) model[key] = value;
+        }
+        while (kv_maintain()) {}
+        reboot();
+        matches(model, "writes after power cut");
+    }
+
+    printf("power cut:    %u cuts survived\n", cuts);
+}
+
+static void test_capacity() {
+    fresh();
+    model_t model;
+
+    // Tag registry sized load: 340 cards plus settings and scores
+    for (int i = 0; i < 340; i++) {
+        char key[12] = {'t'};
+        for (int j = 1; j < 11; j++) key[j] = (char)rand32();
+        std::string k(key, 11);
+        model[k] = std::string(1, (char)(i % 4));
+        CHECK(put_or_maintain(k, model[k]), "card %d did not fit", i);
+    }
+    model["settings"] = random_value(16);
+    model["scores"] = random_value(60);
+    put_or_maintain("settings", model["settings"]);
+    put_or_maintain("scores", model["scores"]);
+
+    // Rebind every card a few times, the log wraps and compacts
+    for (int round = 0; round < 4; round++) {
+        for (auto &kv : model) {
+            kv.second = random_value(kv.second.size());
+            CHECK(put_or_maintain(kv.first, kv.second), "rebind failed");
+        }
+    }
+    matches(model, "capacity");
+
+    auto t0 = std::chrono::steady_clock::now();
+    reboot();
+    auto t1 = std::chrono::steady_clock::now();
+    matches(model, "capacity after reboot");
+
+    kv_stats_t stats;
+    kv_get_stats(&stats);
+    printf("mount:        %u keys, %u bytes scanned, %.1f us on this host\n", stats.keys,
+           stats.mount_bytes_scanned,
+           std::chrono::duration<double, std::micro>(t1 - t0).count());
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) path = argv[1];
+    rng = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : 0x4B56;
+    if (rng == 0) rng = 1;
+
+    test_basic();
+    test_churn(50000);
+    test_power_cut(300);
+    test_capacity();
+
+    host_flash_close();
+    remove(path);
+
+    printf("%s (%d failures)\n", failures ? "FAILED" : "OK", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,224 @@
+"""
+Expands the firmware's deferred log records (lib/log) into text
+Format strings are read from the firmware ELF the board is running
+
+Usage:
+    python3 log_expand.py .pio/build/proton/firmware.elf /dev/ttyACM0 [--record log.bin]
+    python3 log_expand.py .pio/build/proton/firmware.elf --replay log.bin
+
+Prints one line per record:
+
+    [   12.345678 c0] Card on reader, tower: 1
+
+printf text from the board passes through as is. Frame stream packets
+are skipped.
+
+The packet format is in lib/usb/usb_packet.hh, the record layout in
+lib/log/log.cpp, keep them in sync.
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+import usb_packet
+from usb_packet import PACKET_LOG, PACKET_LOG_DROPPED
+
+# printf conversions, same set lib/log accepts
+SPEC = re.compile(r"%([-+ #0]*[0-9]*(?:\.[0-9]*)?)(hh|h|ll|l|z|t)?([diuxXocfFeEgGs%])")
+
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+
+
+class Elf:
+    """Just enough ELF to read a C string at a load address"""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        if self.data[:4] != b"\x7fELF":
+            sys.exit(f"{path} is not an ELF file")
+
+        wide = self.data[4] == 2
+        endian = "<" if self.data[5] == 1 else ">"
+        if wide:
+            shoff, = struct.unpack_from(endian + "Q", self.data, 0x28)
+            shentsize, shnum = struct.unpack_from(endian + "HH", self.data, 0x3A)
+            section = struct.Struct(endian + "IIQQQQIIQQ")
+        else:
+            shoff, = struct.unpack_from(endian + "I", self.data, 0x20)
+            shentsize, shnum = struct.unpack_from(endian + "HH", self.data, 0x2E)
+            section = struct.Struct(endian + "IIIIIIIIII")
+
+        # (address, end, file offset) of every loaded section with contents
+        self.sections = []
+        for i in range(shnum):
+            _, kind, flags, address, offset, size, *_ = section.unpack_from(
+                self.data, shoff + i * shentsize)
+            if flags & SHF_ALLOC and kind != SHT_NOBITS and size:
+                self.sections.append((address, address + size, offset))
+        self.cache = {}
+
+    def string(self, address):
+        if address in self.cache:
+            return self.cache[address]
+        text = None
+        for start, end, offset in self.sections:
+            if start <= address < end:
+                at = offset + address - start
+                stop = self.data.find(b"\0", at, offset + end - start)
+                if stop >= 0:
+                    text = self.data[at:stop].decode("utf-8", "replace")
+                break
+        self.cache[address] = text
+        return text
+
+
+def expand(format, args):
+    """Formats a record, arguments that didn't fit print as ..."""
+    out = []
+    position = 0
+    offset = 0
+    short = False
+    for match in SPEC.finditer(format):
+        out.append(format[position:match.start()])
+        position = match.end()
+        flags, length, conversion = match.groups()
+        if conversion == "%":
+            out.append("%")
+            continue
+        if short:
+            out.append("...")
+            continue
+
+        if conversion == "s":
+            if offset >= len(args) or offset + 1 + args[offset] > len(args):
+                short = True
+                out.append("...")
+                continue
+            size = args[offset]
+            value = args[offset + 1:offset + 1 + size].decode("utf-8", "replace")
+            offset += 1 + size
+        elif conversion in "fFeEgG":
+            if offset + 4 > len(args):
+                short = True
+                out.append("...")
+                continue
+            value, = struct.unpack_from("<f", args, offset)
+            offset += 4
+        else:
+            size = 8 if length == "ll" else 4
+            if offset + size > len(args):
+                short = True
+                out.append("...")
+                continue
+            value = int.from_bytes(args[offset:offset + size], "little")
+            if conversion in "di" and value >= 1 << (8 * size - 1):
+                value -= 1 << (8 * size)
+            offset += size
+            if conversion == "u":
+                conversion = "d"
+        out.append(("%" + flags + conversion) % value)
+
+    out.append(format[position:])
+    return "".join(out)
+
+
+class LogDecoder:
+    """Splits the port's bytes into text and packets, expands log records"""
+
+    def __init__(self, elf):
+        self.elf = elf
+        self.reader = usb_packet.PacketReader()
+        self.last_seq = None
+        self.records = 0
+        self.lost = 0
+
+    @property
+    def bad_packets(self):
+        return self.reader.bad_packets
+
+    def feed(self, data):
+        """Returns the lines this data completes"""
+        lines = []
+        for item in self.reader.feed(data):
+            if isinstance(item, str):
+                lines.append(item)
+            elif item is not usb_packet.CORRUPT:
+                line = self.packet(item.kind, item.seq, item.payload)
+                if line is not None:
+                    lines.extend(line.split("\n"))
+        return lines
+
+    def packet(self, kind, seq, payload):
+        if kind not in (PACKET_LOG, PACKET_LOG_DROPPED):
+            return None
+
+        if self.last_seq is not None and seq != (self.last_seq + 1) & 0xFFFF:
+            missed = (seq - self.last_seq - 1) & 0xFFFF
+            self.lost += missed
+            note = f"[{missed} log packets lost on the wire]\n"
+        else:
+            note = ""
+        self.last_seq = seq
+
+        if kind == PACKET_LOG_DROPPED:
+            core, dropped = struct.unpack_from("<BI", payload)
+            return note + f"[c{core}: {dropped} records dropped since boot, ring full]"
+
+        core, address, time_us = struct.unpack_from("<BII", payload)
+        args = payload[9:]
+        self.records += 1
+
+        format = self.elf.string(address)
+        if format is None:
+            message = f"<no string at 0x{address:08x}, wrong ELF?> {args.hex()}"
+        else:
+            message = expand(format, args)
+        return note + f"[{time_us / 1e6:12.6f} c{core}] {message}"
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Expand the board's deferred log")
+    parser.add_argument("elf", help="firmware ELF the board runs")
+    parser.add_argument("port", nargs="?", help="serial port, e.g. /dev/ttyACM0 or COM5")
+    parser.add_argument("--record", help="also save the raw bytes here")
+    parser.add_argument("--replay", help="expand a saved capture instead of a port")
+    args = parser.parse_args()
+
+    decoder = LogDecoder(Elf(args.elf))
+
+    if args.replay:
+        with open(args.replay, "rb") as f:
+            data = f.read()
+        for line in decoder.feed(data):
+            print(line)
+        return 0
+    if not args.port:
+        parser.error("give a serial port or --replay")
+
+    import serial
+    port = serial.Serial(args.port, timeout=0.05)
+    record = open(args.record, "wb") if args.record else None
+    try:
+        while True:
+            data = port.read(port.in_waiting or 1)
+            if record:
+                record.write(data)
+            for line in decoder.feed(data):
+                print(line, flush=True)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        port.close()
+        if record:
+            record.close()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,417 @@
+"""
+Map compiler for the tower defense firmware
+Turns gam4 JSON maps into the binary blob read by lib/maps
+
+Usage:
+    python3 compile_maps.py maps/forest.json [more.json ...] \
+        -o ../../lib/maps/map_data.cpp [--bin maps.bin] [--png-dir out/]
+
+Each map's background is prerendered (or read from the PNG named by
+"background_image") and stored palette-RLE compressed.
+
+The blob layout is documented in lib/maps/map_blob.hh, keep the two in sync.
+"""
+
+import argparse
+import json
+import os
+import random
+import struct
+import sys
+import zlib
+
+MAGIC = 0x504D4454  # "TDMP"
+VERSION = 3
+
+HEADER = struct.Struct("<IHHII")                       # magic, version, count, size, crc
+RECORD = struct.Struct("<16sBB3sB2xhhhhHHHHIIIIIII")   # see MapRecord
+POINT = struct.Struct("<hh")
+DECORATION = struct.Struct("<hhB3x")
+WAVE = struct.Struct("<IH2x")                          # event offset, event count
+SPAWN = struct.Struct("<HBB")                          # delay ms, enemy type, path
+
+DECORATION_TYPES = {"tree": 0, "rock": 1, "lake": 2}
+ENEMY_TYPES = {"scout": 0, "tank": 1, "splitter": 2, "ghost": 3}
+
+# A wave that is just a number means this many scouts, one a second
+COUNT_INTERVAL = 1.0
+NAME_MAX = 15
+
+# Background runs: one byte, high nibble = length - 1, low nibble = palette index
+PALETTE_MAX = 16
+RUN_MAX = 16
+
+# Same colors as lib/led_matrix/color.hh
+PATH = (255, 193, 7)
+TREE_GREEN = (75, 99, 42)
+TREE_BROWN = (87, 62, 8)
+ROCK_GRAY = (75, 75, 75)
+LAKE_BLUE = (0, 0, 150)
+
+# Tree sprite from lib/led_matrix/sprites.cpp, None shows the grass through
+G, B = TREE_GREEN, TREE_BROWN
+TREE_SPRITE = [
+    [G, G, G],
+    [G, G, G],
+    [G, G, G],
+    [None, B, None],
+    [B, B, B],
+]
+
+
+def align4(data):
+    """Pad a bytearray to a multiple of 4"""
+    while len(data) % 4:
+        data.append(0)
+
+
+def check_point(name, what, point, width, height):
+    x, y = point
+    if not (0 <= x < width and 0 <= y < height):
+        sys.exit(f"{name}: {what} {point} is outside the {width}x{height} map")
+    return x, y
+
+
+def compile_wave(filename, number, wave):
+    """Spawn groups to a time-sorted list of (delay since previous ms, type, path).
+    A group is {"type", "count", "interval" s, "delay" s from wave start, "path"},
+    groups may overlap and are merged in time order"""
+    if isinstance(wave, int):
+        wave = [{"type": "scout", "count": wave, "interval": COUNT_INTERVAL}]
+
+    spawns = []
+    for order, group in enumerate(wave):
+        kind = group.get("type", "scout")
+        if kind not in ENEMY_TYPES:
+            sys.exit(f"{filename}: wave {number + 1} has unknown enemy type '{kind}'")
+        # Maps have a single path so far
+        if group.get("path", 0) != 0:
+            sys.exit(f"{filename}: wave {number + 1} uses path {group['path']}, maps have one path")
+
+        delay = round(group.get("delay", 0.0) * 1000)
+        interval = round(group.get("interval", COUNT_INTERVAL) * 1000)
+        for i in range(group.get("count", 1)):
+            spawns.append((delay + i * interval, order, ENEMY_TYPES[kind], 0))
+
+    spawns.sort()
+    if len(spawns) > 0xFFFF:
+        sys.exit(f"{filename}: wave {number + 1} has {len(spawns)} spawns, at most 65535 fit")
+
+    events, last = [], 0
+    for time, _, kind, path in spawns:
+        if time - last > 0xFFFF:
+            sys.exit(f"{filename}: wave {number + 1} waits over 65 s between two spawns")
+        events.append((time - last, kind, path))
+        last = time
+    return events
+
+
+def load_map(filename):
+    """Read one gam4 map with the same defaults as gam4/map_data.py"""
+    with open(filename) as f:
+        data = json.load(f)
+
+    name = data.get("name", "Unnamed")
+    width = data.get("width", 64)
+    height = data.get("height", 32)
+    if (width, height) != (64, 32):
+        sys.exit(f"{filename}: maps must be 64x32, not {width}x{height}")
+    if len(name) > NAME_MAX:
+        sys.exit(f"{filename}: name '{name}' is longer than {NAME_MAX} characters")
+
+    path = [check_point(filename, "path point", p, width, height) for p in data["path"]]
+    if len(path) < 2:
+        sys.exit(f"{filename}: path needs at least two points")
+
+    decorations = []
+    for deco in data.get("decorations", []):
+        kind = deco.get("type", "tree")
+        if kind not in DECORATION_TYPES:
+            sys.exit(f"{filename}: unknown decoration type '{kind}'")
+        decorations.append((deco.get("x", 0), deco.get("y", 0), DECORATION_TYPES[kind]))
+
+    return {
+        "name": name,
+        "width": width,
+        "height": height,
+        "background": data.get("background_color", [0, 50, 0]),
+        "path": path,
+        "slots": [check_point(filename, "tower slot", t, width, height) for t in data.get("towers", [])],
+        "spawn": data.get("spawn", list(path[0])),
+        "end": data.get("end", list(path[-1])),
+        "decorations": decorations,
+        "waves": [compile_wave(filename, i, w) for i, w in enumerate(data.get("waves", [5, 8, 12]))],
+        "image": data.get("background_image"),
+        "dir": os.path.dirname(filename),
+        "file": filename,
+    }
+
+
+# ====== Backgrounds ======
+
+def shade(color, amount):
+    return tuple(max(0, min(255, c + amount)) for c in color)
+
+
+def fill_rect(image, x, y, w, h, color):
+    for row in range(y, y + h):
+        for col in range(x, x + w):
+            if 0 <= col < len(image[0]) and 0 <= row < len(image):
+                image[row][col] = color
+
+
+def bresenham(x1, y1, x2, y2):
+    """Same line walk as gam4/map_render.py"""
+    dx, dy = abs(x2 - x1), abs(y2 - y1)
+    sx = 1 if x1 < x2 else -1
+    sy = 1 if y1 < y2 else -1
+    err = dx - dy
+    while True:
+        yield x1, y1
+        if x1 == x2 and y1 == y2:
+            return
+        e2 = 2 * err
+        if e2 > -dy:
+            err -= dy
+            x1 += sx
+        if e2 < dx:
+            err += dx
+            y1 += sy
+
+
+def prerender(m):
+    """Grass, the 3-wide path and decorations, like gam4/map_render.py.
+    The texture is sparse speckles from a few shades so it stays RLE friendly,
+    and seeded by the map name so rebuilding gives the same bytes"""
+    rng = random.Random(m["name"])
+    base = tuple(m["background"])
+    grass = [base] * 14 + [shade(base, 12), shade(base, -12)]
+    path = [PATH] * 9 + [shade(PATH, -30)]
+
+    image = [[rng.choice(grass) for _ in range(m["width"])] for _ in range(m["height"])]
+
+    for (x1, y1), (x2, y2) in zip(m["path"], m["path"][1:]):
+        for x, y in bresenham(x1, y1, x2, y2):
+            if y1 == y2:
+                for py in (y - 1, y, y + 1):
+                    fill_rect(image, x, py, 1, 1, rng.choice(path))
+            else:
+                for px in (x - 1, x, x + 1):
+                    fill_rect(image, px, y, 1, 1, rng.choice(path))
+
+    # Decorations are placed by their center
+    for x, y, kind in m["decorations"]:
+        if kind == DECORATION_TYPES["tree"]:
+            for row, line in enumerate(TREE_SPRITE):
+                for col, color in enumerate(line):
+                    if color:
+                        fill_rect(image, x - 1 + col, y - 1 + row, 1, 1, color)
+        elif kind == DECORATION_TYPES["rock"]:
+            fill_rect(image, x - 1, y - 1, 2, 2, ROCK_GRAY)
+            fill_rect(image, x + 1, y, 1, 1, ROCK_GRAY)
+        elif kind == DECORATION_TYPES["lake"]:
+            fill_rect(image, x - 1, y - 1, 6, 2, LAKE_BLUE)
+            fill_rect(image, x, y - 2, 3, 1, LAKE_BLUE)
+            fill_rect(image, x + 1, y + 1, 3, 1, LAKE_BLUE)
+    return image
+
+
+def png_chunks(data):
+    pos = 8
+    while pos < len(data):
+        length, kind = struct.unpack(">I4s", data[pos:pos + 8])
+        yield kind, data[pos + 8:pos + 8 + length]
+        pos += 12 + length
+
+
+def read_png(filename):
+    """8-bit RGB or RGBA, non-interlaced, which is what every editor saves"""
+    with open(filename, "rb") as f:
+        data = f.read()
+    if data[:8] != b"\x89PNG\r\n\x1a\n":
+        sys.exit(f"{filename}: not a PNG")
+
+    idat = b""
+    for kind, chunk in png_chunks(data):
+        if kind == b"IHDR":
+            width, height, depth, color_type, _, _, interlace = struct.unpack(">IIBBBBB", chunk)
+        elif kind == b"IDAT":
+            idat += chunk
+    if depth != 8 or color_type not in (2, 6) or interlace:
+        sys.exit(f"{filename}: save as 8-bit RGB or RGBA, not interlaced")
+
+    bpp = 3 if color_type == 2 else 4
+    stride = width * bpp
+    raw = zlib.decompress(idat)
+    rows, prev = [], bytearray(stride)
+    for y in range(height):
+        filt = raw[y * (stride + 1)]
+        line = bytearray(raw[y * (stride + 1) + 1:(y + 1) * (stride + 1)])
+        for i in range(stride):
+            a = line[i - bpp] if i >= bpp else 0
+            b = prev[i]
+            c = prev[i - bpp] if i >= bpp else 0
+            if filt == 1:
+                line[i] = (line[i] + a) & 0xFF
+            elif filt == 2:
+                line[i] = (line[i] + b) & 0xFF
+            elif filt == 3:
+                line[i] = (line[i] + (a + b) // 2) & 0xFF
+            elif filt == 4:
+                p = a + b - c
+                pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+                pred = a if pa <= pb and pa <= pc else (b if pb <= pc else c)
+                line[i] = (line[i] + pred) & 0xFF
+        rows.append([tuple(line[x * bpp:x * bpp + 3]) for x in range(width)])
+        prev = line
+    return width, height, rows
+
+
+def write_png(filename, image):
+    """For --png-dir, a starting point for hand-drawn backgrounds"""
+    def chunk(kind, body):
+        return struct.pack(">I", len(body)) + kind + body + struct.pack(">I", zlib.crc32(kind + body))
+
+    raw = b"".join(b"\x00" + bytes(c for pixel in row for c in pixel) for row in image)
+    with open(filename, "wb") as f:
+        f.write(b"\x89PNG\r\n\x1a\n")
+        f.write(chunk(b"IHDR", struct.pack(">IIBBBBB", len(image[0]), len(image), 8, 2, 0, 0, 0)))
+        f.write(chunk(b"IDAT", zlib.compress(raw, 9)))
+        f.write(chunk(b"IEND", b""))
+
+
+def background(m):
+    if not m["image"]:
+        return prerender(m)
+
+    filename = os.path.join(m["dir"], m["image"])
+    width, height, image = read_png(filename)
+    if (width, height) != (m["width"], m["height"]):
+        sys.exit(f"{filename}: background is {width}x{height}, the map is {m['width']}x{m['height']}")
+    return image
+
+
+def compress(name, image):
+    """Palette of the colors used, then runs in row-major order"""
+    palette = []
+    for row in image:
+        for pixel in row:
+            if pixel not in palette:
+                palette.append(pixel)
+    if len(palette) > PALETTE_MAX:
+        sys.exit(f"{name}: background uses {len(palette)} colors, at most {PALETTE_MAX} fit")
+
+    runs = bytearray()
+    pixels = [palette.index(p) for row in image for p in row]
+    i = 0
+    while i < len(pixels):
+        n = 1
+        while n < RUN_MAX and i + n < len(pixels) and pixels[i + n] == pixels[i]:
+            n += 1
+        runs.append((n - 1) << 4 | pixels[i])
+        i += n
+    return palette, bytes(runs)
+
+
+def build_blob(maps):
+    """Header, then one record per map, then the arrays each record points at"""
+    records_start = HEADER.size
+    body = bytearray(RECORD.size * len(maps))
+
+    records = []
+    for m in maps:
+        offsets = {}
+        for key, packer, rows in (
+            ("path", POINT, m["path"]),
+            ("slots", POINT, m["slots"]),
+            ("decorations", DECORATION, m["decorations"]),
+        ):
+            align4(body)
+            offsets[key] = records_start + len(body)
+            for row in rows:
+                body += packer.pack(*row)
+
+        # Each wave's events, then the wave table pointing at them
+        wave_rows = []
+        for events in m["waves"]:
+            align4(body)
+            wave_rows.append((records_start + len(body), len(events)))
+            for event in events:
+                body += SPAWN.pack(*event)
+        align4(body)
+        offsets["waves"] = records_start + len(body)
+        for row in wave_rows:
+            body += WAVE.pack(*row)
+
+        palette, runs = compress(m["file"], m["pixels"])
+        align4(body)
+        offsets["palette"] = records_start + len(body)
+        body += b"".join(bytes(c) for c in palette)
+        align4(body)
+        offsets["background"] = records_start + len(body)
+        body += runs
+        m["rle_size"] = len(runs)
+
+        records.append(RECORD.pack(
+            m["name"].encode("ascii"),
+            m["width"], m["height"], bytes(m["background"]), len(palette),
+            m["spawn"][0], m["spawn"][1], m["end"][0], m["end"][1],
+            len(m["path"]), len(m["slots"]), len(m["decorations"]), len(m["waves"]),
+            offsets["path"], offsets["slots"], offsets["decorations"], offsets["waves"],
+            offsets["palette"], offsets["background"], m["rle_size"],
+        ))
+    align4(body)
+
+    body[0:RECORD.size * len(maps)] = b"".join(records)
+    size = HEADER.size + len(body)
+    crc = zlib.crc32(body) & 0xFFFFFFFF
+    return HEADER.pack(MAGIC, VERSION, len(maps), size, crc) + bytes(body)
+
+
+def write_source(filename, blob, sources):
+    lines = [
+        "// Generated by tools/map_compiler/compile_maps.py, do not edit.",
+        "// Sources: " + ", ".join(sources),
+        "",
+        '#include "pico/platform.h"',
+        '#include "map_blob.hh"',
+        "",
+        "// Stays in flash and is read in place through XIP",
+        f"alignas(4) const uint8_t __in_flash(\"maps\") map_blob_data[{len(blob)}] = {{",
+    ]
+    for i in range(0, len(blob), 16):
+        lines.append("    " + " ".join(f"0x{b:02x}," for b in blob[i:i + 16]))
+    lines.append("};")
+    lines.append("")
+    with open(filename, "w") as f:
+        f.write("\n".join(lines))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compile gam4 JSON maps into the firmware map blob")
+    parser.add_argument("maps", nargs="+", help="JSON map files, in map index order")
+    parser.add_argument("-o", "--output", required=True, help="C++ source to write")
+    parser.add_argument("--bin", help="also write the raw blob here")
+    parser.add_argument("--png-dir", help="also write each background as a PNG here")
+    args = parser.parse_args()
+
+    maps = [load_map(f) for f in args.maps]
+    for m in maps:
+        m["pixels"] = background(m)
+        if args.png_dir:
+            write_png(os.path.join(args.png_dir, os.path.basename(m["file"])[:-5] + ".png"), m["pixels"])
+    blob = build_blob(maps)
+
+    write_source(args.output, blob, [f.split("/")[-1] for f in args.maps])
+    if args.bin:
+        with open(args.bin, "wb") as f:
+            f.write(blob)
+
+    for m in maps:
+        print(f"  {m['name']}: background {m['rle_size']} bytes "
+              f"({m['width'] * m['height'] * 3} raw)")
+    print(f"{len(maps)} map(s), {len(blob)} bytes")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,174 @@
+// Latency benchmark for the PN532 UART driver against pn532_emu.
+// Times are virtual (wire time at 115200 baud plus emulated PN532
+// delays), so results are comparable across machines and builds.
+//
+//   ./pn532_bench [trials]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+#include "host_sdk.hh"
+#include "pn532_emu.hh"
+#include "pn532_uart.hh"
+
+static pn532_emu_t emu;
+static pn532_uart_t dev;
+
+static const uint8_t TAG_UID[4] = {0x04, 0xC7, 0x1A, 0x33};
+static const uint8_t TAG2_UID[7] = {0x04, 0x76, 0x5E, 0x22, 0x91, 0x6C, 0x80};
+
+typedef struct {
+    uint64_t min_us;
+    uint64_t max_us;
+    uint64_t total_us;
+    uint32_t count;
+} stat_t;
+
+static void stat_add(stat_t *s, uint64_t us) {
+    if (s->count == 0 || us < s->min_us) s->min_us = us;
+    if (us > s->max_us) s->max_us = us;
+    s->total_us += us;
+    s->count++;
+}
+
+static void stat_print(const char *name, const stat_t *s) {
+    if (s->count == 0) {
+        printf("%-28s no samples\n", name);
+        return;
+    }
+    printf("%-28s min %6.2f ms  avg %6.2f ms  max %6.2f ms  (n=%u)\n", name,
+           s->min_us / 1000.0, (double)s->total_us / s->count / 1000.0,
+           s->max_us / 1000.0, s->count);
+}
+
+static void setup(const pn532_emu_config_t *config, uint8_t tag_count) {
+    host_reset();
+    pn532_emu_init(&emu, config);
+    host_attach(uart0, &emu);
+    pn532_uart_init(&dev, uart0, 0, 1, 115200);
+
+    pn532_emu_tag_t tags[2] = {
+        pn532_emu_make_tag(TAG_UID, sizeof(TAG_UID)),
+        pn532_emu_make_tag(TAG2_UID, sizeof(TAG2_UID)),
+    };
+    pn532_emu_set_tags(&emu, tags, tag_count, time_us_64());
+}
+
+// Poll once per game frame until the scan finishes.
+// Returns virtual time to completion; *blocked_us collects time spent inside poll().
+static pn532_status_t run_scan(uint8_t max_targets, uint64_t frame_us, uint64_t *elapsed_us,
+                               uint64_t *blocked_us, uint64_t *polls, double *poll_ns) {
+    uint64_t start = time_us_64();
+    pn532_uart_start_passive_target(&dev, max_targets, 200, NULL, NULL);
+
+    pn532_status_t status;
+    for (;;) {
+        uint64_t before = time_us_64();
+        auto t0 = std::chrono::steady_clock::now();
+        status = pn532_uart_poll(&dev);
+        auto t1 = std::chrono::steady_clock::now();
+        *blocked_us += time_us_64() - before;
+        *poll_ns += std::chrono::duration<double, std::nano>(t1 - t0).count();
+        (*polls)++;
+
+        if (status != PN532_WAIT_ACK && status != PN532_WAIT_RESPONSE) break;
+        host_advance_us(frame_us);
+    }
+
+    *elapsed_us = time_us_64() - start;
+    return status;
+}
+
+static void bench_time_to_uid(uint32_t trials, uint64_t frame_us, uint8_t cards) {
+    pn532_emu_config_t config = pn532_emu_default_config();
+    stat_t s = {};
+    uint64_t blocked = 0, polls = 0;
+    double poll_ns = 0.0;
+
+    setup(&config, cards);
+    for (uint32_t i = 0; i < trials; i++) {
+        uint64_t elapsed;
+        pn532_target_t targets[PN532_MAX_TARGETS];
+        if (run_scan(cards, frame_us, &elapsed, &blocked, &polls, &poll_ns) == PN532_DONE &&
+            pn532_uart_get_passive_targets(&dev, targets, PN532_MAX_TARGETS) == cards) {
+            stat_add(&s, elapsed);
+        }
+        host_advance_us(frame_us);
+    }
+
+    char name[64];
+    snprintf(name, sizeof(name), "%d UID%s @%llu us/frame", cards, cards > 1 ? "s" : "",
+             (unsigned long long)frame_us);
+    stat_print(name, &s);
+    printf("%-28s blocked %llu us total, %.0f ns host CPU per poll\n", "",
+           (unsigned long long)blocked, polls ? poll_ns / polls : 0.0);
+}
+
+static void bench_no_tag(uint32_t trials) {
+    pn532_emu_config_t config = pn532_emu_default_config();
+    stat_t s = {};
+    uint64_t blocked = 0, polls = 0;
+    double poll_ns = 0.0;
+
+    setup(&config, 0);
+    for (uint32_t i = 0; i < trials; i++) {
+        uint64_t elapsed;
+        if (run_scan(1, 1000, &elapsed, &blocked, &polls, &poll_ns) == PN532_TIMEOUT) {
+            stat_add(&s, elapsed);
+        }
+    }
+
+    stat_print("empty-field timeout", &s);
+    printf("%-28s blocked %llu us total\n", "", (unsigned long long)blocked);
+}
+
+// Garbage lands on the line just before the ACK; measure until a UID is read
+static void bench_recovery(uint32_t trials, uint32_t garbage) {
+    pn532_emu_config_t config = pn532_emu_default_config();
+    stat_t s = {};
+    uint32_t lost = 0;
+
+    for (uint32_t i = 0; i < trials; i++) {
+        config.seed = 0x532 + i;
+        setup(&config, 1);
+
+        uint64_t start = time_us_64();
+        pn532_emu_inject_noise(&emu, garbage, start);
+
+        bool got = false;
+        for (int attempt = 0; attempt < 10 && !got; attempt++) {
+            uint64_t elapsed, blocked = 0, polls = 0;
+            double poll_ns = 0.0;
+            if (run_scan(1, 1000, &elapsed, &blocked, &polls, &poll_ns) == PN532_DONE) {
+                uint8_t uid[10], uid_len;
+                got = pn532_uart_get_passive_target(&dev, uid, &uid_len);
+            }
+        }
+
+        if (got) stat_add(&s, time_us_64() - start);
+        else lost++;
+    }
+
+    char name[64];
+    snprintf(name, sizeof(name), "recovery after %u B garbage", garbage);
+    stat_print(name, &s);
+    if (lost) printf("%-28s %u trials never recovered\n", "", lost);
+}
+
+int main(int argc, char **argv) {
+    uint32_t trials = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 200;
+
+    bench_time_to_uid(trials, 1000, 1);
+    bench_time_to_uid(trials, 16667, 1);
+    bench_time_to_uid(trials, 1000, 2);
+    bench_no_tag(trials / 10 + 1);
+
+    const uint32_t garbage[] = {8, 64, 256, 1024};
+    for (uint32_t g : garbage) {
+        bench_recovery(trials, g);
+    }
+
+    return 0;
+}
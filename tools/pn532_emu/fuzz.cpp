@@ -0,0 +1,202 @@
+// Protocol fuzzer for the PN532 frame parser and the UART driver.
+// Runs on Linux against pn532_emu, see README.md for the build line.
+//
+//   ./pn532_fuzz [iterations] [seed]
+//
+// Exits non-zero if any invariant is broken.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_sdk.hh"
+#include "pn532_emu.hh"
+#include "pn532_uart.hh"
+
+static uint32_t rng = 1;
+static int failures = 0;
+
+#define CHECK(cond, ...) do {                 \
+        if (!(cond)) {                        \
+            failures++;                       \
+            printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+            printf(__VA_ARGS__);              \
+            printf("\n");                     \
+        }                                     \
+    } while (0)
+
+static uint32_t rand32() {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static float randf() {
+    return (rand32() & 0xFFFF) / 65536.0f;
+}
+
+// ====== Parser ======
+
+// Random bytes must never crash the parser or report impossible frames
+static void fuzz_parser_random(uint32_t iterations) {
+    pn532_parser_t p;
+    pn532_parser_reset(&p);
+
+    uint32_t frames = 0, errors = 0;
+    for (uint32_t i = 0; i < iterations * 64; i++) {
+        // Bias towards 00 and FF so start codes show up often
+        uint32_t r = rand32();
+        uint8_t c = (r & 3) == 0 ? 0x00 : (r & 3) == 1 ? 0xFF : (uint8_t)(r >> 8);
+
+        switch (pn532_parser_feed(&p, c)) {
+            case PN532_FRAME_DATA:
+                frames++;
+                CHECK(p.data_len == p.len - 1, "data_len %d for LEN %d", p.data_len, p.len);
+                break;
+            case PN532_FRAME_ERROR:
+                errors++;
+                break;
+            default:
+                break;
+        }
+    }
+
+    printf("parser/random:    %u bytes, %u frames, %u errors\n", iterations * 64, frames, errors);
+}
+
+// A valid frame after any garbage must be received within a bounded number of repeats
+static void fuzz_parser_resync(uint32_t iterations) {
+    uint32_t worst_repeats = 0;
+
+    for (uint32_t i = 0; i < iterations; i++) {
+        pn532_parser_t p;
+        pn532_parser_reset(&p);
+
+        uint8_t params[PN532_FRAME_MAX_DATA];
+        uint8_t params_len = rand32() % 32;
+        for (uint8_t j = 0; j < params_len; j++) params[j] = (uint8_t)rand32();
+        uint8_t cmd = (uint8_t)rand32();
+
+        uint8_t frame[PN532_FRAME_MAX_SIZE];
+        size_t len = pn532_frame_build(frame, PN532_PN532_TO_HOST, cmd, params, params_len);
+
+        uint32_t garbage = rand32() % 512;
+        for (uint32_t j = 0; j < garbage; j++) {
+            uint32_t r = rand32();
+            pn532_parser_feed(&p, (r & 1) ? 0x00 : (uint8_t)(r >> 8));
+        }
+
+        // Worst case garbage opened a 255-byte frame that swallows our copies
+        uint32_t max_repeats = (PN532_FRAME_MAX_SIZE + len - 1) / len + 1;
+        uint32_t repeats = 0;
+        bool got = false;
+
+        while (!got && repeats < max_repeats) {
+            repeats++;
+            for (size_t j = 0; j < len && !got; j++) {
+                if (pn532_parser_feed(&p, frame[j]) == PN532_FRAME_DATA &&
+                    p.tfi == PN532_PN532_TO_HOST &&
+                    p.data_len == params_len + 1 &&
+                    p.data[0] == cmd &&
+                    memcmp(&p.data[1], params, params_len) == 0) {
+                    got = true;
+                }
+            }
+        }
+
+        CHECK(got, "frame not recovered after %u garbage bytes", garbage);
+        if (repeats > worst_repeats) worst_repeats = repeats;
+    }
+
+    printf("parser/resync:    %u frames, worst case %u repeats to resync\n", iterations, worst_repeats);
+}
+
+// ====== Driver ======
+
+static void fuzz_driver(uint32_t rounds) {
+    static pn532_emu_t emu;
+    static pn532_uart_t dev;
+
+    const uint32_t timeout_ms = 200;
+    const uint64_t bound_us = (PN532_ACK_TIMEOUT_MS + timeout_ms + 2) * 1000ull;
+
+    uint32_t done = 0, no_tag = 0, errors = 0;
+
+    for (uint32_t round = 0; round < rounds; round++) {
+        pn532_emu_config_t config = pn532_emu_default_config();
+        config.seed = rand32();
+        config.ack_delay_us = rand32() % 2000;
+        config.response_delay_us = rand32() % 50000;
+        config.noise_rate = randf() * 0.5f;
+        config.noise_max_len = rand32() % 64;
+        config.corrupt_rate = randf() * 0.3f;
+        config.drop_ack_rate = randf() * 0.2f;
+
+        host_reset();
+        pn532_emu_init(&emu, &config);
+        host_attach(uart0, &emu);
+        pn532_uart_init(&dev, uart0, 0, 1, 115200);
+
+        // 0, 1 or 2 cards, 4 or 7 byte UIDs
+        pn532_emu_tag_t tags[PN532_MAX_TARGETS];
+        uint8_t tag_count = rand32() % (PN532_MAX_TARGETS + 1);
+        for (uint8_t t = 0; t < tag_count; t++) {
+            uint8_t uid[10];
+            uint8_t uid_len = (rand32() & 1) ? 4 : 7;
+            for (uint8_t i = 0; i < uid_len; i++) uid[i] = (uint8_t)rand32();
+            tags[t] = pn532_emu_make_tag(uid, uid_len);
+        }
+        pn532_emu_set_tags(&emu, tags, tag_count, time_us_64());
+
+        for (int cmd = 0; cmd < 8; cmd++) {
+            uint8_t max_targets = 1 + rand32() % PN532_MAX_TARGETS;
+            uint64_t start = time_us_64();
+            CHECK(pn532_uart_start_passive_target(&dev, max_targets, timeout_ms, NULL, NULL),
+                  "submit refused while idle");
+
+            pn532_status_t status;
+            while ((status = pn532_uart_poll(&dev)) == PN532_WAIT_ACK ||
+                   status == PN532_WAIT_RESPONSE) {
+                host_advance_us(1000);
+            }
+
+            uint64_t elapsed = time_us_64() - start;
+            CHECK(elapsed <= bound_us, "command took %llu us", (unsigned long long)elapsed);
+
+            pn532_target_t got[PN532_MAX_TARGETS];
+            uint8_t got_count = 0;
+            if (status == PN532_DONE &&
+                (got_count = pn532_uart_get_passive_targets(&dev, got, PN532_MAX_TARGETS)) > 0) {
+                done++;
+                uint8_t expect = tag_count < max_targets ? tag_count : max_targets;
+                CHECK(got_count == expect, "%d targets listed, expected %d", got_count, expect);
+                for (uint8_t t = 0; t < got_count && t < tag_count; t++) {
+                    CHECK(got[t].uid_len == tags[t].uid_len &&
+                          memcmp(got[t].uid, tags[t].uid, tags[t].uid_len) == 0,
+                          "wrong UID for target %d", t);
+                }
+            } else if (status == PN532_TIMEOUT) {
+                no_tag++;
+            } else {
+                errors++;
+            }
+        }
+    }
+
+    printf("driver:           %u rounds, %u UIDs, %u timeouts, %u errors\n",
+           rounds, done, no_tag, errors);
+}
+
+int main(int argc, char **argv) {
+    uint32_t iterations = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 20000;
+    rng = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : 0x532;
+    if (rng == 0) rng = 1;
+
+    fuzz_parser_random(iterations);
+    fuzz_parser_resync(iterations);
+    fuzz_driver(iterations / 100 + 1);
+
+    printf("%s (%d failures)\n", failures ? "FAILED" : "OK", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,37 @@
+#ifndef HOST_PICO_STDLIB_H
+#define HOST_PICO_STDLIB_H
+
+// Host stand-in for the pico-sdk calls used by lib/rfid.
+// Time is virtual, see host_sdk.hh.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
+
+enum gpio_function {
+    GPIO_FUNC_UART = 2,
+};
+
+void gpio_set_function(uint gpio, enum gpio_function fn);
+
+void sleep_ms(uint32_t ms);
+void busy_wait_ms(uint32_t ms);
+
+uint64_t time_us_64(void);
+uint32_t time_us_32(void);
+absolute_time_t get_absolute_time(void);
+absolute_time_t make_timeout_time_ms(uint32_t ms);
+bool time_reached(absolute_time_t t);
+uint32_t to_ms_since_boot(absolute_time_t t);
+
+// Advances virtual time a little so spin loops make progress
+void tight_loop_contents(void);
+
+static inline void __compiler_memory_barrier(void) {
+    __asm__ volatile ("" : : : "memory");
+}
+
+#endif // HOST_PICO_STDLIB_H
@@ -0,0 +1,200 @@
+#include "host_sdk.hh"
+#include <string.h>
+#include "hardware/irq.h"
+
+#define HOST_RX_FIFO_DEPTH 32
+#define HOST_IRQ_COUNT 64
+
+struct uart_inst {
+    uint baud_rate;
+    bool rx_irq;
+    uint64_t tx_free_us;    // when the TX line is idle again
+    uint8_t fifo[HOST_RX_FIFO_DEPTH];
+    uint8_t fifo_head;
+    uint8_t fifo_count;
+    uint32_t overruns;
+    pn532_emu_t *emu;
+};
+
+static struct uart_inst uarts[2];
+uart_inst_t *uart0 = &uarts[0];
+uart_inst_t *uart1 = &uarts[1];
+
+static uint64_t now_us;
+static irq_handler_t irq_handlers[HOST_IRQ_COUNT];
+static bool irq_enabled[HOST_IRQ_COUNT];
+
+// ====== Virtual time ======
+
+static void raise_rx_irq(uart_inst_t *uart) {
+    uint irq = (uart_get_index(uart) == 0) ? UART0_IRQ : UART1_IRQ;
+    if (uart->rx_irq && irq_enabled[irq] && irq_handlers[irq]) {
+        irq_handlers[irq]();
+    }
+}
+
+static void deliver(uart_inst_t *uart, uint8_t c) {
+    if (uart->fifo_count == HOST_RX_FIFO_DEPTH) {
+        uart->overruns++;
+        return;
+    }
+    uint8_t slot = (uart->fifo_head + uart->fifo_count) % HOST_RX_FIFO_DEPTH;
+    uart->fifo[slot] = c;
+    uart->fifo_count++;
+}
+
+void host_advance_us(uint64_t us) {
+    uint64_t target = now_us + us;
+
+    for (;;) {
+        // Earliest byte due on any attached UART
+        uart_inst_t *next_uart = NULL;
+        uint64_t next_due = UINT64_MAX;
+        for (int i = 0; i < 2; i++) {
+            if (!uarts[i].emu) continue;
+            uint64_t due = pn532_emu_next_due(uarts[i].emu);
+            if (due < next_due) {
+                next_due = due;
+                next_uart = &uarts[i];
+            }
+        }
+
+        if (!next_uart || next_due > target) break;
+
+        now_us = (next_due > now_us) ? next_due : now_us;
+        uint8_t c;
+        while (pn532_emu_pop(next_uart->emu, now_us, &c)) {
+            deliver(next_uart, c);
+        }
+        raise_rx_irq(next_uart);
+    }
+
+    now_us = target;
+}
+
+void host_attach(uart_inst_t *uart, pn532_emu_t *emu) {
+    uart->emu = emu;
+}
+
+void host_reset(void) {
+    now_us = 0;
+    memset(irq_handlers, 0, sizeof(irq_handlers));
+    memset(irq_enabled, 0, sizeof(irq_enabled));
+    for (int i = 0; i < 2; i++) {
+        uarts[i].rx_irq = false;
+        uarts[i].tx_free_us = 0;
+        uarts[i].fifo_head = 0;
+        uarts[i].fifo_count = 0;
+        uarts[i].overruns = 0;
+        uarts[i].emu = NULL;
+    }
+}
+
+uint32_t host_fifo_overruns(uart_inst_t *uart) {
+    return uart->overruns;
+}
+
+// ====== pico/stdlib.h ======
+
+void gpio_set_function(uint gpio, enum gpio_function fn) {
+    (void)gpio;
+    (void)fn;
+}
+
+void sleep_ms(uint32_t ms) {
+    host_advance_us((uint64_t)ms * 1000);
+}
+
+void busy_wait_ms(uint32_t ms) {
+    host_advance_us((uint64_t)ms * 1000);
+}
+
+uint64_t time_us_64(void) {
+    return now_us;
+}
+
+uint32_t time_us_32(void) {
+    return (uint32_t)now_us;
+}
+
+absolute_time_t get_absolute_time(void) {
+    return now_us;
+}
+
+absolute_time_t make_timeout_time_ms(uint32_t ms) {
+    return now_us + (uint64_t)ms * 1000;
+}
+
+bool time_reached(absolute_time_t t) {
+    return now_us >= t;
+}
+
+uint32_t to_ms_since_boot(absolute_time_t t) {
+    return (uint32_t)(t / 1000);
+}
+
+void tight_loop_contents(void) {
+    host_advance_us(10);
+}
+
+// ====== hardware/uart.h ======
+
+uint uart_init(uart_inst_t *uart, uint baudrate) {
+    uart->baud_rate = baudrate;
+    return baudrate;
+}
+
+void uart_set_format(uart_inst_t *uart, uint data_bits, uint stop_bits, uart_parity_t parity) {
+    (void)uart;
+    (void)data_bits;
+    (void)stop_bits;
+    (void)parity;
+}
+
+void uart_set_fifo_enabled(uart_inst_t *uart, bool enabled) {
+    (void)uart;
+    (void)enabled;
+}
+
+void uart_set_irq_enables(uart_inst_t *uart, bool rx_has_data, bool tx_needs_data) {
+    (void)tx_needs_data;
+    uart->rx_irq = rx_has_data;
+}
+
+uint uart_get_index(uart_inst_t *uart) {
+    return (uint)(uart - uarts);
+}
+
+bool uart_is_readable(uart_inst_t *uart) {
+    return uart->fifo_count > 0;
+}
+
+char uart_getc(uart_inst_t *uart) {
+    if (uart->fifo_count == 0) return 0;
+    uint8_t c = uart->fifo[uart->fifo_head];
+    uart->fifo_head = (uart->fifo_head + 1) % HOST_RX_FIFO_DEPTH;
+    uart->fifo_count--;
+    return (char)c;
+}
+
+void uart_write_blocking(uart_inst_t *uart, const uint8_t *src, size_t len) {
+    // Bytes reach the PN532 one wire-time apart, the call itself returns at once
+    uint32_t byte_us = 10000000u / (uart->baud_rate ? uart->baud_rate : 115200);
+    uint64_t t = (uart->tx_free_us > now_us) ? uart->tx_free_us : now_us;
+
+    for (size_t i = 0; i < len; i++) {
+        t += byte_us;
+        if (uart->emu) pn532_emu_receive(uart->emu, src[i], t);
+    }
+    uart->tx_free_us = t;
+}
+
+// ====== hardware/irq.h ======
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler) {
+    if (num < HOST_IRQ_COUNT) irq_handlers[num] = handler;
+}
+
+void irq_set_enabled(uint num, bool enabled) {
+    if (num < HOST_IRQ_COUNT) irq_enabled[num] = enabled;
+}
@@ -0,0 +1,38 @@
+#ifndef HOST_SDK_HH
+#define HOST_SDK_HH
+
+#include <stdint.h>
+#include "hardware/uart.h"
+#include "pn532_emu.hh"
+
+/*  NOTES:
+
+    Host implementation of the SDK calls in host/. Time is virtual:
+    it only moves when the driver sleeps/spins or the harness calls
+    host_advance_us(). Bytes from the emulator land in a 32-byte RX
+    FIFO at their wire time and the registered UART IRQ is called,
+    the same way the RP2350 would.
+
+*/
+
+/**
+ * Connect an emulator to the other end of a UART
+ */
+void host_attach(uart_inst_t *uart, pn532_emu_t *emu);
+
+/**
+ * Move virtual time forward, delivering bytes and IRQs on the way
+ */
+void host_advance_us(uint64_t us);
+
+/**
+ * Reset virtual time, FIFOs and IRQ registrations
+ */
+void host_reset(void);
+
+/**
+ * Bytes lost because the RX FIFO was full when they arrived
+ */
+uint32_t host_fifo_overruns(uart_inst_t *uart);
+
+#endif // HOST_SDK_HH
@@ -0,0 +1,277 @@
+// Card loadout reads/writes and the UID cache, against emulated tags.
+// Runs on Linux against pn532_emu, see README.md for the build line.
+//
+//   ./loadout_test
+//
+// Exits non-zero if any check fails.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_sdk.hh"
+#include "pn532_emu.hh"
+#include "pn532_uart.hh"
+#include "loadout.hh"
+
+static pn532_emu_t emu;
+static pn532_uart_t dev;
+static int failures = 0;
+
+#define CHECK(cond, ...) do {                 \
+        if (!(cond)) {                        \
+            failures++;                       \
+            printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+            printf(__VA_ARGS__);              \
+            printf("\n");                     \
+        }                                     \
+    } while (0)
+
+static const uint8_t NTAG_UID[7] = {0x04, 0x76, 0x5E, 0x22, 0x91, 0x6C, 0x80};
+static const uint8_t CLASSIC_UID[4] = {0xDE, 0xC7, 0x1A, 0x33};
+
+// NTAG213 (45 pages) and MIFARE Classic 1K
+static uint8_t ntag_memory[45 * 4];
+static uint8_t classic_memory[1024];
+
+static void setup(void) {
+    pn532_emu_config_t config = pn532_emu_default_config();
+    host_reset();
+    pn532_emu_init(&emu, &config);
+    host_attach(uart0, &emu);
+    pn532_uart_init(&dev, uart0, 0, 1, 115200);
+    loadout_cache_clear();
+
+    memset(ntag_memory, 0, sizeof(ntag_memory));
+    memset(classic_memory, 0, sizeof(classic_memory));
+}
+
+static pn532_emu_tag_t ntag(void) {
+    pn532_emu_tag_t tag = pn532_emu_make_tag(NTAG_UID, sizeof(NTAG_UID));
+    tag.memory = ntag_memory;
+    tag.memory_size = sizeof(ntag_memory);
+    return tag;
+}
+
+static pn532_emu_tag_t classic(void) {
+    pn532_emu_tag_t tag = pn532_emu_make_tag(CLASSIC_UID, sizeof(CLASSIC_UID));
+    tag.memory = classic_memory;
+    tag.memory_size = sizeof(classic_memory);
+    return tag;
+}
+
+static void place(pn532_emu_tag_t tag) {
+    pn532_emu_set_tags(&emu, &tag, 1, time_us_64());
+}
+
+static void remove_all(void) {
+    pn532_emu_set_tags(&emu, NULL, 0, time_us_64());
+}
+
+static loadout_t make_loadout(uint8_t tower, uint8_t level, const char *name) {
+    loadout_t l;
+    memset(&l, 0, sizeof(l));
+    l.tower = tower;
+    l.level = level;
+    strncpy(l.name, name, LOADOUT_NAME_MAX);
+    return l;
+}
+
+static bool same(const loadout_t *a, const loadout_t *b) {
+    return a->tower == b->tower && a->level == b->level && strcmp(a->name, b->name) == 0;
+}
+
+static bool scan(pn532_target_t *target) {
+    if (!pn532_uart_start_passive_target(&dev, 1, 200, NULL, NULL)) return false;
+    if (pn532_uart_wait(&dev) != PN532_DONE) return false;
+    return pn532_uart_get_passive_targets(&dev, target, 1) == 1;
+}
+
+static loadout_status_t run(loadout_xfer_t *xfer) {
+    loadout_status_t status;
+    while ((status = loadout_poll(xfer)) == LOADOUT_BUSY) {
+        host_advance_us(1000);
+    }
+    return status;
+}
+
+// What the game does when a card arrives: cache first, page read on a miss.
+// Returns the number of InDataExchanges the tap cost.
+static uint32_t tap(bool *has_loadout, loadout_t *loadout) {
+    uint32_t before = emu.stats.data_exchanges;
+    *has_loadout = false;
+
+    pn532_target_t target;
+    if (!scan(&target)) return 0;
+    if (loadout_cache_lookup(target.uid, target.uid_len, has_loadout, loadout)) return 0;
+
+    loadout_xfer_t xfer;
+    if (!loadout_start_read(&xfer, &dev, &target) || run(&xfer) != LOADOUT_DONE) {
+        return emu.stats.data_exchanges - before;
+    }
+
+    *has_loadout = xfer.has_loadout;
+    *loadout = xfer.loadout;
+    return emu.stats.data_exchanges - before;
+}
+
+static bool write(const loadout_t *loadout) {
+    pn532_target_t target;
+    loadout_xfer_t xfer;
+    return scan(&target) && loadout_start_write(&xfer, &dev, &target, loadout) &&
+           run(&xfer) == LOADOUT_DONE;
+}
+
+// ====== Tests ======
+
+static void test_format(void) {
+    loadout_t in = make_loadout(2, 3, "ANDREW");
+    loadout_t out;
+    uint8_t raw[LOADOUT_SIZE];
+
+    loadout_encode(&in, raw);
+    CHECK(loadout_decode(raw, &out) && same(&in, &out), "round trip");
+
+    for (int i = 0; i < LOADOUT_SIZE; i++) {
+        raw[i] ^= 0x10;
+        CHECK(!loadout_decode(raw, &out), "flipped byte %d accepted", i);
+        raw[i] ^= 0x10;
+    }
+
+    // Ten characters fill the field without a terminator on the card
+    in = make_loadout(1, 0, "ABCDEFGHIJ");
+    loadout_encode(&in, raw);
+    CHECK(loadout_decode(raw, &out) && strcmp(out.name, "ABCDEFGHIJ") == 0, "full-length name");
+}
+
+static void test_read_once(pn532_emu_tag_t tag, uint8_t *memory, uint16_t offset, const char *kind) {
+    setup();
+    loadout_t stored = make_loadout(1, 2, "P1");
+    loadout_encode(&stored, memory + offset);
+    place(tag);
+
+    bool has;
+    loadout_t got;
+    uint32_t cost = tap(&has, &got);
+    CHECK(has && same(&got, &stored), "%s: first tap did not return the card loadout", kind);
+    CHECK(cost > 0, "%s: first tap did not read the card", kind);
+
+    cost = tap(&has, &got);
+    CHECK(has && same(&got, &stored), "%s: repeat tap wrong loadout", kind);
+    CHECK(cost == 0, "%s: repeat tap cost %u card exchanges, expected cache hit", kind, cost);
+}
+
+static void test_blank_card(void) {
+    setup();
+    place(ntag());
+
+    bool has = true;
+    loadout_t got;
+    uint32_t cost = tap(&has, &got);
+    CHECK(!has && cost == 1, "blank card: has %d cost %u", has, cost);
+
+    // "No loadout" is cached too
+    cost = tap(&has, &got);
+    CHECK(!has && cost == 0, "blank card repeat: has %d cost %u", has, cost);
+}
+
+static void test_write_updates_cache(pn532_emu_tag_t tag, uint8_t *memory, uint16_t offset, const char *kind) {
+    setup();
+    loadout_t old_loadout = make_loadout(0, 0, "OLD");
+    loadout_t new_loadout = make_loadout(3, 4, "NEW");
+    loadout_encode(&old_loadout, memory + offset);
+    place(tag);
+
+    bool has;
+    loadout_t got;
+    tap(&has, &got);
+    CHECK(has && same(&got, &old_loadout), "%s: initial read", kind);
+
+    CHECK(write(&new_loadout), "%s: write failed", kind);
+
+    loadout_t on_card;
+    CHECK(loadout_decode(memory + offset, &on_card) && same(&on_card, &new_loadout),
+          "%s: card memory does not hold the new loadout", kind);
+
+    // Cache serves the new loadout, not the one read before the write
+    uint32_t cost = tap(&has, &got);
+    CHECK(has && same(&got, &new_loadout), "%s: stale loadout after write", kind);
+    CHECK(cost == 0, "%s: tap after write cost %u exchanges", kind, cost);
+}
+
+static void test_failed_write_invalidates(void) {
+    setup();
+    loadout_t old_loadout = make_loadout(0, 0, "OLD");
+    loadout_t new_loadout = make_loadout(3, 4, "NEW");
+    loadout_encode(&old_loadout, ntag_memory + 16);
+    place(ntag());
+
+    bool has;
+    loadout_t got;
+    tap(&has, &got);
+
+    // Card pulled after the first of four page writes
+    pn532_target_t target;
+    loadout_xfer_t xfer;
+    CHECK(scan(&target) && loadout_start_write(&xfer, &dev, &target, &new_loadout), "start write");
+    while (loadout_poll(&xfer) == LOADOUT_BUSY && emu.stats.card_writes == 0) {
+        host_advance_us(1000);
+    }
+    remove_all();
+    CHECK(run(&xfer) == LOADOUT_FAILED, "torn write reported success");
+
+    bool cached_has;
+    CHECK(!loadout_cache_lookup(NTAG_UID, sizeof(NTAG_UID), &cached_has, &got),
+          "card still cached after a failed write");
+
+    // Next tap reads the card again and sees the torn loadout as invalid
+    place(ntag());
+    uint32_t cost = tap(&has, &got);
+    CHECK(cost == 1, "tap after failed write cost %u exchanges, expected a re-read", cost);
+    CHECK(!has, "torn loadout accepted");
+}
+
+static void test_eviction(void) {
+    setup();
+    uint8_t memory[LOADOUT_CACHE_SIZE + 1][45 * 4];
+    pn532_emu_tag_t tags[LOADOUT_CACHE_SIZE + 1];
+
+    for (int i = 0; i <= LOADOUT_CACHE_SIZE; i++) {
+        uint8_t uid[7] = {0x04, 0x10, 0x20, 0x30, 0x40, 0x50, (uint8_t)i};
+        tags[i] = pn532_emu_make_tag(uid, sizeof(uid));
+        tags[i].memory = memory[i];
+        tags[i].memory_size = sizeof(memory[i]);
+        loadout_t l = make_loadout(i % 4, i, "EVICT");
+        loadout_encode(&l, memory[i] + 16);
+    }
+
+    bool has;
+    loadout_t got;
+    uint32_t reads = 0;
+    for (int i = 0; i <= LOADOUT_CACHE_SIZE; i++) {
+        place(tags[i]);
+        reads += tap(&has, &got);
+        CHECK(has && got.level == i, "card %d wrong loadout", i);
+    }
+    CHECK(reads == LOADOUT_CACHE_SIZE + 1, "%u reads for %d new cards", reads, LOADOUT_CACHE_SIZE + 1);
+
+    // Least recently used card was evicted, the newest is still cached
+    place(tags[0]);
+    CHECK(tap(&has, &got) == 1 && got.level == 0, "evicted card not re-read");
+    place(tags[LOADOUT_CACHE_SIZE]);
+    CHECK(tap(&has, &got) == 0, "newest card was evicted");
+}
+
+int main() {
+    test_format();
+    test_read_once(ntag(), ntag_memory, 16, "ntag");
+    test_read_once(classic(), classic_memory, 4 * 16, "classic");
+    test_blank_card();
+    test_write_updates_cache(ntag(), ntag_memory, 16, "ntag");
+    test_write_updates_cache(classic(), classic_memory, 4 * 16, "classic");
+    test_failed_write_invalidates();
+    test_eviction();
+
+    printf("%s (%d failures)\n", failures ? "FAILED" : "OK", failures);
+    return failures ? 1 : 0;
+}
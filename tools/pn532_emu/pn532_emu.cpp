@@ -0,0 +1,323 @@
+#include "pn532_emu.hh"
+#include <string.h>
+
+// Syntax error frame the PN532 sends for commands it does not know
+static const uint8_t PN532_ERROR_FRAME[8] = {0x00, 0x00, 0xFF, 0x01, 0xFF, 0x7F, 0x81, 0x00};
+
+// ====== Helpers ======
+
+static uint32_t next_rand(pn532_emu_t *emu) {
+    // xorshift32, deterministic per seed
+    uint32_t x = emu->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    emu->rng = x;
+    return x;
+}
+
+static bool chance(pn532_emu_t *emu, float rate) {
+    if (rate <= 0.0f) return false;
+    return (next_rand(emu) & 0xFFFFFF) < (uint32_t)(rate * 16777216.0f);
+}
+
+static uint32_t byte_time_us(const pn532_emu_t *emu) {
+    // 8N1 = 10 bits per byte
+    return 10000000u / emu->config.baud_rate;
+}
+
+static void queue_byte(pn532_emu_t *emu, uint64_t at_us, uint8_t c) {
+    uint32_t next = (emu->tx_head + 1) % PN532_EMU_TX_QUEUE;
+    if (next == emu->tx_tail) return;  // line saturated, drop
+
+    uint64_t start = (at_us > emu->tx_last_us) ? at_us : emu->tx_last_us;
+    emu->tx_last_us = start + byte_time_us(emu);
+
+    emu->tx_time[emu->tx_head] = emu->tx_last_us;
+    emu->tx_byte[emu->tx_head] = c;
+    emu->tx_head = next;
+}
+
+static void queue_noise(pn532_emu_t *emu, uint64_t at_us, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        queue_byte(emu, at_us, (uint8_t)next_rand(emu));
+    }
+    emu->stats.noise_bytes += n;
+}
+
+// Queue a frame with the configured noise and corruption applied
+static void queue_frame(pn532_emu_t *emu, uint64_t at_us, const uint8_t *frame, size_t len) {
+    if (emu->config.noise_max_len > 0 && chance(emu, emu->config.noise_rate)) {
+        queue_noise(emu, at_us, 1 + next_rand(emu) % emu->config.noise_max_len);
+    }
+
+    size_t flip = len;
+    uint8_t mask = 0;
+    if (chance(emu, emu->config.corrupt_rate)) {
+        flip = next_rand(emu) % len;
+        mask = (uint8_t)(1u << (next_rand(emu) % 8));
+        emu->stats.corrupted++;
+    }
+
+    for (size_t i = 0; i < len; i++) {
+        queue_byte(emu, at_us, (i == flip) ? (uint8_t)(frame[i] ^ mask) : frame[i]);
+    }
+}
+
+static void queue_response(pn532_emu_t *emu, uint64_t at_us, uint8_t cmd,
+                           const uint8_t *params, uint8_t params_len) {
+    uint8_t frame[PN532_FRAME_MAX_SIZE];
+    size_t len = pn532_frame_build(frame, PN532_PN532_TO_HOST, cmd + 1, params, params_len);
+    queue_frame(emu, at_us, frame, len);
+}
+
+static void answer_passive_target(pn532_emu_t *emu, uint64_t at_us) {
+    uint8_t payload[PN532_FRAME_MAX_DATA];
+    uint8_t count = emu->tag_count < emu->max_targets ? emu->tag_count : emu->max_targets;
+    uint8_t idx = 0;
+
+    payload[idx++] = count;
+    for (uint8_t i = 0; i < count; i++) {
+        const pn532_emu_tag_t *tag = &emu->tags[i];
+        payload[idx++] = i + 1;  // Tg
+        payload[idx++] = tag->sens_res[0];
+        payload[idx++] = tag->sens_res[1];
+        payload[idx++] = tag->sel_res;
+        payload[idx++] = tag->uid_len;
+        memcpy(&payload[idx], tag->uid, tag->uid_len);
+        idx += tag->uid_len;
+    }
+
+    emu->waiting_for_tag = false;
+    emu->listed = count;
+    emu->auth_sector = -1;
+    queue_response(emu, at_us, PN532_CMD_INLISTPASSIVETARGET, payload, idx);
+}
+
+// InDataExchange status codes
+#define EMU_STATUS_OK       0x00
+#define EMU_STATUS_TIMEOUT  0x01  // target did not answer
+#define EMU_STATUS_AUTH     0x14  // MIFARE authentication error
+#define EMU_STATUS_BAD_TG   0x27  // not a valid target / command
+
+// Runs one card command and returns the InDataExchange payload length
+static uint8_t card_exchange(pn532_emu_t *emu, const uint8_t *params, uint8_t params_len,
+                             uint8_t *out) {
+    out[0] = EMU_STATUS_BAD_TG;
+    if (params_len < 2) return 1;
+
+    uint8_t tg = params[0];
+    const uint8_t *cmd = &params[1];
+    uint8_t len = params_len - 1;
+
+    if (tg < 1 || tg > emu->listed) return 1;
+
+    // Card taken off the reader since it was listed
+    out[0] = EMU_STATUS_TIMEOUT;
+    if (tg > emu->tag_count) return 1;
+
+    pn532_emu_tag_t *tag = &emu->tags[tg - 1];
+    if (!tag->memory) return 1;
+
+    if (tag->sel_res & 0x08) {
+        // MIFARE Classic, 16-byte blocks, 4 blocks per sector
+        uint16_t blocks = tag->memory_size / 16;
+        if (len < 2 || cmd[1] >= blocks) return 1;
+        uint8_t block = cmd[1];
+
+        switch (cmd[0]) {
+            case 0x60: {
+                static const uint8_t key[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+                if (len < 12 || memcmp(&cmd[2], key, 6) != 0 ||
+                    memcmp(&cmd[8], &tag->uid[tag->uid_len - 4], 4) != 0) {
+                    emu->auth_sector = -1;
+                    out[0] = EMU_STATUS_AUTH;
+                    return 1;
+                }
+                emu->auth_sector = block / 4;
+                out[0] = EMU_STATUS_OK;
+                return 1;
+            }
+            case 0x30:
+                if (emu->auth_sector != block / 4) return 1;
+                out[0] = EMU_STATUS_OK;
+                memcpy(&out[1], &tag->memory[block * 16], 16);
+                return 17;
+            case 0xA0:
+                if (emu->auth_sector != block / 4 || len < 18) return 1;
+                memcpy(&tag->memory[block * 16], &cmd[2], 16);
+                emu->stats.card_writes++;
+                out[0] = EMU_STATUS_OK;
+                return 1;
+            default:
+                return 1;
+        }
+    }
+
+    // NTAG / Ultralight, 4-byte pages
+    uint16_t pages = tag->memory_size / 4;
+    if (len < 2 || cmd[1] >= pages) return 1;
+    uint8_t page = cmd[1];
+
+    switch (cmd[0]) {
+        case 0x30:
+            // READ returns four pages, rolling over at the end of memory
+            out[0] = EMU_STATUS_OK;
+            for (uint8_t i = 0; i < 16; i++) {
+                out[1 + i] = tag->memory[(page * 4 + i) % (pages * 4)];
+            }
+            return 17;
+        case 0xA2:
+            if (len < 6) return 1;
+            memcpy(&tag->memory[page * 4], &cmd[2], 4);
+            emu->stats.card_writes++;
+            out[0] = EMU_STATUS_OK;
+            return 1;
+        default:
+            return 1;
+    }
+}
+
+static void handle_command(pn532_emu_t *emu, const pn532_parser_t *p, uint64_t now_us) {
+    emu->stats.commands++;
+
+    uint64_t ack_at = now_us + emu->config.ack_delay_us;
+    if (chance(emu, emu->config.drop_ack_rate)) {
+        emu->stats.dropped_acks++;
+    } else {
+        queue_frame(emu, ack_at, PN532_ACK_FRAME, sizeof(PN532_ACK_FRAME));
+    }
+
+    uint64_t rsp_at = ack_at + emu->config.response_delay_us;
+    uint8_t cmd = p->data[0];
+    const uint8_t *params = &p->data[1];
+    uint8_t params_len = p->data_len - 1;
+
+    switch (cmd) {
+        case PN532_CMD_GETFIRMWAREVERSION: {
+            // PN532 v1.6, supports ISO14443A/B and ISO18092
+            const uint8_t version[4] = {0x32, 0x01, 0x06, 0x07};
+            queue_response(emu, rsp_at, cmd, version, sizeof(version));
+            break;
+        }
+
+        case PN532_CMD_SAMCONFIGURATION:
+            queue_response(emu, rsp_at, cmd, NULL, 0);
+            break;
+
+        case PN532_CMD_INLISTPASSIVETARGET:
+            emu->max_targets = (params_len > 0 && params[0] > 0) ? params[0] : 1;
+            if (emu->max_targets > 2) emu->max_targets = 2;  // PN532 limit
+            if (emu->tag_count > 0) {
+                answer_passive_target(emu, rsp_at);
+            } else {
+                emu->waiting_for_tag = true;
+            }
+            break;
+
+        case PN532_CMD_INDATAEXCHANGE: {
+            uint8_t payload[1 + 16];
+            emu->stats.data_exchanges++;
+            uint8_t len = card_exchange(emu, params, params_len, payload);
+            queue_response(emu, rsp_at, cmd, payload, len);
+            break;
+        }
+
+        default:
+            queue_frame(emu, rsp_at, PN532_ERROR_FRAME, sizeof(PN532_ERROR_FRAME));
+            break;
+    }
+}
+
+// ====== Public API ======
+
+pn532_emu_config_t pn532_emu_default_config(void) {
+    pn532_emu_config_t config;
+    config.baud_rate = 115200;
+    config.ack_delay_us = 500;
+    config.response_delay_us = 4000;
+    config.noise_rate = 0.0f;
+    config.noise_max_len = 0;
+    config.corrupt_rate = 0.0f;
+    config.drop_ack_rate = 0.0f;
+    config.seed = 0x532;
+    return config;
+}
+
+void pn532_emu_init(pn532_emu_t *emu, const pn532_emu_config_t *config) {
+    memset(emu, 0, sizeof(*emu));
+    emu->config = *config;
+    emu->rng = config->seed ? config->seed : 1;
+    emu->max_targets = 1;
+    emu->auth_sector = -1;
+    pn532_parser_reset(&emu->parser);
+}
+
+void pn532_emu_set_tags(pn532_emu_t *emu, const pn532_emu_tag_t *tags, uint8_t count, uint64_t now_us) {
+    if (count > PN532_EMU_MAX_TAGS) count = PN532_EMU_MAX_TAGS;
+    memcpy(emu->tags, tags, count * sizeof(pn532_emu_tag_t));
+    emu->tag_count = count;
+
+    if (emu->waiting_for_tag && count > 0) {
+        answer_passive_target(emu, now_us + emu->config.response_delay_us);
+    }
+}
+
+void pn532_emu_receive(pn532_emu_t *emu, uint8_t c, uint64_t now_us) {
+    switch (pn532_parser_feed(&emu->parser, c)) {
+        case PN532_FRAME_ACK:
+            // Host ACK aborts the command in progress
+            if (emu->waiting_for_tag) {
+                emu->waiting_for_tag = false;
+                emu->stats.aborts++;
+            }
+            break;
+
+        case PN532_FRAME_DATA:
+            if (emu->parser.tfi != PN532_HOST_TO_PN532 || emu->parser.data_len < 1) {
+                emu->stats.bad_frames++;
+                break;
+            }
+            handle_command(emu, &emu->parser, now_us);
+            break;
+
+        case PN532_FRAME_NACK:
+        case PN532_FRAME_ERROR:
+            emu->stats.bad_frames++;
+            break;
+
+        case PN532_FRAME_PENDING:
+            break;
+    }
+}
+
+void pn532_emu_inject_noise(pn532_emu_t *emu, uint32_t n, uint64_t now_us) {
+    queue_noise(emu, now_us, n);
+}
+
+bool pn532_emu_pop(pn532_emu_t *emu, uint64_t now_us, uint8_t *c) {
+    if (emu->tx_tail == emu->tx_head) return false;
+    if (emu->tx_time[emu->tx_tail] > now_us) return false;
+
+    *c = emu->tx_byte[emu->tx_tail];
+    emu->tx_tail = (emu->tx_tail + 1) % PN532_EMU_TX_QUEUE;
+    return true;
+}
+
+uint64_t pn532_emu_next_due(const pn532_emu_t *emu) {
+    if (emu->tx_tail == emu->tx_head) return UINT64_MAX;
+    return emu->tx_time[emu->tx_tail];
+}
+
+pn532_emu_tag_t pn532_emu_make_tag(const uint8_t *uid, uint8_t uid_len) {
+    pn532_emu_tag_t tag;
+    memset(&tag, 0, sizeof(tag));
+    if (uid_len > sizeof(tag.uid)) uid_len = sizeof(tag.uid);
+    memcpy(tag.uid, uid, uid_len);
+    tag.uid_len = uid_len;
+    // ATQA / SAK of a MIFARE Classic 1K (4-byte UID) or Ultralight (7-byte)
+    tag.sens_res[0] = 0x00;
+    tag.sens_res[1] = (uid_len == 4) ? 0x04 : 0x44;
+    tag.sel_res = (uid_len == 4) ? 0x08 : 0x00;
+    return tag;
+}
@@ -0,0 +1,120 @@
+#ifndef PN532_EMU_HH
+#define PN532_EMU_HH
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "pn532_frame.hh"
+
+#define PN532_EMU_MAX_TAGS 4
+#define PN532_EMU_TX_QUEUE 2048
+
+typedef struct {
+    uint8_t uid[10];
+    uint8_t uid_len;
+    uint8_t sens_res[2];
+    uint8_t sel_res;
+
+    // Card memory, owned by the caller so writes outlive the tap.
+    // NTAG (SAK 0x00): 4-byte pages. MIFARE Classic (SAK 0x08): 16-byte
+    // blocks behind key A FF..FF. NULL = card without data pages.
+    uint8_t *memory;
+    uint16_t memory_size;
+} pn532_emu_tag_t;
+
+typedef struct {
+    uint32_t baud_rate;          // sets byte time on the wire
+    uint32_t ack_delay_us;       // command frame received -> ACK
+    uint32_t response_delay_us;  // ACK -> response frame
+    float noise_rate;            // chance of a garbage burst before each frame
+    uint8_t noise_max_len;       // longest garbage burst
+    float corrupt_rate;          // chance of flipping one byte of a frame
+    float drop_ack_rate;         // chance of never sending the ACK
+    uint32_t seed;
+} pn532_emu_config_t;
+
+typedef struct {
+    uint32_t commands;
+    uint32_t bad_frames;
+    uint32_t aborts;
+    uint32_t noise_bytes;
+    uint32_t corrupted;
+    uint32_t dropped_acks;
+    uint32_t data_exchanges;
+    uint32_t card_writes;
+} pn532_emu_stats_t;
+
+typedef struct {
+    pn532_emu_config_t config;
+    pn532_emu_stats_t stats;
+    uint32_t rng;
+
+    pn532_emu_tag_t tags[PN532_EMU_MAX_TAGS];
+    uint8_t tag_count;
+
+    // Host -> PN532 direction
+    pn532_parser_t parser;
+
+    // InListPassiveTarget parked until a tag shows up or the host aborts
+    bool waiting_for_tag;
+    uint8_t max_targets;
+
+    // Targets activated by the last InListPassiveTarget, MIFARE auth state
+    uint8_t listed;
+    int16_t auth_sector;
+
+    // PN532 -> host bytes, each with the time it finishes on the wire
+    uint64_t tx_time[PN532_EMU_TX_QUEUE];
+    uint8_t tx_byte[PN532_EMU_TX_QUEUE];
+    uint32_t tx_head;
+    uint32_t tx_tail;
+    uint64_t tx_last_us;
+} pn532_emu_t;
+
+/**
+ * Default config: 115200 baud, no faults
+ */
+pn532_emu_config_t pn532_emu_default_config(void);
+
+/**
+ * Reset emulator state and apply config
+ */
+void pn532_emu_init(pn532_emu_t *emu, const pn532_emu_config_t *config);
+
+/**
+ * Replace the set of tags in the field
+ * A parked InListPassiveTarget answers as soon as a tag appears
+ *
+ * @param now_us Current virtual time
+ */
+void pn532_emu_set_tags(pn532_emu_t *emu, const pn532_emu_tag_t *tags, uint8_t count, uint64_t now_us);
+
+/**
+ * Feed one byte written by the host
+ *
+ * @param now_us Time the byte finished arriving
+ */
+void pn532_emu_receive(pn532_emu_t *emu, uint8_t c, uint64_t now_us);
+
+/**
+ * Queue n random bytes on the PN532 -> host line
+ */
+void pn532_emu_inject_noise(pn532_emu_t *emu, uint32_t n, uint64_t now_us);
+
+/**
+ * @return true if a byte is due at or before now_us, stored in *c
+ */
+bool pn532_emu_pop(pn532_emu_t *emu, uint64_t now_us, uint8_t *c);
+
+/**
+ * @return time the next queued byte is due, UINT64_MAX if none
+ */
+uint64_t pn532_emu_next_due(const pn532_emu_t *emu);
+
+/**
+ * Helper for tests: MIFARE Classic 1K (4-byte UID) or NTAG (7-byte UID)
+ * style tag, without memory
+ */
+pn532_emu_tag_t pn532_emu_make_tag(const uint8_t *uid, uint8_t uid_len);
+
+#endif // PN532_EMU_HH
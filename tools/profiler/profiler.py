@@ -0,0 +1,282 @@
+"""
+Profiles the board with the firmware's sampling profiler (lib/profiler)
+Samples are symbolized against the firmware ELF the board is running
+
+Usage:
+    python3 profiler.py .pio/build/proton/firmware.elf /dev/ttyACM0 [--rate 1000] [--seconds 10]
+                        [--folded out.folded] [--record profile.bin]
+    python3 profiler.py .pio/build/proton/firmware.elf --replay profile.bin
+
+Prints a flat profile per core. --folded writes stacks in the folded
+format flamegraph.pl, inferno and speedscope read:
+
+    core1;render_frame;set_pixel 412
+
+The packet format is in lib/usb/usb_packet.hh, the sample layout in
+lib/profiler/profiler.hh, keep them in sync.
+"""
+
+import argparse
+import bisect
+import os
+import shutil
+import struct
+import subprocess
+import sys
+import time
+from collections import Counter
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+import usb_packet
+from usb_packet import PACKET_PROFILE
+
+PROFILE_HEADER = struct.Struct("<BBI")  # core, count, dropped since boot
+SAMPLE = struct.Struct("<II")           # pc, lr
+
+SHT_SYMTAB = 2
+STT_FUNC = 2
+EM_ARM = 40
+
+# Below this is the bootrom, anything from here up is an EXC_RETURN value
+BOOTROM_END = 0x00008000
+EXC_RETURN = 0xF0000000
+
+
+def demangle(names):
+    """C++ names through c++filt when there is one, else as they are"""
+    tool = shutil.which("arm-none-eabi-c++filt") or shutil.which("c++filt")
+    if not tool or not names:
+        return names
+    result = subprocess.run([tool], input="\n".join(names), capture_output=True, text=True)
+    lines = result.stdout.splitlines()
+    return lines if len(lines) == len(names) else names
+
+
+class Symbols:
+    """Function symbols of an ELF, looked up by address"""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            data = f.read()
+        if data[:4] != b"\x7fELF":
+            sys.exit(f"{path} is not an ELF file")
+
+        wide = data[4] == 2
+        endian = "<" if data[5] == 1 else ">"
+        machine, = struct.unpack_from(endian + "H", data, 0x12)
+        if wide:
+            shoff, = struct.unpack_from(endian + "Q", data, 0x28)
+            shentsize, shnum = struct.unpack_from(endian + "HH", data, 0x3A)
+            section = struct.Struct(endian + "IIQQQQIIQQ")
+            symbol = struct.Struct(endian + "IBBHQQ")
+        else:
+            shoff, = struct.unpack_from(endian + "I", data, 0x20)
+            shentsize, shnum = struct.unpack_from(endian + "HH", data, 0x2E)
+            section = struct.Struct(endian + "IIIIIIIIII")
+            symbol = struct.Struct(endian + "IIIBBH")
+
+        sections = [section.unpack_from(data, shoff + i * shentsize) for i in range(shnum)]
+        functions = {}
+        for _, kind, _, _, offset, size, link, *_ in sections:
+            if kind != SHT_SYMTAB:
+                continue
+            strings = sections[link][4]
+            for at in range(offset, offset + size, symbol.size):
+                if wide:
+                    name, info, _, _, value, length = symbol.unpack_from(data, at)
+                else:
+                    name, value, length, info, _, _ = symbol.unpack_from(data, at)
+                if info & 0xF != STT_FUNC or value == 0:
+                    continue
+                # Thumb functions have bit 0 set
+                if machine == EM_ARM:
+                    value &= ~1
+                end = data.find(b"\0", strings + name)
+                label = data[strings + name:end].decode("utf-8", "replace")
+                # Keep the sized one when an address has aliases
+                if value not in functions or functions[value][1] < length:
+                    functions[value] = (label, length)
+        if not functions:
+            sys.exit(f"{path} has no function symbols, was it stripped?")
+
+        self.starts = sorted(functions)
+        self.sizes = [functions[start][1] for start in self.starts]
+        self.names = demangle([functions[start][0] for start in self.starts])
+
+    def lookup(self, address):
+        """Name of the function holding address, None if there is none"""
+        i = bisect.bisect_right(self.starts, address) - 1
+        if i < 0:
+            return None
+        size = self.sizes[i]
+        # Unsized (assembly) symbols run up to the next one
+        if size and address >= self.starts[i] + size:
+            return None
+        return self.names[i]
+
+    def name(self, address):
+        """Like lookup, but always gives something to print"""
+        found = self.lookup(address)
+        if found:
+            return found
+        if address < BOOTROM_END:
+            return "[bootrom]"
+        return f"0x{address:08x}"
+
+
+class ProfileDecoder:
+    """Pulls profile packets out of the port's bytes"""
+
+    def __init__(self):
+        self.reader = usb_packet.PacketReader()
+        self.samples = []               # (core, pc, lr)
+        self.dropped = {}               # core -> count since boot, latest
+        self.first_dropped = {}
+        self.last_seq = None
+        self.lost_packets = 0
+
+    @property
+    def bad_packets(self):
+        return self.reader.bad_packets
+
+    def feed(self, data):
+        """Returns the text lines this data completes, packets are kept"""
+        lines = []
+        for item in self.reader.feed(data):
+            if isinstance(item, str):
+                lines.append(item)
+            elif item is not usb_packet.CORRUPT and item.kind == PACKET_PROFILE:
+                self.packet(item.seq, item.payload)
+        return lines
+
+    def packet(self, seq, payload):
+        if self.last_seq is not None and seq != (self.last_seq + 1) & 0xFFFF:
+            self.lost_packets += (seq - self.last_seq - 1) & 0xFFFF
+        self.last_seq = seq
+
+        core, count, dropped = PROFILE_HEADER.unpack_from(payload)
+        self.first_dropped.setdefault(core, dropped)
+        self.dropped[core] = dropped
+        for i in range(count):
+            pc, lr = SAMPLE.unpack_from(payload, PROFILE_HEADER.size + i * SAMPLE.size)
+            self.samples.append((core, pc, lr))
+
+    def dropped_during(self, core):
+        return self.dropped.get(core, 0) - self.first_dropped.get(core, 0)
+
+
+def caller(symbols, lr):
+    """The function LR returns into, None if it doesn't point at code"""
+    if lr >= EXC_RETURN or lr < BOOTROM_END:
+        return None
+    # LR is the instruction after the call, step back into the call itself
+    return symbols.lookup((lr & ~1) - 1)
+
+
+def report(symbols, decoder, top, folded_path):
+    cores = sorted({core for core, _, _ in decoder.samples})
+    if not cores:
+        print("No samples. Is the build new enough to have lib/profiler?")
+        return
+
+    folded = Counter()
+    for core in cores:
+        own = Counter()
+        inclusive = Counter()
+        total = 0
+        for sample_core, pc, lr in decoder.samples:
+            if sample_core != core:
+                continue
+            total += 1
+            function = symbols.name(pc)
+            parent = caller(symbols, lr)
+            own[function] += 1
+            inclusive[function] += 1
+            if parent and parent != function:
+                inclusive[parent] += 1
+                folded[f"core{core};{parent};{function}"] += 1
+            else:
+                folded[f"core{core};{function}"] += 1
+
+        print(f"core{core}: {total} samples, {decoder.dropped_during(core)} dropped on the board")
+        print(f"  {'self':>6}  {'+callee':>7}  {'samples':>7}  function")
+        # Callers only seen through LR get a line too, with no self time
+        ranked = sorted(inclusive, key=lambda function: (own[function], inclusive[function]),
+                        reverse=True)
+        for function in ranked[:top]:
+            count = own[function]
+            print(f"  {100 * count / total:5.1f}%  {100 * inclusive[function] / total:6.1f}%"
+                  f"  {count:7}  {function}")
+        print()
+
+    if decoder.lost_packets or decoder.bad_packets:
+        print(f"{decoder.lost_packets} packets lost, {decoder.bad_packets} corrupt")
+
+    if folded_path:
+        with open(folded_path, "w") as f:
+            for stack, count in sorted(folded.items()):
+                f.write(f"{stack} {count}\n")
+        print(f"Folded stacks in {folded_path}")
+
+
+def capture(port_name, rate, seconds, decoder, record):
+    import serial
+    port = serial.Serial(port_name, timeout=0.05)
+
+    def read_for(duration):
+        end = time.monotonic() + duration
+        while time.monotonic() < end:
+            data = port.read(port.in_waiting or 1)
+            if record:
+                record.write(data)
+            for line in decoder.feed(data):
+                if line.startswith(("ok profile", "err profile")):
+                    print(line)
+
+    try:
+        port.write(f"profile on {rate}\n".encode())
+        try:
+            read_for(seconds)
+        except KeyboardInterrupt:
+            pass
+        port.write(b"profile off\n")
+        # Let the rings empty
+        read_for(0.5)
+    finally:
+        port.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Sample the board and symbolize the profile")
+    parser.add_argument("elf", help="firmware ELF the board runs")
+    parser.add_argument("port", nargs="?", help="serial port, e.g. /dev/ttyACM0 or COM5")
+    parser.add_argument("--rate", type=int, default=1000, help="samples per second per core")
+    parser.add_argument("--seconds", type=float, default=10, help="how long to sample")
+    parser.add_argument("--top", type=int, default=25, help="functions per core in the flat profile")
+    parser.add_argument("--folded", help="write folded stacks here for a flame graph")
+    parser.add_argument("--record", help="also save the raw bytes here")
+    parser.add_argument("--replay", help="report on a saved capture instead of a port")
+    args = parser.parse_args()
+
+    symbols = Symbols(args.elf)
+    decoder = ProfileDecoder()
+
+    if args.replay:
+        with open(args.replay, "rb") as f:
+            decoder.feed(f.read())
+    elif args.port:
+        record = open(args.record, "wb") if args.record else None
+        try:
+            capture(args.port, args.rate, args.seconds, decoder, record)
+        finally:
+            if record:
+                record.close()
+    else:
+        parser.error("give a serial port or --replay")
+
+    report(symbols, decoder, args.top, args.folded)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
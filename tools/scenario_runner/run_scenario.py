@@ -0,0 +1,240 @@
+"""
+Scenario runner for hardware-in-the-loop soak and perf runs
+Replays a scenario file into the board over USB serial (lib/usb/usb_input)
+and collects the per-frame timing it exports (lib/trace/frame_timing)
+
+Usage:
+    python3 run_scenario.py /dev/ttyACM0 scenarios/soak.txt \
+        [--rate 4] [--loops 100] [--csv frames.csv] [--summary run.json] \
+        [--compare baseline.json] [--elf .pio/build/proton/firmware.elf]
+
+A scenario is one command per line, after the time it is sent at:
+
+    # ms   command
+    0      stick x right
+    250    stick x center
+    1000   tag arrive 04a1b2c3 ninja
+
+Times are milliseconds from the start of the loop. --rate divides them,
+so --rate 4 plays the scenario four times faster. Commands go to the
+board as written, it answers each with "ok" or "err".
+
+The summary holds the firmware build (from "info") and, per timing
+column, mean/p50/p99/max. --compare prints the change against an
+earlier summary, for comparing firmware builds on the same scenario.
+
+The board's LOG records (lib/log) arrive as packets too. With --elf
+they are expanded and printed like its printf text, without it they
+are skipped.
+"""
+
+import argparse
+import csv
+import json
+import os
+import struct
+import sys
+import time
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+import usb_packet
+from usb_packet import PACKET_LOG, PACKET_LOG_DROPPED, PACKET_TIMING
+
+# A timing packet's fields, see lib/trace/frame_timing.hh
+COLUMNS = ["n", "input_us", "draw_us", "push_us", "total_us", "dropped"]
+TIMING_ROW = struct.Struct("<" + "I" * len(COLUMNS))
+
+# After the last command, keep collecting frames this long
+SETTLE_S = 1.0
+
+
+def load_scenario(path):
+    steps = []
+    with open(path) as f:
+        for number, line in enumerate(f, 1):
+            line = line.split("#", 1)[0].strip()
+            if not line:
+                continue
+            time_ms, _, command = line.partition(" ")
+            try:
+                steps.append((float(time_ms) / 1000.0, command.strip()))
+            except ValueError:
+                sys.exit(f"{path}:{number}: expected '<ms> <command>'")
+    steps.sort(key=lambda step: step[0])
+    return steps
+
+
+class Board:
+    """Reads replies and timing packets from the port, keeps what the run needs"""
+
+    def __init__(self, port, elf=None):
+        import serial
+        self.port = serial.Serial(port, timeout=0)
+        self.reader = usb_packet.PacketReader()
+        self.log = None
+        if elf:
+            sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                            "..", "log_expand"))
+            import log_expand
+            self.log = log_expand.LogDecoder(log_expand.Elf(elf))
+        self.columns = COLUMNS
+        self.frames = []
+        self.build = None
+        self.replies = {"ok": 0, "err": 0}
+        self.errors = []
+
+    def send(self, command):
+        self.port.write(command.encode("ascii") + b"\n")
+
+    def read(self):
+        for item in self.reader.feed(self.port.read(self.port.in_waiting or 1)):
+            if isinstance(item, str):
+                self.line(item.strip())
+            elif item is not usb_packet.CORRUPT:
+                self.packet(item)
+
+    def packet(self, packet):
+        if packet.kind == PACKET_TIMING and len(packet.payload) == TIMING_ROW.size:
+            self.frames.append(list(TIMING_ROW.unpack(packet.payload)))
+        elif packet.kind in (PACKET_LOG, PACKET_LOG_DROPPED) and self.log:
+            text = self.log.packet(packet.kind, packet.seq, packet.payload)
+            for line in text.split("\n"):
+                print(f"board: {line}")
+
+    def line(self, line):
+        words = line.split()
+        if not words:
+            return
+        if words[0] == "info" and len(words) > 2 and words[1] == "build":
+            self.build = " ".join(words[2:])
+        elif words[0] in self.replies:
+            self.replies[words[0]] += 1
+            if words[0] == "err":
+                self.errors.append(line)
+        else:
+            print(f"board: {line}")
+
+    def wait(self, seconds):
+        end = time.monotonic() + seconds
+        while time.monotonic() < end:
+            self.read()
+            time.sleep(0.001)
+
+
+def percentile(values, fraction):
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(fraction * len(ordered)))]
+
+
+def summarize(board, args, sent, elapsed):
+    stats = {}
+    for i, name in enumerate(board.columns):
+        if name == "n":
+            continue
+        values = [frame[i] for frame in board.frames]
+        if not values:
+            continue
+        stats[name] = {
+            "mean": sum(values) / len(values),
+            "p50": percentile(values, 0.50),
+            "p99": percentile(values, 0.99),
+            "max": max(values),
+        }
+
+    return {
+        "build": board.build,
+        "scenario": args.scenario,
+        "rate": args.rate,
+        "loops": args.loops,
+        "commands": sent,
+        "ok": board.replies["ok"],
+        "err": board.replies["err"],
+        "frames": len(board.frames),
+        "seconds": round(elapsed, 3),
+        "columns": stats,
+    }
+
+
+def print_summary(summary, baseline=None):
+    print(f"build {summary['build']}, {summary['frames']} frames in {summary['seconds']} s, "
+          f"{summary['commands']} commands ({summary['ok']} ok, {summary['err']} err)")
+    for name, stats in summary["columns"].items():
+        line = f"  {name:10} " + " ".join(f"{key} {value:9.1f}" for key, value in stats.items())
+        old = (baseline or {}).get("columns", {}).get(name)
+        if old:
+            changes = []
+            for key in ("mean", "p99"):
+                if old[key]:
+                    changes.append(f"{key} {100.0 * (stats[key] - old[key]) / old[key]:+.1f}%")
+            if changes:
+                line += "   vs baseline " + ", ".join(changes)
+        print(line)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Replay a scenario into the board")
+    parser.add_argument("port", help="serial port, e.g. /dev/ttyACM0 or COM5")
+    parser.add_argument("scenario", help="scenario file")
+    parser.add_argument("--rate", type=float, default=1.0, help="speed up the scenario")
+    parser.add_argument("--loops", type=int, default=1, help="play the scenario this many times")
+    parser.add_argument("--csv", help="write every frame's timing here")
+    parser.add_argument("--summary", help="write the summary as JSON here")
+    parser.add_argument("--compare", help="summary JSON of an earlier run")
+    parser.add_argument("--elf", help="firmware ELF the board runs, to print its LOG records")
+    args = parser.parse_args()
+
+    steps = load_scenario(args.scenario)
+    if not steps:
+        sys.exit(f"{args.scenario} has no commands")
+    length = steps[-1][0] / args.rate
+
+    board = Board(args.port, args.elf)
+    board.send("info")
+    board.send("timing on")
+    board.wait(0.5)
+
+    sent = 0
+    start = time.monotonic()
+    try:
+        for loop in range(args.loops):
+            loop_start = time.monotonic()
+            for at, command in steps:
+                while time.monotonic() < loop_start + at / args.rate:
+                    board.read()
+                    time.sleep(0.0005)
+                board.send(command)
+                sent += 1
+            # Short gap so one loop's last step and the next one's first don't collide
+            board.wait(max(0.0, loop_start + length + 0.25 / args.rate - time.monotonic()))
+        board.wait(SETTLE_S)
+    except KeyboardInterrupt:
+        print("stopped")
+    elapsed = time.monotonic() - start
+
+    board.send("timing off")
+    board.wait(0.2)
+
+    if args.csv:
+        with open(args.csv, "w", newline="") as f:
+            writer = csv.writer(f)
+            writer.writerow(board.columns)
+            writer.writerows(board.frames)
+
+    summary = summarize(board, args, sent, elapsed)
+    baseline = None
+    if args.compare:
+        with open(args.compare) as f:
+            baseline = json.load(f)
+    print_summary(summary, baseline)
+    for error in board.errors[:10]:
+        print(f"  {error}")
+
+    if args.summary:
+        with open(args.summary, "w") as f:
+            json.dump(summary, f, indent=2)
+
+    return 1 if board.errors or not board.frames else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,110 @@
+"""
+Host side of lib/usb/usb_packet: splits the board's serial bytes into
+printf text and packets, keep the two in sync
+
+The board's tools import it with tools/ on the path:
+
+    sys.path.insert(0, os.path.join(os.path.dirname(__file__), ".."))
+    import usb_packet
+
+PacketReader.feed() returns what the new bytes complete, in the order
+they arrived:
+
+    str         a line of printf text, without its newline
+    Packet      a packet whose checksum matched
+    CORRUPT     a packet whose checksum didn't, most likely text landed
+                inside it. Anything that depends on every packet (the
+                frame stream's deltas) should resync
+"""
+
+import collections
+import struct
+
+SYNC = b"\xA5\x5A"
+HEADER = struct.Struct("<2sBHH")       # sync, type, seq, payload length
+CHECKSUM_SIZE = 2
+PAYLOAD_MAX = 258
+
+# UsbPacketType
+PACKET_FRAME_START = 0x01              # frame_stream
+PACKET_ROW = 0x02
+PACKET_FRAME_END = 0x03
+PACKET_LOG = 0x10                      # log
+PACKET_LOG_DROPPED = 0x11
+PACKET_PROFILE = 0x20                  # profiler
+PACKET_TIMING = 0x30                   # frame_timing
+PACKET_DISPLAY_LIST = 0x40             # Cgam dl_capture
+
+Packet = collections.namedtuple("Packet", "kind seq payload")
+
+CORRUPT = object()
+
+
+def fletcher16(data):
+    sum1 = sum2 = 0
+    for byte in data:
+        sum1 = (sum1 + byte) % 255
+        sum2 = (sum2 + sum1) % 255
+    return sum1 | (sum2 << 8)
+
+
+class PacketReader:
+    """Finds packets in the byte stream, everything else is text"""
+
+    def __init__(self):
+        self.pending = bytearray()
+        self.text = bytearray()
+        self.packets = 0
+        self.bad_packets = 0
+
+    def feed(self, data):
+        self.pending += data
+        out = []
+
+        while True:
+            start = self.pending.find(SYNC)
+            if start < 0:
+                # Keep a trailing A5, it may be the start of a sync
+                keep = 1 if self.pending.endswith(SYNC[:1]) else 0
+                self.add_text(self.pending[:len(self.pending) - keep], out)
+                del self.pending[:len(self.pending) - keep]
+                break
+
+            self.add_text(self.pending[:start], out)
+            del self.pending[:start]
+            if len(self.pending) < HEADER.size:
+                break
+
+            _, kind, seq, length = HEADER.unpack_from(self.pending)
+            if length > PAYLOAD_MAX:
+                # Not a real header, the sync bytes were text
+                self.add_text(self.pending[:1], out)
+                del self.pending[:1]
+                continue
+
+            total = HEADER.size + length + CHECKSUM_SIZE
+            if len(self.pending) < total:
+                break
+
+            body = bytes(self.pending[2:HEADER.size + length])
+            checksum, = struct.unpack_from("<H", self.pending, HEADER.size + length)
+            if fletcher16(body) != checksum:
+                self.bad_packets += 1
+                out.append(CORRUPT)
+                del self.pending[:1]
+                continue
+
+            del self.pending[:total]
+            self.packets += 1
+            out.append(Packet(kind, seq, body[HEADER.size - 2:]))
+
+        return out
+
+    def add_text(self, data, out):
+        self.text += data
+        while b"\n" in self.text:
+            line, _, rest = bytes(self.text).partition(b"\n")
+            self.text = bytearray(rest)
+            # Bytes of a broken packet end up here too, drop what can't be text
+            text = line.decode("utf-8", "replace").rstrip("\r")
+            out.append("".join(c for c in text if c.isprintable()))